@@ -4,8 +4,17 @@
 #include <vector>
 #include <string>
 #include <cstring>
+#include <cstdio>
+#include <cstdlib>
 #include <filesystem>
 #include <algorithm>
+#include <chrono>
+#include <climits>
+#include <array>
+#include <utility>
+#include <iomanip>
+#include <sstream>
+#include <thread>
 
 // 🎵 AUDIO DECODING
 #include <mpg123.h>
@@ -14,6 +23,11 @@
 // 🚀 ZSTD COMPRESSION
 #include <zstd.h>
 
+// 📦 SIMD BIT UNPACKING (SSE2 is baseline on x86-64; scalar fallback elsewhere)
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace fs = std::filesystem;
 
 // 🎧 AUDIO DATA STRUCTURE
@@ -24,16 +38,236 @@ struct AudioData {
     std::vector<int32_t> interleaved_data; // INT32 SUPREMACY!! 32-bit signed integers fr fr
 };
 
-// 🔥 HMICAP HEADER STRUCTURE (32 bytes total - cache line optimized fr fr)
+// 🔥 HMICAP HEADER STRUCTURE (40 bytes on disk)
 struct HMICAPHeader {
     char magic[8];          // "HMICAP01"
     uint32_t sample_rate;   // Hz
     uint16_t channels;      // 1=mono, 2=stereo, etc
     uint16_t bit_depth;     // 32 for int32
     uint64_t total_samples; // Samples per channel
-    uint8_t reserved2[12];  // Future metadata
+    uint32_t flags;         // HMICAP_FLAG_* bits
+    uint32_t block_frames;  // Frames per coded block (LPC streams)
+    uint8_t reserved2[8];   // Future metadata
+};
+static_assert(sizeof(HMICAPHeader) == 40, "HMICAP header must stay 40 bytes");
+
+// 🧮 LPC LOSSLESS CODING (FLAC-style) ══════════════════════════════════════
+// Stream = header + blocks of LPC_BLOCK_FRAMES frames. Per block, per channel:
+//   u8 method, u8 order, u8 wasted_bits, u8 qlp_shift
+//   [LPC_METHOD_QLP: int32 coefficients[order]]
+//   int32 warmup[order], then Rice-coded zigzag residuals[frames - order]
+// The samples are shifted right by wasted_bits first (a 16-bit source has 16 zero low bits
+// once it's scaled to int32), then predicted. The stream sits in a zstd frame like any HMICAP7.
+// header.flags bits 0-15 belong to the hmicap tree (same HMICAP01 magic), so ours start at 16.
+const uint32_t HMICAP_FLAG_LPC = 1u << 16; // Payload is an LPC stream, not raw int32 samples
+const uint32_t LPC_BLOCK_FRAMES = 4096;
+const int LPC_MAX_ORDER = 32;
+const int LPC_PRECISION = 15;             // Bits per quantized coefficient (sign included)
+const int LPC_ZSTD_LEVEL = 3;             // Rice output is near-random; zstd only catches long repeats
+
+enum LpcMethod : uint8_t {
+    LPC_METHOD_FIXED = 0, // Fixed polynomial predictor, order 0-4 (order 0 = verbatim)
+    LPC_METHOD_QLP = 1    // Quantized LPC, coefficients stored
+};
+
+// Fixed predictors as integer coefficients (shift 0)
+const int32_t FIXED_COEFFICIENTS[5][4] = {
+    {0, 0, 0, 0}, {1, 0, 0, 0}, {2, -1, 0, 0}, {3, -3, 1, 0}, {4, -6, 4, -1}
+};
+
+inline uint32_t zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+inline int32_t unzigzag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+// 🎲 RICE RESIDUAL CODING ═══════════════════════════════════════════════════
+// Residuals are split into RICE_PARTITION_SIZE runs; each run starts with a 5-bit
+// parameter k, then every value is unary(v >> k) + 1, followed by the low k bits.
+// k == RICE_ESCAPE means the run is stored as raw 32-bit values (outliers).
+// Bits are packed LSB-first and every sub-block ends byte-aligned.
+const int64_t RICE_PARTITION_SIZE = 256;
+const uint32_t RICE_ESCAPE = 31;
+
+struct BitReader {
+    const uint8_t* data;
+    size_t size;
+    size_t pos = 0;
+    uint64_t bits = 0;
+    int count = 0;
+    bool failed = false;
+    
+    BitReader(const char* d, size_t s) : data(reinterpret_cast<const uint8_t*>(d)), size(s) {}
+    
+    void refill() {
+        while (count <= 56 && pos < size) {
+            bits |= (uint64_t)data[pos++] << count;
+            count += 8;
+        }
+    }
+    
+    uint32_t get(int n) {
+        if (n == 0) return 0;
+        if (count < n) refill();
+        if (count < n) { failed = true; return 0; }
+        uint32_t value = (uint32_t)(bits & ((1ull << n) - 1));
+        bits >>= n;
+        count -= n;
+        return value;
+    }
+    
+    uint32_t unary() {
+        uint64_t q = 0;
+        while (true) {
+            if (count == 0) refill();
+            if (count == 0 || q > UINT32_MAX) { failed = true; return 0; }
+            if (bits == 0) { q += count; bits = 0; count = 0; continue; }
+            int used = __builtin_ctzll(bits) + 1;
+            q += used - 1;
+            bits = used < 64 ? bits >> used : 0; // A stop bit at bit 63 would shift by 64
+            count -= used;
+            return (uint32_t)q;
+        }
+    }
+    
+    // Byte offset just past the last consumed bit (sub-blocks are byte-aligned)
+    size_t byte_offset() const { return pos - count / 8; }
 };
 
+bool rice_decode(BitReader& reader, uint32_t* out, int64_t count) {
+    for (int64_t start = 0; start < count; start += RICE_PARTITION_SIZE) {
+        int64_t end = std::min(count, start + RICE_PARTITION_SIZE);
+        uint32_t k = reader.get(5);
+        if (k == RICE_ESCAPE) {
+            for (int64_t i = start; i < end; i++) out[i] = reader.get(32);
+        } else {
+            for (int64_t i = start; i < end; i++) {
+                uint32_t q = reader.unary();
+                out[i] = (q << k) | reader.get(k);
+            }
+        }
+        if (reader.failed) return false;
+    }
+    return true;
+}
+
+// 📦 BIT-PACKED RESIDUAL CODING (frame-of-reference) ═══════════════════════
+// With HMICAP_FLAG_PACKED every residual run is stored in BITPACK_GROUP-value groups instead
+// of Rice partitions. Per group:
+//   u8 width, u32 reference (group minimum), then width * 16 bytes of (value - reference)
+// The packed words interleave four 32-bit lanes (value i sits in lane i % 4, slot i / 4), so
+// one SSE2 shift + mask yields four consecutive values. A short last group is padded with the
+// reference. Groups are byte-aligned and need no bit reader, so unpacking runs at memory speed.
+const uint32_t HMICAP_FLAG_PACKED = 1u << 17; // LPC residuals are bit-packed, not Rice-coded
+const int64_t BITPACK_GROUP = 128;
+const size_t BITPACK_GROUP_HEADER = 5;
+
+template <int WIDTH>
+void bitpack_unpack(const uint8_t* in, uint32_t reference, uint32_t* out) {
+    if constexpr (WIDTH == 0) {
+        std::fill(out, out + BITPACK_GROUP, reference);
+    } else {
+#if defined(__SSE2__)
+        const __m128i* words = reinterpret_cast<const __m128i*>(in);
+        const __m128i mask = _mm_set1_epi32(WIDTH == 32 ? -1 : (int)((1u << WIDTH) - 1));
+        const __m128i base = _mm_set1_epi32((int)reference);
+        __m128i current = _mm_loadu_si128(words);
+        int word = 0, used = 0;
+        for (int slot = 0; slot < 32; slot++) {
+            __m128i value = _mm_srli_epi32(current, used);
+            used += WIDTH;
+            if (used >= 32) {
+                used -= 32;
+                if (++word < WIDTH) {
+                    current = _mm_loadu_si128(words + word);
+                    // The value straddles two words: its top `used` bits start the next one
+                    if (used > 0) value = _mm_or_si128(value, _mm_slli_epi32(current, WIDTH - used));
+                }
+            }
+            value = _mm_add_epi32(_mm_and_si128(value, mask), base);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + slot * 4), value);
+        }
+#else
+        const uint64_t mask = (1ull << WIDTH) - 1;
+        for (int i = 0; i < BITPACK_GROUP; i++) {
+            int bit = (i >> 2) * WIDTH;
+            const uint8_t* lane = in + (i & 3) * 4;
+            uint32_t low, high = 0;
+            std::memcpy(&low, lane + (bit >> 5) * 16, 4);
+            if ((bit & 31) + WIDTH > 32) std::memcpy(&high, lane + ((bit >> 5) + 1) * 16, 4);
+            uint64_t pair = low | ((uint64_t)high << 32);
+            out[i] = (uint32_t)((pair >> (bit & 31)) & mask) + reference;
+        }
+#endif
+    }
+}
+
+using BitpackUnpacker = void (*)(const uint8_t*, uint32_t, uint32_t*);
+
+template <int... WIDTHS>
+constexpr std::array<BitpackUnpacker, sizeof...(WIDTHS)> make_unpackers(std::integer_sequence<int, WIDTHS...>) {
+    return {{&bitpack_unpack<WIDTHS>...}};
+}
+
+// One fully specialized unpacker per width (constant shifts, no per-value branching)
+constexpr auto BITPACK_UNPACKERS = make_unpackers(std::make_integer_sequence<int, 33>{});
+
+// Unpack `count` values; `out` must have room for `count` rounded up to BITPACK_GROUP
+bool bitpack_decode(const char* data, size_t size, size_t& pos, uint32_t* out, int64_t count) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    for (int64_t start = 0; start < count; start += BITPACK_GROUP) {
+        if (pos + BITPACK_GROUP_HEADER > size) return false;
+        uint8_t width = bytes[pos];
+        uint32_t reference;
+        std::memcpy(&reference, bytes + pos + 1, 4);
+        pos += BITPACK_GROUP_HEADER;
+        
+        size_t packed_bytes = (size_t)width * 16;
+        if (width > 32 || pos + packed_bytes > size) return false;
+        BITPACK_UNPACKERS[width](bytes + pos, reference, out + start);
+        pos += packed_bytes;
+    }
+    return true;
+}
+
+// 🎚️ STEREO DECORRELATION ══════════════════════════════════════════════════
+// With HMICAP_FLAG_STEREO (stereo LPC streams only) every block starts with a u8 StereoMode and
+// its two coded channels are (left, right), (left, side), (side, right) or (mid, side), where
+// side = L - R and mid = (L + R) >> 1 (the bit mid drops is side's low bit). The converter
+// picks the mode per block and never picks one whose side channel overflows int32.
+const uint32_t HMICAP_FLAG_STEREO = 1u << 18; // Each block starts with a StereoMode byte
+
+enum StereoMode : uint8_t {
+    STEREO_INDEPENDENT = 0,
+    STEREO_LEFT_SIDE = 1,
+    STEREO_SIDE_RIGHT = 2,
+    STEREO_MID_SIDE = 3
+};
+
+// ↩️ UNDO the stereo transform in place on n interleaved frames. Wrapping 32-bit math is exact
+// because the true left/right samples fit int32.
+void stereo_restore(int32_t* frames, int64_t n, uint8_t mode) {
+    uint32_t* y = reinterpret_cast<uint32_t*>(frames);
+    switch (mode) {
+        case STEREO_LEFT_SIDE:
+            for (int64_t i = 0; i < n; i++) y[i * 2 + 1] = y[i * 2] - y[i * 2 + 1];
+            return;
+        case STEREO_SIDE_RIGHT:
+            for (int64_t i = 0; i < n; i++) y[i * 2] += y[i * 2 + 1];
+            return;
+        case STEREO_MID_SIDE:
+            for (int64_t i = 0; i < n; i++) {
+                int32_t side = frames[i * 2 + 1];
+                uint32_t left = y[i * 2] + (uint32_t)(side >> 1) + (uint32_t)(side & 1);
+                y[i * 2] = left;
+                y[i * 2 + 1] = left - (uint32_t)side;
+            }
+            return;
+    }
+}
+
 // 🔥 FLOAT TO INT32 CONVERSION (MAXIMUM QUALITY NO CAP)
 inline int32_t float_to_int32(float sample) {
     // Clamp to [-1.0, 1.0] first
@@ -203,8 +437,99 @@ bool write_hmicap(const std::string& path, const AudioData& audio) {
     return true;
 }
 
+// 🗜️ COMPRESSION PROFILES ═════════════════════════════════════════════════
+// Named zstd setups for HMICAP7. Windows stop at 2^27 (128 MB, ~4 minutes of INT32 stereo):
+// that's zstd's default decoder limit, so the player reads them without extra parameters.
+// Long-distance matching finds repeats far back in that window (a chorus, a loop).
+// fast-decode/instant use zstd's negative levels: literals skip entropy coding, so the player's
+// decompression gets close to memcpy at the cost of size.
+struct CompressionProfile {
+    const char* name;
+    int level;
+    int window_log;     // 0 = the level's default window
+    bool long_distance; // ZSTD_c_enableLongDistanceMatching
+    bool workers;       // ZSTD_c_nbWorkers = one per core
+    const char* summary;
+};
+
+const CompressionProfile COMPRESSION_PROFILES[] = {
+    {"fast", 3, 0, false, true, "zstd 3 - drafts, seconds per track"},
+    {"balanced", 9, 25, true, true, "zstd 9 + 32 MB window + long-distance matching"},
+    {"max", 19, 0, false, false, "zstd 19, the classic HMICAP7 setting (default)"},
+    {"archive", 19, 27, true, true, "zstd 19 + 128 MB window + long-distance matching"},
+    {"ultra", 22, 27, true, true, "zstd 22 + 128 MB window + long-distance matching (slow)"},
+    {"fast-decode", -1, 0, false, false, "zstd -1 - level-1 size, ~3x faster to load than max"},
+    {"instant", -5, 0, false, false, "zstd -5 - literals stored raw, loads at memory speed"},
+};
+
+// 🗜️ What write_hmicap7 compresses with (a profile, optionally with a time budget)
+struct CompressionSettings {
+    const CompressionProfile* profile = &COMPRESSION_PROFILES[2];
+    double budget = 0.0; // >0 = adaptive level: seconds of compression allowed per minute of audio
+};
+
+const CompressionProfile* find_compression_profile(const std::string& name) {
+    for (const auto& profile : COMPRESSION_PROFILES) {
+        if (name == profile.name) return &profile;
+    }
+    return nullptr;
+}
+
+// 🗜️ Set level/window/LDM/workers on a freshly reset context
+void apply_compression(ZSTD_CCtx* cctx, const CompressionProfile& profile, int level, bool workers) {
+    ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, level);
+    if (profile.window_log > 0) ZSTD_CCtx_setParameter(cctx, ZSTD_c_windowLog, profile.window_log);
+    if (profile.long_distance) ZSTD_CCtx_setParameter(cctx, ZSTD_c_enableLongDistanceMatching, 1);
+    if (workers && profile.workers &&
+        ZSTD_isError(ZSTD_CCtx_setParameter(cctx, ZSTD_c_nbWorkers, std::max(1u, std::thread::hardware_concurrency())))) {
+        std::cerr << "  ⚠️  libzstd built without threads - compressing on one core\n";
+    }
+}
+
+// 🎯 ADAPTIVE LEVEL: time a trial compression of a BUDGET_TRIAL_SECONDS slice from the middle of
+// the payload at rising levels and keep the strongest whose projected cost fits `budget` seconds
+// per minute of audio. The trial runs on one thread, so workers only add headroom.
+// Level 1 is the floor even when nothing fits.
+const double BUDGET_TRIAL_SECONDS = 10.0; // Audio per trial slice
+const int BUDGET_LEVELS[] = {1, 3, 5, 7, 9, 12, 15, 17, 19, 22};
+
+int pick_budget_level(const CompressionSettings& compression, const std::vector<char>& payload,
+                      const AudioData& audio) {
+    size_t frame_bytes = audio.channels * sizeof(int32_t);
+    size_t frames = std::min<size_t>(audio.total_samples, (size_t)(BUDGET_TRIAL_SECONDS * audio.sample_rate));
+    if (frames == 0) return compression.profile->level;
+    size_t first = sizeof(HMICAPHeader) + (audio.total_samples - frames) / 2 * frame_bytes;
+    const char* sample = payload.data() + first;
+    size_t size = frames * frame_bytes;
+    double sample_seconds = (double)frames / audio.sample_rate;
+    
+    ZSTD_CCtx* cctx = ZSTD_createCCtx();
+    std::vector<char> out(ZSTD_compressBound(size));
+    int chosen = BUDGET_LEVELS[0];
+    
+    std::cout << "  🎯 Budget " << compression.budget << " s per audio minute, trial on " << sample_seconds << " s:";
+    for (int level : BUDGET_LEVELS) {
+        ZSTD_CCtx_reset(cctx, ZSTD_reset_session_and_parameters);
+        apply_compression(cctx, *compression.profile, level, false);
+        auto start = std::chrono::steady_clock::now();
+        size_t written = ZSTD_compress2(cctx, out.data(), out.size(), sample, size);
+        double per_minute = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() *
+                            60.0 / sample_seconds;
+        if (ZSTD_isError(written)) break;
+        
+        std::cout << " " << level << "→" << std::fixed << std::setprecision(1) << per_minute << "s"
+                  << std::defaultfloat << std::setprecision(6);
+        if (per_minute > compression.budget) break;
+        chosen = level;
+    }
+    std::cout << "\n";
+    
+    ZSTD_freeCCtx(cctx);
+    return chosen;
+}
+
 // 🌀 WRITE HMICAP7 FILE (ZSTD COMPRESSED - MAXIMUM COMPRESSION!!)
-bool write_hmicap7(const std::string& path, const AudioData& audio) {
+bool write_hmicap7(const std::string& path, const AudioData& audio, const CompressionSettings& compression) {
     std::cout << "\n🌀 Writing HMICAP7 file (compressed INT32)...\n";
     
     // Build uncompressed HMICAP data in memory
@@ -227,14 +552,24 @@ bool write_hmicap7(const std::string& path, const AudioData& audio) {
                 audio.interleaved_data.data(),
                 audio.interleaved_data.size() * sizeof(int32_t));
     
-    // Compress with Zstd level 19 (SHEEEESH)
+    // Compress with the profile's zstd setup (level 19 by default, SHEEEESH)
+    const CompressionProfile& profile = *compression.profile;
+    int level = compression.budget > 0.0 ? pick_budget_level(compression, uncompressed_data, audio) : profile.level;
     size_t compressed_bound = ZSTD_compressBound(uncompressed_data.size());
     std::vector<char> compressed_data(compressed_bound);
     
+    std::cout << "  🗜️  zstd " << level;
+    if (profile.window_log > 0) std::cout << ", " << (1u << profile.window_log) / 1024 / 1024 << " MB window";
+    if (profile.long_distance) std::cout << ", long-distance matching";
+    if (profile.workers) std::cout << ", multithreaded";
+    std::cout << "\n";
     std::cout << "  🔄 Compressing " << uncompressed_data.size() / 1024.0 / 1024.0 << " MB...\n";
     
-    size_t compressed_size = ZSTD_compress(compressed_data.data(), compressed_bound,
-                                           uncompressed_data.data(), uncompressed_data.size(), 19);
+    ZSTD_CCtx* cctx = ZSTD_createCCtx();
+    apply_compression(cctx, profile, level, true);
+    size_t compressed_size = ZSTD_compress2(cctx, compressed_data.data(), compressed_bound,
+                                            uncompressed_data.data(), uncompressed_data.size());
+    ZSTD_freeCCtx(cctx);
     
     if (ZSTD_isError(compressed_size)) {
         std::cerr << "❌ Compression failed: " << ZSTD_getErrorName(compressed_size) << "\n";
@@ -260,6 +595,764 @@ bool write_hmicap7(const std::string& path, const AudioData& audio) {
     return true;
 }
 
+// 📐 WELCH-WINDOWED AUTOCORRELATION + LEVINSON-DURBIN
+// Fills lpc[m] with the order-m predictor (x[i] ≈ Σ lpc[m][j] * x[i-1-j]) for m = 1..max_order
+void compute_lpc(const int32_t* x, int64_t n, int max_order, std::vector<std::vector<double>>& lpc) {
+    lpc.assign(max_order + 1, {});
+    
+    std::vector<double> windowed(n);
+    double half = (n - 1) / 2.0;
+    for (int64_t i = 0; i < n; i++) {
+        double t = (i - half) / (half + 1.0);
+        windowed[i] = x[i] * (1.0 - t * t);
+    }
+    
+    std::vector<double> autoc(max_order + 1, 0.0);
+    for (int lag = 0; lag <= max_order; lag++) {
+        double sum = 0.0;
+        for (int64_t i = lag; i < n; i++) sum += windowed[i] * windowed[i - lag];
+        autoc[lag] = sum;
+    }
+    if (autoc[0] <= 0.0) return; // Digital silence - fixed order 0 wins anyway
+    autoc[0] *= 1.0 + 1e-9;      // Tiny noise floor keeps the recursion stable
+    
+    std::vector<double> c(max_order, 0.0), previous(max_order, 0.0);
+    double error = autoc[0];
+    
+    for (int m = 1; m <= max_order; m++) {
+        double acc = autoc[m];
+        for (int j = 1; j < m; j++) acc -= c[j - 1] * autoc[m - j];
+        double k = acc / error;
+        
+        previous = c;
+        c[m - 1] = k;
+        for (int j = 1; j < m; j++) c[j - 1] = previous[j - 1] - k * previous[m - 1 - j];
+        
+        lpc[m].assign(c.begin(), c.begin() + m);
+        error *= 1.0 - k * k;
+        if (error <= 0.0) break;
+    }
+}
+
+// 🎚️ QUANTIZE LPC COEFFICIENTS to LPC_PRECISION-bit integers with a right shift
+bool quantize_lpc(const std::vector<double>& lpc, std::vector<int32_t>& quantized, int& shift) {
+    double cmax = 0.0;
+    for (double value : lpc) cmax = std::max(cmax, std::fabs(value));
+    if (cmax <= 0.0 || !std::isfinite(cmax)) return false;
+    
+    int log2cmax;
+    std::frexp(cmax, &log2cmax);
+    shift = std::min(LPC_PRECISION - 1 - log2cmax, 15);
+    if (shift < 0) return false;
+    
+    const int32_t qmax = (1 << (LPC_PRECISION - 1)) - 1;
+    quantized.resize(lpc.size());
+    double error = 0.0; // Carry the rounding error forward so the sum stays accurate
+    for (size_t i = 0; i < lpc.size(); i++) {
+        error += lpc[i] * (1 << shift);
+        long q = std::lround(error);
+        q = std::max<long>(-qmax, std::min<long>(qmax, q));
+        quantized[i] = (int32_t)q;
+        error -= q;
+    }
+    
+    return true;
+}
+
+// ➖ RESIDUALS for one predictor - false if any residual leaves int32 range
+bool compute_residuals(const int32_t* x, int64_t n, const int32_t* c, int order, int shift, uint32_t* out) {
+    for (int64_t i = order; i < n; i++) {
+        int64_t prediction = 0;
+        for (int j = 0; j < order; j++) {
+            prediction += (int64_t)c[j] * x[i - 1 - j];
+        }
+        int64_t residual = (int64_t)x[i] - (prediction >> shift);
+        if (residual < INT32_MIN || residual > INT32_MAX) return false;
+        out[i - order] = zigzag((int32_t)residual);
+    }
+    return true;
+}
+
+// 📏 Rice-style bit estimate for a run of zigzag residuals - good enough to rank predictors
+uint64_t residual_cost(const uint32_t* residuals, int64_t count) {
+    if (count <= 0) return 0;
+    uint64_t sum = 0;
+    for (int64_t i = 0; i < count; i++) sum += residuals[i];
+    
+    uint64_t mean = sum / count;
+    int k = 0;
+    while (k < 31 && (mean >> (k + 1)) != 0) k++;
+    
+    return (uint64_t)count * (k + 1) + (sum >> k);
+}
+
+struct LpcStats {
+    uint64_t fixed_subblocks = 0;
+    uint64_t lpc_subblocks = 0;
+    uint64_t order_sum = 0;
+    uint64_t wasted_sum = 0;
+    uint64_t stereo_blocks[4] = {0, 0, 0, 0}; // Indexed by StereoMode
+};
+
+void print_stereo_stats(const LpcStats& stats) {
+    const uint64_t* blocks = stats.stereo_blocks;
+    if (blocks[0] + blocks[1] + blocks[2] + blocks[3] == 0) return;
+    std::cout << "  🎚️  Stereo blocks: " << blocks[STEREO_INDEPENDENT] << " L/R, " << blocks[STEREO_LEFT_SIDE]
+              << " L/S, " << blocks[STEREO_SIDE_RIGHT] << " S/R, " << blocks[STEREO_MID_SIDE] << " M/S\n";
+}
+
+inline void append_bytes(std::vector<char>& out, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+struct BitWriter {
+    std::vector<char>& out;
+    uint64_t bits = 0;
+    int count = 0;
+    
+    explicit BitWriter(std::vector<char>& o) : out(o) {}
+    
+    void put(uint32_t value, int n) { // n <= 32
+        bits |= (uint64_t)value << count;
+        count += n;
+        while (count >= 8) {
+            out.push_back((char)(bits & 0xFF));
+            bits >>= 8;
+            count -= 8;
+        }
+    }
+    
+    void unary(uint32_t q) {
+        while (q >= 32) { put(0, 32); q -= 32; }
+        put(1u << q, q + 1);
+    }
+    
+    void flush() {
+        if (count > 0) out.push_back((char)(bits & 0xFF));
+        bits = 0;
+        count = 0;
+    }
+};
+
+// 🎲 RICE-CODE A RESIDUAL RUN with the cheapest parameter per partition
+void rice_encode(const uint32_t* residuals, int64_t count, std::vector<char>& out) {
+    BitWriter writer(out);
+    
+    for (int64_t start = 0; start < count; start += RICE_PARTITION_SIZE) {
+        int64_t end = std::min(count, start + RICE_PARTITION_SIZE);
+        int64_t size = end - start;
+        
+        uint64_t sum = 0;
+        for (int64_t i = start; i < end; i++) sum += residuals[i];
+        int guess = 0;
+        while (guess < 30 && ((sum / size) >> (guess + 1)) != 0) guess++;
+        
+        // Exact cost around the guess; escape wins when an outlier blows up the unary part
+        uint32_t best_k = RICE_ESCAPE;
+        uint64_t best_bits = (uint64_t)size * 32;
+        for (int k = std::max(0, guess - 1); k <= std::min(30, guess + 1); k++) {
+            uint64_t bits = (uint64_t)size * (k + 1);
+            for (int64_t i = start; i < end; i++) bits += residuals[i] >> k;
+            if (bits < best_bits) {
+                best_bits = bits;
+                best_k = k;
+            }
+        }
+        
+        writer.put(best_k, 5);
+        if (best_k == RICE_ESCAPE) {
+            for (int64_t i = start; i < end; i++) writer.put(residuals[i], 32);
+        } else {
+            uint32_t mask = (1u << best_k) - 1;
+            for (int64_t i = start; i < end; i++) {
+                writer.unary(residuals[i] >> best_k);
+                writer.put(residuals[i] & mask, best_k);
+            }
+        }
+    }
+    
+    writer.flush();
+}
+
+// 📦 BIT-PACK A RESIDUAL RUN: per group, subtract the minimum and keep just enough bits
+inline void bitpack_group_range(const uint32_t* values, int64_t size, uint32_t& reference, int& width) {
+    uint32_t low = values[0], high = values[0];
+    for (int64_t i = 1; i < size; i++) {
+        low = std::min(low, values[i]);
+        high = std::max(high, values[i]);
+    }
+    reference = low;
+    width = high == low ? 0 : 32 - __builtin_clz(high - low);
+}
+
+void bitpack_encode(const uint32_t* values, int64_t count, std::vector<char>& out) {
+    uint32_t words[BITPACK_GROUP]; // 4 lanes * up to 32 words
+    
+    for (int64_t start = 0; start < count; start += BITPACK_GROUP) {
+        int64_t size = std::min(count - start, BITPACK_GROUP);
+        uint32_t reference;
+        int width;
+        bitpack_group_range(values + start, size, reference, width);
+        
+        // Value i -> lane i % 4, bit offset (i / 4) * width within that lane; padding packs as 0
+        std::memset(words, 0, width * 16);
+        for (int64_t i = 0; i < size && width > 0; i++) {
+            uint32_t value = values[start + i] - reference;
+            int bit = (int)(i >> 2) * width;
+            int lane = (int)(i & 3), word = bit >> 5, offset = bit & 31;
+            words[word * 4 + lane] |= value << offset;
+            if (offset + width > 32) words[(word + 1) * 4 + lane] |= value >> (32 - offset);
+        }
+        
+        out.push_back((char)width);
+        append_bytes(out, &reference, sizeof(reference));
+        append_bytes(out, words, width * 16);
+    }
+}
+
+// 📏 Exact bit-packed size of a residual run in bits
+uint64_t bitpack_cost(const uint32_t* values, int64_t count) {
+    uint64_t bits = 0;
+    for (int64_t start = 0; start < count; start += BITPACK_GROUP) {
+        uint32_t reference;
+        int width;
+        bitpack_group_range(values + start, std::min(count - start, BITPACK_GROUP), reference, width);
+        bits += BITPACK_GROUP_HEADER * 8 + (uint64_t)width * BITPACK_GROUP;
+    }
+    return bits;
+}
+
+// 🎚️ STEREO CANDIDATES for one block: mid and side of the interleaved pair. False when side
+// leaves int32 range, in which case the block stays independent L/R.
+bool stereo_signals(const int32_t* frames, int64_t n, int32_t* mid, int32_t* side) {
+    for (int64_t i = 0; i < n; i++) {
+        int64_t left = frames[i * 2], right = frames[i * 2 + 1];
+        int64_t difference = left - right;
+        if (difference < INT32_MIN || difference > INT32_MAX) return false;
+        mid[i] = (int32_t)((left + right) >> 1);
+        side[i] = (int32_t)difference;
+    }
+    return true;
+}
+
+// 🧮 ONE CODED CHANNEL of a block (sub-block bytes plus what the stats want to know)
+struct LpcChannelCode {
+    std::vector<char> bytes;
+    uint8_t method = LPC_METHOD_FIXED;
+    int order = 0;
+    int wasted = 0;
+};
+
+struct LpcWorkspace {
+    std::vector<int32_t> x = std::vector<int32_t>(LPC_BLOCK_FRAMES);
+    std::vector<uint32_t> scratch = std::vector<uint32_t>(LPC_BLOCK_FRAMES);
+    std::vector<uint32_t> best_residuals = std::vector<uint32_t>(LPC_BLOCK_FRAMES);
+    std::vector<int32_t> quantized, best_coefficients;
+    std::vector<std::vector<double>> lpc;
+};
+
+// 🧮 ENCODE ONE CHANNEL of one block (n samples at `stride`) into code.bytes
+// `packed` bit-packs the residuals and sticks to the fixed predictors, so decoding is a SIMD
+// unpack plus a short unrolled restore instead of a serial Rice walk and long LPC filters.
+void lpc_encode_channel(const int32_t* src, int64_t stride, int64_t n, bool packed,
+                        LpcWorkspace& work, LpcChannelCode& code) {
+    const int lpc_orders[] = {1, 2, 4, 8, 12, 16, 24, 32};
+    std::vector<int32_t>& x = work.x;
+    
+    // Wasted bits: low bits that are zero in every sample of this sub-block
+    uint32_t all_bits = 0;
+    for (int64_t i = 0; i < n; i++) all_bits |= (uint32_t)src[i * stride];
+    int wasted = 0;
+    if (all_bits != 0) {
+        while (!(all_bits & (1u << wasted))) wasted++;
+    }
+    for (int64_t i = 0; i < n; i++) x[i] = src[i * stride] >> wasted;
+    
+    uint8_t best_method = LPC_METHOD_FIXED;
+    int best_order = 0, best_shift = 0;
+    uint64_t best_cost = UINT64_MAX;
+    
+    auto consider = [&](uint8_t method, int order, int shift, const int32_t* c) {
+        if (order >= n) return;
+        if (!compute_residuals(x.data(), n, c, order, shift, work.scratch.data())) return;
+        uint64_t side_bits = (uint64_t)order * 32 * (method == LPC_METHOD_QLP ? 2 : 1);
+        uint64_t cost = (packed ? bitpack_cost(work.scratch.data(), n - order)
+                                : residual_cost(work.scratch.data(), n - order)) + side_bits;
+        if (cost < best_cost) {
+            best_cost = cost;
+            best_method = method;
+            best_order = order;
+            best_shift = shift;
+            work.best_coefficients.assign(c, c + order);
+            std::swap(work.scratch, work.best_residuals);
+        }
+    };
+    
+    // Fixed polynomial predictors (order 0 always fits, so there's always a winner)
+    for (int order = 0; order <= 4; order++) {
+        consider(LPC_METHOD_FIXED, order, 0, FIXED_COEFFICIENTS[order]);
+    }
+    
+    // Quantized LPC at a handful of orders
+    if (!packed && n > LPC_MAX_ORDER) {
+        compute_lpc(x.data(), n, LPC_MAX_ORDER, work.lpc);
+        for (int order : lpc_orders) {
+            int shift;
+            if (work.lpc[order].empty() || !quantize_lpc(work.lpc[order], work.quantized, shift)) continue;
+            consider(LPC_METHOD_QLP, order, shift, work.quantized.data());
+        }
+    }
+    
+    std::vector<char>& out = code.bytes;
+    out.clear();
+    uint8_t info[4] = {best_method, (uint8_t)best_order, (uint8_t)wasted,
+                       (uint8_t)(best_method == LPC_METHOD_QLP ? best_shift : 0)};
+    append_bytes(out, info, sizeof(info));
+    if (best_method == LPC_METHOD_QLP) {
+        append_bytes(out, work.best_coefficients.data(), best_order * sizeof(int32_t));
+    }
+    append_bytes(out, x.data(), best_order * sizeof(int32_t));
+    if (packed) bitpack_encode(work.best_residuals.data(), n - best_order, out);
+    else rice_encode(work.best_residuals.data(), n - best_order, out);
+    
+    code.method = best_method;
+    code.order = best_order;
+    code.wasted = wasted;
+}
+
+// 🧮 ENCODE AUDIO AS AN LPC STREAM (appended after whatever is already in `out`)
+// `stereo` (2 channels only) codes left, right, mid and side, keeps the smallest pair and
+// writes its StereoMode byte ahead of the block.
+void lpc_encode(const AudioData& audio, std::vector<char>& out, LpcStats& stats, bool packed, bool stereo) {
+    const int channels = audio.channels;
+    // Candidate pair per StereoMode, as indices into {left, right, mid, side}
+    const int stereo_pairs[4][2] = {{0, 1}, {0, 3}, {3, 1}, {2, 3}};
+    
+    LpcWorkspace work;
+    LpcChannelCode codes[4];
+    std::vector<int32_t> mid(LPC_BLOCK_FRAMES), side(LPC_BLOCK_FRAMES);
+    
+    auto emit = [&](const LpcChannelCode& code) {
+        append_bytes(out, code.bytes.data(), code.bytes.size());
+        if (code.method == LPC_METHOD_QLP) stats.lpc_subblocks++;
+        else stats.fixed_subblocks++;
+        stats.order_sum += code.order;
+        stats.wasted_sum += code.wasted;
+    };
+    
+    for (int64_t first = 0; first < audio.total_samples; first += LPC_BLOCK_FRAMES) {
+        int64_t n = std::min<int64_t>(LPC_BLOCK_FRAMES, audio.total_samples - first);
+        const int32_t* frames = audio.interleaved_data.data() + first * channels;
+        
+        if (!stereo) {
+            for (int ch = 0; ch < channels; ch++) {
+                lpc_encode_channel(frames + ch, channels, n, packed, work, codes[0]);
+                emit(codes[0]);
+            }
+            continue;
+        }
+        
+        lpc_encode_channel(frames, 2, n, packed, work, codes[0]);
+        lpc_encode_channel(frames + 1, 2, n, packed, work, codes[1]);
+        uint8_t mode = STEREO_INDEPENDENT;
+        if (stereo_signals(frames, n, mid.data(), side.data())) {
+            lpc_encode_channel(mid.data(), 1, n, packed, work, codes[2]);
+            lpc_encode_channel(side.data(), 1, n, packed, work, codes[3]);
+            size_t best = SIZE_MAX;
+            for (uint8_t candidate = STEREO_INDEPENDENT; candidate <= STEREO_MID_SIDE; candidate++) {
+                size_t size = codes[stereo_pairs[candidate][0]].bytes.size() +
+                              codes[stereo_pairs[candidate][1]].bytes.size();
+                if (size < best) {
+                    best = size;
+                    mode = candidate;
+                }
+            }
+        }
+        
+        out.push_back((char)mode);
+        emit(codes[stereo_pairs[mode][0]]);
+        emit(codes[stereo_pairs[mode][1]]);
+        stats.stereo_blocks[mode]++;
+    }
+}
+
+
+// ➕ UNDO PREDICTION in place: x[order..n) from the warmup samples and residuals
+template <int ORDER>
+void lpc_restore_fixed_order(int32_t* x, int64_t n, const int32_t* c, int shift, const uint32_t* residuals) {
+    for (int64_t i = ORDER; i < n; i++) {
+        int64_t prediction = 0;
+        for (int j = 0; j < ORDER; j++) {
+            prediction += (int64_t)c[j] * x[i - 1 - j];
+        }
+        x[i] = (int32_t)(unzigzag(residuals[i - ORDER]) + (prediction >> shift));
+    }
+}
+
+void lpc_restore(int32_t* x, int64_t n, const int32_t* c, int order, int shift, const uint32_t* residuals) {
+    // Compile-time orders let the compiler unroll the common cases (the encoder only emits these)
+    switch (order) {
+        case 0: lpc_restore_fixed_order<0>(x, n, c, shift, residuals); return;
+        case 1: lpc_restore_fixed_order<1>(x, n, c, shift, residuals); return;
+        case 2: lpc_restore_fixed_order<2>(x, n, c, shift, residuals); return;
+        case 3: lpc_restore_fixed_order<3>(x, n, c, shift, residuals); return;
+        case 4: lpc_restore_fixed_order<4>(x, n, c, shift, residuals); return;
+        case 8: lpc_restore_fixed_order<8>(x, n, c, shift, residuals); return;
+        case 12: lpc_restore_fixed_order<12>(x, n, c, shift, residuals); return;
+        case 16: lpc_restore_fixed_order<16>(x, n, c, shift, residuals); return;
+        case 24: lpc_restore_fixed_order<24>(x, n, c, shift, residuals); return;
+        case 32: lpc_restore_fixed_order<32>(x, n, c, shift, residuals); return;
+    }
+    
+    for (int64_t i = order; i < n; i++) {
+        int64_t prediction = 0;
+        for (int j = 0; j < order; j++) {
+            prediction += (int64_t)c[j] * x[i - 1 - j];
+        }
+        x[i] = (int32_t)(unzigzag(residuals[i - order]) + (prediction >> shift));
+    }
+}
+
+// ➕ UNDO A FIXED PREDICTOR: an order-k fixed residual is the k-th difference of the signal,
+// so the samples come back as k running sums seeded from the warmup. Each sum is a 4-wide
+// prefix scan over the (L1-resident) block; wrapping 32-bit math is exact since shift is 0.
+void prefix_sum(uint32_t* v, int64_t n, uint32_t carry) {
+    int64_t i = 0;
+#if defined(__SSE2__)
+    __m128i running = _mm_set1_epi32((int)carry);
+    for (; i + 4 <= n; i += 4) {
+        __m128i sum = _mm_loadu_si128(reinterpret_cast<const __m128i*>(v + i));
+        sum = _mm_add_epi32(sum, _mm_slli_si128(sum, 4));
+        sum = _mm_add_epi32(sum, _mm_slli_si128(sum, 8));
+        sum = _mm_add_epi32(sum, running);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(v + i), sum);
+        running = _mm_shuffle_epi32(sum, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    carry = (uint32_t)_mm_cvtsi128_si32(running);
+#endif
+    for (; i < n; i++) v[i] = carry += v[i];
+}
+
+void lpc_restore_fixed(int32_t* x, int64_t n, int order, const uint32_t* residuals) {
+    uint32_t* y = reinterpret_cast<uint32_t*>(x);
+    
+    // seeds[level] = level-th difference of the warmup at its last sample
+    uint32_t diff[4], seeds[4];
+    for (int j = 0; j < order; j++) diff[j] = y[j];
+    for (int level = 0; level < order; level++) {
+        seeds[level] = diff[order - 1];
+        for (int j = order - 1; j > level; j--) diff[j] -= diff[j - 1];
+    }
+    
+    int64_t count = n - order, i = 0;
+    uint32_t* dest = y + order;
+#if defined(__SSE2__)
+    const __m128i one = _mm_set1_epi32(1);
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(residuals + i));
+        v = _mm_xor_si128(_mm_srli_epi32(v, 1), _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(v, one)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), v);
+    }
+#endif
+    for (; i < count; i++) dest[i] = (uint32_t)unzigzag(residuals[i]);
+    
+    for (int level = order - 1; level >= 0; level--) prefix_sum(dest, count, seeds[level]);
+}
+
+// 🧮 DECODE AN LPC STREAM into interleaved int32 (bit-exact inverse of the converter)
+bool lpc_decode(const char* data, size_t size, int channels, int64_t total_frames,
+                uint32_t block_frames, uint32_t flags, int32_t* out) {
+    if (block_frames == 0) return false;
+
+    size_t pos = 0;
+    auto take = [&](void* dest, size_t bytes) -> bool {
+        if (pos + bytes > size) return false;
+        std::memcpy(dest, data + pos, bytes);
+        pos += bytes;
+        return true;
+    };
+    
+    std::vector<int32_t> x(block_frames);
+    std::vector<int32_t> coefficients(LPC_MAX_ORDER);
+    std::vector<uint32_t> residuals(block_frames + BITPACK_GROUP); // Packed groups unpack whole
+    
+    for (int64_t first = 0; first < total_frames; first += block_frames) {
+        int64_t n = std::min<int64_t>(block_frames, total_frames - first);
+        
+        uint8_t stereo = STEREO_INDEPENDENT;
+        if (flags & HMICAP_FLAG_STEREO) {
+            if (channels != 2 || !take(&stereo, 1) || stereo > STEREO_MID_SIDE) return false;
+        }
+        
+        for (int ch = 0; ch < channels; ch++) {
+            uint8_t info[4];
+            if (!take(info, 4)) return false;
+            uint8_t method = info[0], order = info[1], wasted = info[2], shift = info[3];
+            
+            if (order > n || (method == LPC_METHOD_FIXED && order > 4) ||
+                (method == LPC_METHOD_QLP && order > LPC_MAX_ORDER) || method > LPC_METHOD_QLP || wasted > 31) {
+                return false;
+            }
+            
+            if (method == LPC_METHOD_QLP) {
+                if (!take(coefficients.data(), order * sizeof(int32_t))) return false;
+            } else {
+                std::copy(FIXED_COEFFICIENTS[order], FIXED_COEFFICIENTS[order] + order, coefficients.begin());
+                shift = 0;
+            }
+            
+            if (!take(x.data(), order * sizeof(int32_t))) return false;
+            
+            if (flags & HMICAP_FLAG_PACKED) {
+                if (!bitpack_decode(data, size, pos, residuals.data(), n - order)) return false;
+            } else {
+                BitReader reader(data + pos, size - pos);
+                if (!rice_decode(reader, residuals.data(), n - order)) return false;
+                pos += reader.byte_offset();
+            }
+            
+            if (method == LPC_METHOD_FIXED) lpc_restore_fixed(x.data(), n, order, residuals.data());
+            else lpc_restore(x.data(), n, coefficients.data(), order, shift, residuals.data());
+            
+            int32_t* dest = out + first * channels + ch;
+            for (int64_t i = 0; i < n; i++) {
+                dest[i * channels] = (int32_t)((uint32_t)x[i] << wasted);
+            }
+        }
+        
+        if (stereo != STEREO_INDEPENDENT) stereo_restore(out + first * channels, n, stereo);
+    }
+    
+    return pos == size;
+}
+
+// 🧮 BUILD THE UNCOMPRESSED LPC PAYLOAD (header + LPC stream)
+std::vector<char> build_lpc_payload(const AudioData& audio, LpcStats& stats, bool packed, bool stereo) {
+    stereo = stereo && audio.channels == 2;
+    
+    HMICAPHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "HMICAP01", 8);
+    header.sample_rate = audio.sample_rate;
+    header.channels = audio.channels;
+    header.bit_depth = 32;
+    header.total_samples = audio.total_samples;
+    header.flags = HMICAP_FLAG_LPC | (packed ? HMICAP_FLAG_PACKED : 0) | (stereo ? HMICAP_FLAG_STEREO : 0);
+    header.block_frames = LPC_BLOCK_FRAMES;
+    
+    std::vector<char> payload;
+    payload.reserve(sizeof(header) + audio.interleaved_data.size() * sizeof(int32_t) + 4096);
+    append_bytes(payload, &header, sizeof(header));
+    lpc_encode(audio, payload, stats, packed, stereo);
+    return payload;
+}
+
+// 🧮 WRITE LOSSLESS LPC HMICAP7 (predicted residuals + zstd)
+bool write_hmicap7_lpc(const std::string& path, const AudioData& audio) {
+    std::cout << "\n🧮 Writing HMICAP7 file (LPC lossless INT32)...\n";
+    
+    LpcStats stats;
+    std::vector<char> payload = build_lpc_payload(audio, stats, false, true);
+    
+    uint64_t subblocks = stats.fixed_subblocks + stats.lpc_subblocks;
+    if (subblocks > 0) {
+        std::cout << "  📐 Predictors: " << stats.lpc_subblocks << " LPC, " << stats.fixed_subblocks
+                  << " fixed (avg order " << (double)stats.order_sum / subblocks
+                  << ", avg wasted bits " << (double)stats.wasted_sum / subblocks << ")\n";
+    }
+    print_stereo_stats(stats);
+    
+    size_t compressed_bound = ZSTD_compressBound(payload.size());
+    std::vector<char> compressed_data(compressed_bound);
+    
+    std::cout << "  🔄 Packing " << payload.size() / 1024.0 / 1024.0 << " MB of Rice-coded residuals...\n";
+    
+    size_t compressed_size = ZSTD_compress(compressed_data.data(), compressed_bound,
+                                           payload.data(), payload.size(), LPC_ZSTD_LEVEL);
+    
+    if (ZSTD_isError(compressed_size)) {
+        std::cerr << "❌ Compression failed: " << ZSTD_getErrorName(compressed_size) << "\n";
+        return false;
+    }
+    
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "❌ Failed to create HMICAP7 file\n";
+        return false;
+    }
+    
+    file.write(compressed_data.data(), compressed_size);
+    file.close();
+    
+    size_t raw_size = sizeof(HMICAPHeader) + audio.interleaved_data.size() * sizeof(int32_t);
+    float ratio = (float)raw_size / compressed_size;
+    
+    std::cout << "  ✅ HMICAP7 written: " << compressed_size / 1024.0 / 1024.0 << " MB\n";
+    std::cout << "  📊 Compression ratio: " << ratio << "x 💯\n";
+    std::cout << "  💎 LPC residuals decode bit-exact = LOSSLESS 💎\n";
+    
+    return true;
+}
+
+// 📦 WRITE BIT-PACKED HMICAP (fixed predictors + packed residuals, no zstd - loads at I/O speed)
+bool write_hmicap_packed(const std::string& path, const AudioData& audio) {
+    std::cout << "\n📦 Writing HMICAP file (bit-packed INT32)...\n";
+    
+    LpcStats stats;
+    std::vector<char> payload = build_lpc_payload(audio, stats, true, true);
+    
+    uint64_t subblocks = stats.fixed_subblocks + stats.lpc_subblocks;
+    if (subblocks > 0) {
+        std::cout << "  📐 Fixed predictors: avg order " << (double)stats.order_sum / subblocks
+                  << ", avg wasted bits " << (double)stats.wasted_sum / subblocks << "\n";
+    }
+    print_stereo_stats(stats);
+    
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "❌ Failed to create HMICAP file\n";
+        return false;
+    }
+    
+    file.write(payload.data(), payload.size());
+    file.close();
+    
+    size_t raw_size = sizeof(HMICAPHeader) + audio.interleaved_data.size() * sizeof(int32_t);
+    
+    std::cout << "  ✅ HMICAP written: " << payload.size() / 1024.0 / 1024.0 << " MB\n";
+    std::cout << "  📊 Packing ratio: " << (float)raw_size / payload.size() << "x 💯\n";
+    std::cout << "  💎 Residuals unpack bit-exact with SIMD = LOSSLESS 💎\n";
+    
+    return true;
+}
+
+// 📊 LPC vs PLAIN HMICAP7 REPORT (size, encode and decode speed, bit-exact check)
+bool run_lpc_report(const AudioData& audio) {
+    using Clock = std::chrono::steady_clock;
+    auto seconds_since = [](Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    };
+    
+    std::cout << "\n📊 Comparing plain HMICAP7 against LPC lossless and bit-packing...\n";
+    
+    size_t sample_bytes = audio.interleaved_data.size() * sizeof(int32_t);
+    size_t raw_size = sizeof(HMICAPHeader) + sample_bytes;
+    
+    // Plain HMICAP7 exactly as write_hmicap7 builds it
+    HMICAPHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "HMICAP01", 8);
+    header.sample_rate = audio.sample_rate;
+    header.channels = audio.channels;
+    header.bit_depth = 32;
+    header.total_samples = audio.total_samples;
+    
+    std::vector<char> plain(raw_size);
+    std::memcpy(plain.data(), &header, sizeof(header));
+    std::memcpy(plain.data() + sizeof(header), audio.interleaved_data.data(), sample_bytes);
+    
+    auto start = Clock::now();
+    std::vector<char> plain_compressed(ZSTD_compressBound(plain.size()));
+    size_t plain_size = ZSTD_compress(plain_compressed.data(), plain_compressed.size(),
+                                      plain.data(), plain.size(), 19);
+    double plain_encode = seconds_since(start);
+    if (ZSTD_isError(plain_size)) {
+        std::cerr << "❌ Compression failed: " << ZSTD_getErrorName(plain_size) << "\n";
+        return false;
+    }
+    
+    start = Clock::now();
+    std::vector<char> plain_decoded(raw_size);
+    size_t plain_result = ZSTD_decompress(plain_decoded.data(), plain_decoded.size(),
+                                          plain_compressed.data(), plain_size);
+    double plain_decode = seconds_since(start);
+    if (ZSTD_isError(plain_result)) {
+        std::cerr << "❌ Decompression failed: " << ZSTD_getErrorName(plain_result) << "\n";
+        return false;
+    }
+    
+    // LPC: predict + zstd, then zstd + reconstruct
+    start = Clock::now();
+    LpcStats stats;
+    std::vector<char> payload = build_lpc_payload(audio, stats, false, true);
+    double lpc_predict = seconds_since(start);
+    std::vector<char> lpc_compressed(ZSTD_compressBound(payload.size()));
+    size_t lpc_size = ZSTD_compress(lpc_compressed.data(), lpc_compressed.size(),
+                                    payload.data(), payload.size(), LPC_ZSTD_LEVEL);
+    double lpc_encode = seconds_since(start);
+    if (ZSTD_isError(lpc_size)) {
+        std::cerr << "❌ Compression failed: " << ZSTD_getErrorName(lpc_size) << "\n";
+        return false;
+    }
+    
+    start = Clock::now();
+    std::vector<char> lpc_payload(payload.size());
+    size_t lpc_result = ZSTD_decompress(lpc_payload.data(), lpc_payload.size(),
+                                        lpc_compressed.data(), lpc_size);
+    std::vector<int32_t> decoded(audio.interleaved_data.size());
+    HMICAPHeader lpc_header;
+    std::memcpy(&lpc_header, payload.data(), sizeof(lpc_header));
+    bool decoded_ok = !ZSTD_isError(lpc_result) &&
+        lpc_decode(lpc_payload.data() + sizeof(HMICAPHeader), lpc_result - sizeof(HMICAPHeader),
+                   audio.channels, audio.total_samples, LPC_BLOCK_FRAMES, lpc_header.flags, decoded.data());
+    double lpc_decode_time = seconds_since(start);
+    
+    bool exact = decoded_ok && decoded == audio.interleaved_data;
+    
+    // Bit-packed: fixed predictors + packed residuals, stored as-is (decode = unpack + restore)
+    start = Clock::now();
+    LpcStats packed_stats;
+    std::vector<char> packed = build_lpc_payload(audio, packed_stats, true, true);
+    double packed_encode = seconds_since(start);
+    
+    HMICAPHeader packed_header;
+    std::memcpy(&packed_header, packed.data(), sizeof(packed_header));
+    std::fill(decoded.begin(), decoded.end(), 0);
+    start = Clock::now();
+    bool packed_ok = lpc_decode(packed.data() + sizeof(HMICAPHeader), packed.size() - sizeof(HMICAPHeader),
+                                audio.channels, audio.total_samples, LPC_BLOCK_FRAMES, packed_header.flags,
+                                decoded.data());
+    double packed_decode = seconds_since(start);
+    bool packed_exact = packed_ok && decoded == audio.interleaved_data;
+    
+    double mb = raw_size / 1024.0 / 1024.0;
+    std::cout << "\n  format            size MB   ratio   encode s   decode s   decode MB/s\n";
+    auto row = [&](const char* name, size_t size, double encode, double decode) {
+        std::printf("  %-16s %8.2f %7.2fx %10.3f %10.3f %13.1f\n", name, size / 1024.0 / 1024.0,
+                    (double)raw_size / size, encode, decode, decode > 0 ? mb / decode : 0.0);
+    };
+    row("HMICAP (raw)", raw_size, 0.0, 0.0);
+    row("HMICAP7", plain_size, plain_encode, plain_decode);
+    row("HMICAP7 + LPC", lpc_size, lpc_encode, lpc_decode_time);
+    row("HMICAP packed", packed.size(), packed_encode, packed_decode);
+    
+    std::cout << "\n  📐 LPC analysis " << lpc_predict << " s, file is "
+              << 100.0 * lpc_size / plain_size << "% of plain HMICAP7\n";
+    std::cout << "  📦 Bit-packed file is " << 100.0 * packed.size() / raw_size << "% of raw, decodes at "
+              << (packed_decode > 0 ? sample_bytes / 1e9 / packed_decode : 0.0) << " GB/s\n";
+    
+    // Same streams with the channels coded independently, to show what mid/side buys
+    if (audio.channels == 2) {
+        LpcStats independent_stats;
+        std::vector<char> independent = build_lpc_payload(audio, independent_stats, false, false);
+        std::vector<char> independent_compressed(ZSTD_compressBound(independent.size()));
+        size_t independent_size = ZSTD_compress(independent_compressed.data(), independent_compressed.size(),
+                                                independent.data(), independent.size(), LPC_ZSTD_LEVEL);
+        size_t independent_packed = build_lpc_payload(audio, independent_stats, true, false).size();
+        if (!ZSTD_isError(independent_size)) {
+            std::cout << "  🎚️  Adaptive mid/side: LPC " << 100.0 - 100.0 * lpc_size / independent_size
+                      << "% smaller, bit-packed " << 100.0 - 100.0 * packed.size() / independent_packed
+                      << "% smaller than independent L/R\n";
+        }
+        print_stereo_stats(stats);
+    }
+    std::cout << "  " << (exact ? "✅ LPC round trip is bit-exact" : "❌ LPC round trip MISMATCH") << "\n";
+    std::cout << "  " << (packed_exact ? "✅ Bit-packed round trip is bit-exact" : "❌ Bit-packed round trip MISMATCH") << "\n";
+    
+    return exact && packed_exact;
+}
+
 int main() {
     // Initialize mpg123
     mpg123_init();
@@ -292,7 +1385,7 @@ int main() {
     
     // Get output format
     std::string format;
-    std::cout << "\nChoose format (HMICAP / HMICAP7): ";
+    std::cout << "\nChoose format (HMICAP / HMICAPP = bit-packed / HMICAP7 / HMICAP7L = LPC lossless / BENCH = compare): ";
     std::getline(std::cin, format);
     std::transform(format.begin(), format.end(), format.begin(), ::toupper);
     
@@ -302,9 +1395,44 @@ int main() {
     if (format == "HMICAP") {
         std::string output = base_name + ".hmicap";
         success = write_hmicap(output, audio);
+    } else if (format == "HMICAPP") {
+        std::string output = base_name + ".hmicap";
+        success = write_hmicap_packed(output, audio);
     } else if (format == "HMICAP7") {
+        // 🗜️ Profile name, a budget in seconds per audio minute, or both ("archive 20")
+        CompressionSettings compression;
+        std::string choice;
+        std::cout << "\nCompression profile (";
+        for (const auto& profile : COMPRESSION_PROFILES) std::cout << profile.name << (&profile + 1 == std::end(COMPRESSION_PROFILES) ? "" : " / ");
+        std::cout << ") and/or a time budget in s per audio minute [max]: ";
+        std::getline(std::cin, choice);
+        std::transform(choice.begin(), choice.end(), choice.begin(), ::tolower);
+        
+        std::istringstream words(choice);
+        std::string word;
+        while (words >> word) {
+            char* end = nullptr;
+            double budget = std::strtod(word.c_str(), &end);
+            if (const CompressionProfile* profile = find_compression_profile(word)) {
+                compression.profile = profile;
+            } else if (*end == '\0' && budget > 0.0) {
+                compression.budget = budget;
+            } else {
+                std::cerr << "❌ Unknown compression choice: " << word << "\n";
+                mpg123_exit();
+                return 1;
+            }
+        }
+        
         std::string output = base_name + ".hmicap7";
-        success = write_hmicap7(output, audio);
+        success = write_hmicap7(output, audio, compression);
+    } else if (format == "HMICAP7L") {
+        std::string output = base_name + ".hmicap7";
+        success = write_hmicap7_lpc(output, audio);
+    } else if (format == "BENCH") {
+        bool exact = run_lpc_report(audio);
+        mpg123_exit();
+        return exact ? 0 : 1;
     } else {
         std::cerr << "❌ Invalid format!\n";
         mpg123_exit();
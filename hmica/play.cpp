@@ -209,26 +209,50 @@ bool load_hmica7(const std::string& path, AudioData& audio) {
         return false;
     }
     
-    if (decompressed_size == ZSTD_CONTENTSIZE_UNKNOWN) {
-        std::cerr << "❌ Decompressed size unknown!\n";
-        return false;
-    }
+    std::string content;
     
-    std::cout << "  🌀 Decompressing " << decompressed_size / 1024 << " KB...\n";
-    
-    std::vector<char> decompressed_data(decompressed_size);
-    size_t actual_decompressed = ZSTD_decompress(decompressed_data.data(), decompressed_size,
-                                                  compressed_data.data(), compressed_size);
-    
-    if (ZSTD_isError(actual_decompressed)) {
-        std::cerr << "❌ Decompression error: " << ZSTD_getErrorName(actual_decompressed) << "\n";
-        return false;
+    if (decompressed_size == ZSTD_CONTENTSIZE_UNKNOWN) {
+        // 🏭 Pipelined converter output: streamed frame, size not in the header
+        std::cout << "  🌀 Streaming decompression (size not stored in frame)...\n";
+        
+        ZSTD_DCtx* dctx = ZSTD_createDCtx();
+        ZSTD_inBuffer input = {compressed_data.data(), (size_t)compressed_size, 0};
+        std::vector<char> out_chunk(ZSTD_DStreamOutSize());
+        
+        while (true) {
+            ZSTD_outBuffer output = {out_chunk.data(), out_chunk.size(), 0};
+            size_t ret = ZSTD_decompressStream(dctx, &output, &input);
+            
+            if (ZSTD_isError(ret)) {
+                std::cerr << "❌ Decompression error: " << ZSTD_getErrorName(ret) << "\n";
+                ZSTD_freeDCtx(dctx);
+                return false;
+            }
+            
+            content.append(out_chunk.data(), output.pos);
+            
+            // Done once all input is consumed and the decoder had nothing left to flush
+            if (input.pos == input.size && output.pos < output.size) break;
+        }
+        
+        ZSTD_freeDCtx(dctx);
+    } else {
+        std::cout << "  🌀 Decompressing " << decompressed_size / 1024 << " KB...\n";
+        
+        std::vector<char> decompressed_data(decompressed_size);
+        size_t actual_decompressed = ZSTD_decompress(decompressed_data.data(), decompressed_size,
+                                                      compressed_data.data(), compressed_size);
+        
+        if (ZSTD_isError(actual_decompressed)) {
+            std::cerr << "❌ Decompression error: " << ZSTD_getErrorName(actual_decompressed) << "\n";
+            return false;
+        }
+        
+        content.assign(decompressed_data.begin(), decompressed_data.end());
     }
     
     std::cout << "  ✅ Decompressed successfully! 🔥\n";
     
-    std::string content(decompressed_data.begin(), decompressed_data.end());
-    
     // Parse info block
     if (!parse_info_block(content, audio)) {
         return false;
@@ -1,4 +1,6 @@
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -6,6 +8,42 @@
 #include <cstring>
 #include <filesystem>
 #include <algorithm>
+#include <iomanip>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <chrono>
+#include <set>
+#include <map>
+#include <sstream>
+#include <csignal>
+#include <cerrno>
+
+// 🔑 XXH3 HASHING (header-only)
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
+// 👀 WATCH MODE (Linux)
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+
+// ⚡ ASYNC FILE I/O (io_uring when the kernel headers have it, pread/pwrite otherwise)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define HMICAP_HAVE_IO_URING 1
+#else
+#define HMICAP_HAVE_IO_URING 0
+#endif
 
 // 🎵 AUDIO DECODING
 #include <mpg123.h>
@@ -14,187 +52,5937 @@
 // 🚀 ZSTD COMPRESSION
 #include <zstd.h>
 
-namespace fs = std::filesystem;
+// ⚡ LZ4 FRAMES (optional fast-decode HMICAP7 codec: build with -DHMICAP_WITH_LZ4 and link -llz4)
+#if defined(HMICAP_WITH_LZ4)
+#include <lz4frame.h>
+#define HMICAP_HAVE_LZ4 1
+#else
+#define HMICAP_HAVE_LZ4 0
+#endif
+
+// 🔀 SIMD SHUFFLE/CONVERSION KERNELS (SSE2 is baseline on x86-64; scalar fallback elsewhere)
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// 🎧 AUDIO DATA STRUCTURE
+struct AudioData {
+    int sample_rate;
+    int channels;
+    int64_t total_samples;
+    std::vector<float> interleaved_data; // Already interleaved for MAXIMUM SPEED!!
+    uint16_t native_format = 0;          // Smallest SampleFormat that holds the source losslessly-ish
+};
+
+// ⏱️ CONVERSION SETTINGS (from the command line)
+struct ConvertSettings {
+    double start_seconds = 0.0; // Excerpt start (0 = from the beginning)
+    double end_seconds = -1.0;  // Excerpt end (<0 = until the end of the track)
+    double block_seconds = 0.0; // >0 = seekable HMICAP7 made of independent blocks this long
+    uint32_t shuffle = 0;       // HMICAP7 pre-filter: HMICAP_FLAG_BYTE_SHUFFLE / HMICAP_FLAG_BIT_SHUFFLE (0 = off)
+    bool planar = false;        // Store each block channel by channel instead of interleaved
+    uint16_t sample_format = 0; // SampleFormat on disk, or SAMPLE_FORMAT_AUTO (pick from the source)
+    bool checksums = true;      // Store an xxh3 checksum per block (HMICAP_FLAG_CHECKSUMS)
+    bool overview = true;       // Store the min/max/RMS pyramid (HMICAP_FLAG_OVERVIEW)
+    bool runs = false;          // HMICAP: cut constant runs (silence) out of the payload (HMICAP_FLAG_RUNS)
+    bool xor_codec = false;     // HMICAP: XOR-delta code the float32 blocks instead of storing them raw (HMICAP_FLAG_XOR)
+    int zstd_level = 19;        // HMICAP7 compression (see COMPRESSION PROFILES, --profile)
+    int zstd_window_log = 0;    // 0 = the level's default window
+    bool zstd_long_distance = false;
+    unsigned zstd_workers = 0;  // ZSTD_c_nbWorkers for the single streaming frame (0 = on the zstd thread)
+    double zstd_budget = 0.0;   // >0 = adaptive level: seconds of compression allowed per minute of audio
+    bool lz4 = false;           // HMICAP7 as LZ4 frames instead of zstd (HMICAP_FLAG_LZ4); zstd_level is then LZ4's
+    bool page_align = false;    // HMICAP: samples start at PAGE_PAYLOAD_OFFSET (HMICAP_FLAG_PAGE_ALIGNED)
+    bool direct = false;        // Write outputs (and hash sources for the cache) with O_DIRECT - no page cache
+    bool text = false;          // Write hmica/'s text formats instead: HMICA, or HMICA7 when compressing (see TEXT OUTPUT)
+};
+
+// 📛 OUTPUT FORMAT: name as typed on the command line, extension of the files it writes
+const char* output_format_name(bool compress, const ConvertSettings& settings) {
+    if (settings.text) return compress ? "HMICA7" : "HMICA";
+    return compress ? "HMICAP7" : "HMICAP";
+}
+
+std::string output_extension(bool compress, const ConvertSettings& settings) {
+    std::string extension = std::string(".") + output_format_name(compress, settings);
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    return extension;
+}
+
+// 🔥 HMICAP HEADER STRUCTURE (40 bytes on disk - the uint64 pads it out)
+struct HMICAPHeader {
+    char magic[8];          // "HMICAP01"
+    uint32_t sample_rate;   // Hz
+    uint16_t channels;      // 1=mono, 2=stereo, etc
+    uint16_t sample_format; // SampleFormat (0 = float32, what every older file has)
+    uint64_t total_samples; // Samples per channel
+    uint32_t flags;         // HMICAP_FLAG_* (always 0 in files from older converters)
+    uint32_t block_frames;  // Seekable HMICAP7: frames per independent zstd frame; shuffled/planar: frames per block
+    uint8_t reserved2[8];   // Future metadata
+};
+static_assert(sizeof(HMICAPHeader) == 40, "HMICAP header is 40 bytes on disk");
+
+const uint32_t HMICAP_FLAG_SEEKABLE = 1u << 0; // HMICAP7 split into independent frames + zstd seek table
+const uint32_t HMICAP_FLAG_LZ4 = 1u << 1;      // HMICAP7 frames are LZ4, not zstd (see COMPRESSION PROFILES)
+const uint32_t HMICAP_FLAG_CHECKSUMS = 1u << 5; // xxh3 table after the payload (see BLOCK CHECKSUMS)
+const uint32_t HMICAP_FLAG_OVERVIEW = 1u << 6;  // min/max/RMS pyramid after that (see OVERVIEW PYRAMID)
+const uint32_t HMICAP_FLAG_RUNS = 1u << 7;      // HMICAP: constant runs cut out, run table at the end (see CONSTANT RUNS)
+const uint32_t HMICAP_FLAG_XOR = 1u << 8;       // HMICAP: XOR-delta coded float32 blocks, index at the end (see XOR FLOAT CODEC)
+const uint32_t HMICAP_FLAG_PAGE_ALIGNED = 1u << 9; // HMICAP: payload starts at PAGE_PAYLOAD_OFFSET (see PLANAR LAYOUT)
+const size_t PAYLOAD_BLOCK_FRAMES = 65536;     // Shuffle/planar block of a non-seekable file (= pipeline block)
+
+// 🧮 SAMPLE FORMATS ═════════════════════════════════════════════════════════
+// header.sample_format says how each sample is stored. Everything is float in [-1, 1] in
+// memory; integers are scaled by 2^(bits-1) like libsndfile does, so a 16/24-bit source
+// round-trips exactly. int24 is packed little-endian 3 bytes, float16 is IEEE half.
+enum SampleFormat : uint16_t {
+    SAMPLE_FLOAT32 = 0,
+    SAMPLE_INT16 = 1,
+    SAMPLE_INT24 = 2,
+    SAMPLE_FLOAT16 = 3,
+};
+const uint16_t SAMPLE_FORMAT_AUTO = 0xFFFF; // Converter only: use the source's native format
+
+size_t sample_bytes(uint16_t format) {
+    switch (format) {
+        case SAMPLE_INT16: return 2;
+        case SAMPLE_INT24: return 3;
+        case SAMPLE_FLOAT16: return 2;
+        default: return 4;
+    }
+}
+
+const char* sample_format_name(uint16_t format) {
+    switch (format) {
+        case SAMPLE_FLOAT32: return "f32";
+        case SAMPLE_INT16: return "s16";
+        case SAMPLE_INT24: return "s24";
+        case SAMPLE_FLOAT16: return "f16";
+        case SAMPLE_FORMAT_AUTO: return "auto";
+        default: return "unknown";
+    }
+}
+
+// Returns false for anything that isn't a format name
+bool parse_sample_format_arg(const std::string& text, uint16_t& format) {
+    for (uint16_t candidate : std::initializer_list<uint16_t>{SAMPLE_FLOAT32, SAMPLE_INT16, SAMPLE_INT24, SAMPLE_FLOAT16, SAMPLE_FORMAT_AUTO}) {
+        if (text == sample_format_name(candidate)) {
+            format = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint16_t resolve_sample_format(const ConvertSettings& settings, const AudioData& audio) {
+    return settings.sample_format == SAMPLE_FORMAT_AUTO ? audio.native_format : settings.sample_format;
+}
+
+void print_sample_format(uint16_t format, std::ostream& log) {
+    if (format != SAMPLE_FLOAT32) {
+        log << "  🧮 " << sample_format_name(format) << " samples (" << sample_bytes(format) << " bytes each)\n";
+    }
+}
+
+// Round-to-nearest-even float → half (F. Giesen's float_to_half_fast3_rtne)
+inline uint16_t float_to_half(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, 4);
+    uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+    uint16_t half;
+    if (bits >= (127u + 16) << 23) {
+        half = bits > 0x7F800000u ? 0x7E00 : 0x7C00; // NaN stays NaN, too big → inf
+    } else if (bits < 113u << 23) {
+        // Subnormal half: let the FPU round by adding a magic number
+        const uint32_t magic_bits = ((127u - 15) + (23 - 10) + 1) << 23;
+        float magic, shifted;
+        std::memcpy(&magic, &magic_bits, 4);
+        std::memcpy(&shifted, &bits, 4);
+        shifted += magic;
+        std::memcpy(&bits, &shifted, 4);
+        half = bits - magic_bits;
+    } else {
+        uint32_t mantissa_odd = (bits >> 13) & 1;
+        bits += ((15u - 127) << 23) + 0xFFF + mantissa_odd;
+        half = bits >> 13;
+    }
+    return half | (sign >> 16);
+}
+
+inline float half_to_float(uint16_t half) {
+    const uint32_t shifted_exp = 0x7C00u << 13;
+    uint32_t bits = (half & 0x7FFFu) << 13;
+    uint32_t exp = bits & shifted_exp;
+    bits += (127u - 15) << 23;
+    float value;
+    if (exp == shifted_exp) {
+        bits += (128u - 16) << 23; // Inf/NaN
+        std::memcpy(&value, &bits, 4);
+    } else if (exp == 0) {
+        bits += 1u << 23; // Subnormal: renormalize through the FPU
+        std::memcpy(&value, &bits, 4);
+        value -= 6.103515625e-05f; // 2^-14
+    } else {
+        std::memcpy(&value, &bits, 4);
+    }
+    uint32_t out;
+    std::memcpy(&out, &value, 4);
+    out |= (uint32_t)(half & 0x8000u) << 16;
+    std::memcpy(&value, &out, 4);
+    return value;
+}
+
+// 🧮 n FLOATS → n SAMPLES of `format` in dst (sample_bytes(format) each)
+void pack_samples(uint16_t format, const float* src, size_t n, char* dst) {
+    size_t i = 0;
+    if (format == SAMPLE_INT16) {
+#if defined(__SSE2__)
+        // cvtps rounds to nearest even, packs saturates to [-32768, 32767]
+        const __m128 scale = _mm_set1_ps(32768.0f);
+        for (; i + 8 <= n; i += 8) {
+            __m128i a = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i), scale));
+            __m128i b = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i + 4), scale));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2), _mm_packs_epi32(a, b));
+        }
+#endif
+        for (; i < n; i++) {
+            int16_t value = (int16_t)std::max(-32768L, std::min(32767L, std::lrintf(src[i] * 32768.0f)));
+            std::memcpy(dst + i * 2, &value, 2);
+        }
+    } else if (format == SAMPLE_INT24) {
+        for (; i < n; i++) {
+            int32_t value = (int32_t)std::max(-8388608L, std::min(8388607L, std::lrintf(src[i] * 8388608.0f)));
+            dst[i * 3] = (char)value;
+            dst[i * 3 + 1] = (char)(value >> 8);
+            dst[i * 3 + 2] = (char)(value >> 16);
+        }
+    } else if (format == SAMPLE_FLOAT16) {
+#if defined(__F16C__)
+        for (; i + 8 <= n; i += 8) {
+            __m128i a = _mm_cvtps_ph(_mm_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+            __m128i b = _mm_cvtps_ph(_mm_loadu_ps(src + i + 4), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2), _mm_unpacklo_epi64(a, b));
+        }
+#endif
+        for (; i < n; i++) {
+            uint16_t value = float_to_half(src[i]);
+            std::memcpy(dst + i * 2, &value, 2);
+        }
+    } else {
+        std::memcpy(dst, src, n * 4);
+    }
+}
+
+// 🧮 n SAMPLES of `format` → n FLOATS (what the player does per block)
+void expand_samples(uint16_t format, const char* src, size_t n, float* dst) {
+    size_t i = 0;
+    if (format == SAMPLE_INT16) {
+#if defined(__SSE2__)
+        // Sign-extend by unpacking into the high half and shifting back down
+        const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+        for (; i + 8 <= n; i += 8) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+            __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+            __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+            _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+            _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+        }
+#endif
+        for (; i < n; i++) {
+            int16_t value;
+            std::memcpy(&value, src + i * 2, 2);
+            dst[i] = value * (1.0f / 32768.0f);
+        }
+    } else if (format == SAMPLE_INT24) {
+#if defined(__SSSE3__)
+        // pshufb drops each 3-byte sample into the top of a 32-bit lane, srai sign-extends it
+        const __m128i spread = _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+        const __m128 scale = _mm_set1_ps(1.0f / 8388608.0f);
+        for (; i + 6 <= n; i += 4) { // 16-byte load, 12 bytes used
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+            __m128i lanes = _mm_srai_epi32(_mm_shuffle_epi8(v, spread), 8);
+            _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lanes), scale));
+        }
+#endif
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(src);
+        for (; i < n; i++) {
+            int32_t value = (int32_t)((uint32_t)bytes[i * 3] << 8 | (uint32_t)bytes[i * 3 + 1] << 16 |
+                                      (uint32_t)bytes[i * 3 + 2] << 24) >> 8;
+            dst[i] = value * (1.0f / 8388608.0f);
+        }
+    } else if (format == SAMPLE_FLOAT16) {
+#if defined(__F16C__)
+        for (; i + 8 <= n; i += 8) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+            _mm_storeu_ps(dst + i, _mm_cvtph_ps(v));
+            _mm_storeu_ps(dst + i + 4, _mm_cvtph_ps(_mm_srli_si128(v, 8)));
+        }
+#elif defined(__SSE2__)
+        // Move exponent+mantissa into float position and rescale by 2^112 (F. Giesen's half_to_float_SSE2)
+        const __m128i no_sign = _mm_set1_epi32(0x7FFF);
+        const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23));
+        const __m128i was_infnan = _mm_set1_epi32(0x7BFF);
+        const __m128i exp_infnan = _mm_set1_epi32(255 << 23);
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 8 <= n; i += 8) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+            __m128i halves[2] = {_mm_unpacklo_epi16(v, zero), _mm_unpackhi_epi16(v, zero)};
+            for (int h = 0; h < 2; h++) {
+                __m128i expmant = _mm_and_si128(halves[h], no_sign);
+                __m128i sign = _mm_slli_epi32(_mm_xor_si128(halves[h], expmant), 16);
+                __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(expmant, 13)), magic);
+                __m128i infnan = _mm_and_si128(_mm_cmpgt_epi32(expmant, was_infnan), exp_infnan);
+                _mm_storeu_ps(dst + i + 4 * h, _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(sign, infnan))));
+            }
+        }
+#endif
+        for (; i < n; i++) {
+            uint16_t value;
+            std::memcpy(&value, src + i * 2, 2);
+            dst[i] = half_to_float(value);
+        }
+    } else {
+        std::memcpy(dst, src, n * 4);
+    }
+}
+
+// 🎚️ PLANAR LAYOUT ══════════════════════════════════════════════════════════
+// Each block of header.block_frames frames stores channel 0's samples, then channel 1's, ...
+// Planes are padded with zeros to a multiple of PLANAR_ALIGN_FRAMES and the payload starts at
+// PLANAR_PAYLOAD_OFFSET (header + zero padding), so in a mapped file every plane is 64-byte
+// aligned. block_frames is itself a multiple of PLANAR_ALIGN_FRAMES; only the last block pads.
+const uint32_t HMICAP_FLAG_PLANAR = 1u << 4;
+const size_t PLANAR_ALIGN_FRAMES = 16;   // 16 floats = 64 bytes
+const size_t PLANAR_PAYLOAD_OFFSET = 64;
+
+// HMICAP_FLAG_PAGE_ALIGNED (plain HMICAP): the header is zero padded to a whole page instead, so
+// mapped samples start page-aligned and the payload can be read with O_DIRECT. A multiple of 64,
+// so planar planes stay aligned as well. Opt-in (--page-align): players that predate header.flags
+// read samples from byte 40 and would play the padding and lose the tail, with no error.
+const size_t PAGE_PAYLOAD_OFFSET = 4096;
+
+// Samples between two planes of a block holding `frames` frames
+inline size_t planar_stride(size_t frames) {
+    return (frames + PLANAR_ALIGN_FRAMES - 1) / PLANAR_ALIGN_FRAMES * PLANAR_ALIGN_FRAMES;
+}
+
+// Bytes before the first sample
+inline size_t payload_offset(uint32_t flags) {
+    if (flags & HMICAP_FLAG_PAGE_ALIGNED) return PAGE_PAYLOAD_OFFSET;
+    return (flags & HMICAP_FLAG_PLANAR) ? PLANAR_PAYLOAD_OFFSET : sizeof(HMICAPHeader);
+}
+
+// Samples in the whole payload (planar files pad the last block's planes)
+size_t payload_samples(int64_t total_frames, int channels, size_t block_frames, uint32_t flags) {
+    if (!(flags & HMICAP_FLAG_PLANAR) || block_frames == 0) return total_frames * channels;
+    size_t full_blocks = total_frames / block_frames;
+    size_t last_frames = total_frames - full_blocks * block_frames;
+    return (full_blocks * block_frames + planar_stride(last_frames)) * channels;
+}
+
+// 🎚️ INTERLEAVED → PLANES (stride floats apart, zero padded up to the stride)
+void planarize_block(const float* samples, size_t frames, int channels, size_t stride, float* out) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    if (channels == 2) {
+        // 4 stereo frames per step: even lanes are left, odd lanes are right
+        for (; i + 4 <= frames; i += 4) {
+            __m128 a = _mm_loadu_ps(samples + i * 2);
+            __m128 b = _mm_loadu_ps(samples + i * 2 + 4);
+            _mm_storeu_ps(out + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(out + stride + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+    }
+#endif
+    for (; i < frames; i++) {
+        for (int ch = 0; ch < channels; ch++) out[ch * stride + i] = samples[i * channels + ch];
+    }
+    for (int ch = 0; ch < channels; ch++) {
+        std::fill(out + ch * stride + frames, out + (ch + 1) * stride, 0.0f);
+    }
+}
+
+// 🎚️ PLANES → INTERLEAVED (count frames from planes stride floats apart)
+void interleave_planes(const float* planes, size_t stride, int channels, size_t count, float* out) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    if (channels == 2) {
+        for (; i + 4 <= count; i += 4) {
+            __m128 left = _mm_loadu_ps(planes + i);
+            __m128 right = _mm_loadu_ps(planes + stride + i);
+            _mm_storeu_ps(out + i * 2, _mm_unpacklo_ps(left, right));
+            _mm_storeu_ps(out + i * 2 + 4, _mm_unpackhi_ps(left, right));
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        for (int ch = 0; ch < channels; ch++) out[i * channels + ch] = planes[ch * stride + i];
+    }
+}
+
+// 🔀 BYTE/BIT-PLANE SHUFFLE (Blosc-style pre-filter) ═══════════════════════
+// Inside every block of header.block_frames frames, byte k of each w-byte sample is stored
+// together: the sign/exponent planes compress hard and the noisy low mantissa bytes stop
+// polluting them. The bit shuffle splits each byte plane again into its 8 bit planes.
+// Layout per block of n samples (w = sample_bytes(header.sample_format)):
+//   byte shuffle: plane[k][i] = byte k of sample i                        (w planes of n bytes)
+//   bit shuffle:  m = n & ~7; bit j of plane k, samples 0..m-1 packed LSB-first
+//                 into plane k*8+j (8w planes of m/8 bytes), then the n-m tail samples raw
+const uint32_t HMICAP_FLAG_BYTE_SHUFFLE = 1u << 2;
+const uint32_t HMICAP_FLAG_BIT_SHUFFLE = 1u << 3;
+const uint32_t HMICAP_SHUFFLE_FLAGS = HMICAP_FLAG_BYTE_SHUFFLE | HMICAP_FLAG_BIT_SHUFFLE;
+
+void byte_shuffle4(const uint8_t* src, uint8_t* dst, size_t n) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    // 16 samples per step: isolate byte k of every lane, then narrow 32 → 16 → 8 bits
+    const __m128i low_byte = _mm_set1_epi32(0xFF);
+    for (; i + 16 <= n; i += 16) {
+        __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+        __m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4 + 16));
+        __m128i r2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4 + 32));
+        __m128i r3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4 + 48));
+        for (int k = 0; k < 4; k++) {
+            __m128i count = _mm_cvtsi32_si128(8 * k);
+            __m128i a = _mm_packs_epi32(_mm_and_si128(_mm_srl_epi32(r0, count), low_byte),
+                                        _mm_and_si128(_mm_srl_epi32(r1, count), low_byte));
+            __m128i b = _mm_packs_epi32(_mm_and_si128(_mm_srl_epi32(r2, count), low_byte),
+                                        _mm_and_si128(_mm_srl_epi32(r3, count), low_byte));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + k * n + i), _mm_packus_epi16(a, b));
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        for (int k = 0; k < 4; k++) dst[k * n + i] = src[i * 4 + k];
+    }
+}
+
+void byte_unshuffle4(const uint8_t* src, uint8_t* dst, size_t n) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    // Interleave planes 0+1 and 2+3 into byte pairs, then the pairs into whole samples
+    for (; i + 16 <= n; i += 16) {
+        __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + n + i));
+        __m128i p2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * n + i));
+        __m128i p3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * n + i));
+        __m128i lo01 = _mm_unpacklo_epi8(p0, p1), hi01 = _mm_unpackhi_epi8(p0, p1);
+        __m128i lo23 = _mm_unpacklo_epi8(p2, p3), hi23 = _mm_unpackhi_epi8(p2, p3);
+        __m128i* out = reinterpret_cast<__m128i*>(dst + i * 4);
+        _mm_storeu_si128(out, _mm_unpacklo_epi16(lo01, lo23));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo01, lo23));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi01, hi23));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi01, hi23));
+    }
+#endif
+    for (; i < n; i++) {
+        for (int k = 0; k < 4; k++) dst[i * 4 + k] = src[k * n + i];
+    }
+}
+
+void byte_shuffle2(const uint8_t* src, uint8_t* dst, size_t n) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i low_byte = _mm_set1_epi16(0xFF);
+    for (; i + 16 <= n; i += 16) {
+        __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+        __m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2 + 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_packus_epi16(_mm_and_si128(r0, low_byte), _mm_and_si128(r1, low_byte)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + n + i),
+                         _mm_packus_epi16(_mm_srli_epi16(r0, 8), _mm_srli_epi16(r1, 8)));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] = src[i * 2];
+        dst[n + i] = src[i * 2 + 1];
+    }
+}
+
+void byte_unshuffle2(const uint8_t* src, uint8_t* dst, size_t n) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= n; i += 16) {
+        __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + n + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2), _mm_unpacklo_epi8(p0, p1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2 + 16), _mm_unpackhi_epi8(p0, p1));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i * 2] = src[i];
+        dst[i * 2 + 1] = src[n + i];
+    }
+}
+
+// n samples of `width` bytes → width byte planes of n bytes (2/4-byte samples have SIMD kernels)
+void byte_shuffle(const uint8_t* src, uint8_t* dst, size_t n, size_t width) {
+    if (width == 4) return byte_shuffle4(src, dst, n);
+    if (width == 2) return byte_shuffle2(src, dst, n);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t k = 0; k < width; k++) dst[k * n + i] = src[i * width + k];
+    }
+}
+
+void byte_unshuffle(const uint8_t* src, uint8_t* dst, size_t n, size_t width) {
+    if (width == 4) return byte_unshuffle4(src, dst, n);
+    if (width == 2) return byte_unshuffle2(src, dst, n);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t k = 0; k < width; k++) dst[i * width + k] = src[k * n + i];
+    }
+}
+
+// m bytes (multiple of 8) → 8 bit planes of m/8 bytes, `stride` bytes apart
+void bit_transpose_plane(const uint8_t* src, size_t m, uint8_t* dst, size_t stride) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    // movemask grabs the top bit of all 16 bytes at once; shifting left brings bit j up there
+    for (; i + 16 <= m; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        for (int j = 0; j < 8; j++) {
+            uint16_t bits = (uint16_t)_mm_movemask_epi8(_mm_sll_epi16(v, _mm_cvtsi32_si128(7 - j)));
+            std::memcpy(dst + j * stride + i / 8, &bits, 2);
+        }
+    }
+#endif
+    for (; i < m; i += 8) {
+        for (int j = 0; j < 8; j++) {
+            uint8_t bits = 0;
+            for (int b = 0; b < 8; b++) bits |= ((src[i + b] >> j) & 1) << b;
+            dst[j * stride + i / 8] = bits;
+        }
+    }
+}
+
+// Inverse of bit_transpose_plane: 8 bit planes `stride` bytes apart → m bytes
+void bit_untranspose_plane(const uint8_t* src, size_t stride, size_t m, uint8_t* dst) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    // 128 bytes per step: transpose the 8 planes × 16 bytes with unpacks so each register holds
+    // [plane0..7 byte t | plane0..7 byte t+1], then movemask pulls bit b out as output bytes 8t+b, 8t+8+b
+    for (; i + 128 <= m; i += 128) {
+        __m128i p[8];
+        for (int j = 0; j < 8; j++) p[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + j * stride + i / 8));
+        __m128i a[8], b[8], c[8];
+        for (int j = 0; j < 4; j++) {
+            a[2 * j] = _mm_unpacklo_epi8(p[2 * j], p[2 * j + 1]);     // bytes 0-7 of the plane pair
+            a[2 * j + 1] = _mm_unpackhi_epi8(p[2 * j], p[2 * j + 1]); // bytes 8-15
+        }
+        for (int h = 0; h < 2; h++) {
+            b[4 * h] = _mm_unpacklo_epi16(a[h], a[2 + h]);         // planes 0-3, bytes 8h+0..3
+            b[4 * h + 1] = _mm_unpackhi_epi16(a[h], a[2 + h]);     // planes 0-3, bytes 8h+4..7
+            b[4 * h + 2] = _mm_unpacklo_epi16(a[4 + h], a[6 + h]); // planes 4-7, bytes 8h+0..3
+            b[4 * h + 3] = _mm_unpackhi_epi16(a[4 + h], a[6 + h]); // planes 4-7, bytes 8h+4..7
+        }
+        for (int q = 0; q < 4; q++) {
+            int lo = (q / 2) * 4 + (q % 2);
+            c[2 * q] = _mm_unpacklo_epi32(b[lo], b[lo + 2]);     // bytes t, t+1 (t = 4q)
+            c[2 * q + 1] = _mm_unpackhi_epi32(b[lo], b[lo + 2]); // bytes t+2, t+3
+        }
+        for (int r = 0; r < 8; r++) {
+            uint8_t* out = dst + i + r * 16;
+            for (int bit = 0; bit < 8; bit++) {
+                int bits = _mm_movemask_epi8(_mm_sll_epi16(c[r], _mm_cvtsi32_si128(7 - bit)));
+                out[bit] = (uint8_t)bits;
+                out[bit + 8] = (uint8_t)(bits >> 8);
+            }
+        }
+    }
+    
+    // Then 16 at a time: 16 bits of each plane as [plane0..7 low bytes | plane0..7 high bytes]
+    const __m128i low_byte = _mm_set1_epi16(0xFF);
+    for (; i + 16 <= m; i += 16) {
+        uint16_t w[8];
+        for (int j = 0; j < 8; j++) std::memcpy(&w[j], src + j * stride + i / 8, 2);
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w));
+        v = _mm_packus_epi16(_mm_and_si128(v, low_byte), _mm_srli_epi16(v, 8));
+        for (int b = 0; b < 8; b++) {
+            int bits = _mm_movemask_epi8(_mm_sll_epi16(v, _mm_cvtsi32_si128(7 - b)));
+            dst[i + b] = (uint8_t)bits;
+            dst[i + b + 8] = (uint8_t)(bits >> 8);
+        }
+    }
+#endif
+    for (; i < m; i += 8) {
+        for (int b = 0; b < 8; b++) {
+            uint8_t value = 0;
+            for (int j = 0; j < 8; j++) value |= ((src[j * stride + i / 8] >> b) & 1) << j;
+            dst[i + b] = value;
+        }
+    }
+}
+
+// scratch: n * width bytes of working space
+void bit_shuffle(const uint8_t* src, uint8_t* dst, size_t n, size_t width, uint8_t* scratch) {
+    size_t m = n & ~(size_t)7;
+    byte_shuffle(src, scratch, m, width);
+    for (size_t k = 0; k < width; k++) {
+        bit_transpose_plane(scratch + k * m, m, dst + k * m, m / 8);
+    }
+    std::memcpy(dst + m * width, src + m * width, (n - m) * width);
+}
+
+void bit_unshuffle(const uint8_t* src, uint8_t* dst, size_t n, size_t width, uint8_t* scratch) {
+    size_t m = n & ~(size_t)7;
+    for (size_t k = 0; k < width; k++) {
+        bit_untranspose_plane(src + k * m, m / 8, m, scratch + k * m);
+    }
+    byte_unshuffle(scratch, dst, m, width);
+    std::memcpy(dst + m * width, src + m * width, (n - m) * width);
+}
+
+// 🔀 SHUFFLE n SAMPLES of `width` bytes into dst (shuffle 0 = plain copy). scratch grows as needed (bit shuffle only)
+void shuffle_samples(uint32_t shuffle, const char* samples, size_t n, size_t width, char* dst,
+                     std::vector<uint8_t>& scratch) {
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(samples);
+    uint8_t* out = reinterpret_cast<uint8_t*>(dst);
+    if (shuffle & HMICAP_FLAG_BIT_SHUFFLE) {
+        scratch.resize(n * width);
+        bit_shuffle(src, out, n, width, scratch.data());
+    } else if (shuffle & HMICAP_FLAG_BYTE_SHUFFLE) {
+        byte_shuffle(src, out, n, width);
+    } else {
+        std::memcpy(out, src, n * width);
+    }
+}
+
+// 🔀 UNDO shuffle_samples: n shuffled samples from src back into dst
+void unshuffle_samples(uint32_t shuffle, const char* src, size_t n, size_t width, char* dst,
+                       std::vector<uint8_t>& scratch) {
+    const uint8_t* in = reinterpret_cast<const uint8_t*>(src);
+    uint8_t* out = reinterpret_cast<uint8_t*>(dst);
+    if (shuffle & HMICAP_FLAG_BIT_SHUFFLE) {
+        scratch.resize(n * width);
+        bit_unshuffle(in, out, n, width, scratch.data());
+    } else if (shuffle & HMICAP_FLAG_BYTE_SHUFFLE) {
+        byte_unshuffle(in, out, n, width);
+    } else {
+        std::memcpy(out, in, n * width);
+    }
+}
+
+uint32_t parse_shuffle_arg(const std::string& text) {
+    if (text == "byte") return HMICAP_FLAG_BYTE_SHUFFLE;
+    if (text == "bit") return HMICAP_FLAG_BIT_SHUFFLE;
+    return 0;
+}
+
+const char* shuffle_name(uint32_t shuffle) {
+    if (shuffle & HMICAP_FLAG_BIT_SHUFFLE) return "bit";
+    if (shuffle & HMICAP_FLAG_BYTE_SHUFFLE) return "byte";
+    return "none";
+}
+
+// 🧬 XOR FLOAT CODEC (HMICAP only) ═════════════════════════════════════════
+// HMICAP_FLAG_XOR: the time-series trick from Gorilla - neighbouring float32 samples share sign,
+// exponent and leading mantissa bits, so each sample is stored as its XOR with the one before.
+// Gorilla picks a leading/trailing-zero window per value, which decodes one bit at a time; here
+// the window is shared by a group of XOR_GROUP values, so a group is a fixed bit width and
+// unpacks with whole-word loads, then a SIMD prefix-XOR turns the deltas back into samples.
+//
+// Block (block_frames frames, channel after channel): per group of XOR_GROUP samples (the last
+// group padded with repeats of the last sample) u8 width, u8 trailing zeros, then XOR_GROUP
+// values of `width` bits = 2 * width bytes; XOR_SLACK_BYTES of zeros end the block. Every block
+// starts from 0 again, so blocks decode independently. Coded blocks vary in size: the block
+// index (u64 coded bytes per block) and an XorFooter follow everything else in the file.
+const size_t XOR_GROUP = 16;
+const size_t XOR_SLACK_BYTES = 8; // The decoder's 8-byte loads may run past the last group
+
+struct XorFooter {
+    uint64_t checksum; // xxh3-64 of the block index
+    uint32_t blocks;
+    char magic[4];     // "HXOR"
+};
+static_assert(sizeof(XorFooter) == 16, "XOR footer is 16 bytes on disk");
+
+void xor_encode_block(const float* samples, size_t frames, int channels, std::vector<char>& out) {
+    out.clear();
+    out.reserve(frames * channels * sizeof(float) + XOR_SLACK_BYTES);
+    uint32_t deltas[XOR_GROUP];
+    for (int ch = 0; ch < channels; ch++) {
+        uint32_t previous = 0;
+        for (size_t first = 0; first < frames; first += XOR_GROUP) {
+            const size_t n = std::min(XOR_GROUP, frames - first);
+            uint32_t any = 0;
+            for (size_t k = 0; k < XOR_GROUP; k++) {
+                uint32_t bits = previous;
+                if (k < n) std::memcpy(&bits, &samples[(first + k) * channels + ch], sizeof(bits));
+                deltas[k] = bits ^ previous;
+                previous = bits;
+                any |= deltas[k];
+            }
+            const int trail = any ? __builtin_ctz(any) : 0;
+            const int width = any ? 32 - __builtin_clz(any) - trail : 0;
+            out.push_back(static_cast<char>(width));
+            out.push_back(static_cast<char>(trail));
+            uint64_t pending = 0;
+            int pending_bits = 0;
+            for (size_t k = 0; k < XOR_GROUP; k++) {
+                pending |= (uint64_t)(deltas[k] >> trail) << pending_bits;
+                for (pending_bits += width; pending_bits >= 8; pending_bits -= 8) {
+                    out.push_back(static_cast<char>(pending & 0xFF));
+                    pending >>= 8;
+                }
+            }
+        }
+    }
+    out.insert(out.end(), XOR_SLACK_BYTES, 0);
+}
+
+// 🧬 Decode one block into channel planes `stride` floats apart (stride >= frames rounded up to
+// XOR_GROUP) - false = corrupt (a group claims more bits than there are or runs off the end)
+bool xor_decode_block(const char* data, size_t size, size_t frames, int channels, float* planes, size_t stride) {
+    if (size < XOR_SLACK_BYTES) return false;
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+    const uint8_t* end = p + size - XOR_SLACK_BYTES;
+    for (int ch = 0; ch < channels; ch++) {
+        uint32_t* out = reinterpret_cast<uint32_t*>(planes + ch * stride);
+        uint32_t previous = 0;
+        for (size_t first = 0; first < frames; first += XOR_GROUP, out += XOR_GROUP) {
+            if (end - p < 2) return false;
+            const unsigned width = p[0], trail = p[1];
+            if (width + trail > 32 || (size_t)(end - p - 2) < 2 * width) return false;
+            p += 2;
+            
+            // Fixed-width unpack: value k sits at bit k * width of the group
+            uint32_t deltas[XOR_GROUP];
+            const uint64_t mask = (1ull << width) - 1;
+            for (size_t k = 0; k < XOR_GROUP; k++) {
+                const size_t bit = k * width;
+                uint64_t word;
+                std::memcpy(&word, p + bit / 8, sizeof(word));
+                deltas[k] = (uint32_t)((word >> (bit % 8)) & mask) << trail;
+            }
+            p += 2 * width;
+            
+            // Prefix XOR: sample k = previous ^ delta 0 ^ ... ^ delta k
+#if defined(__SSE2__)
+            __m128i carry = _mm_set1_epi32((int)previous);
+            for (size_t k = 0; k < XOR_GROUP; k += 4) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(deltas + k));
+                v = _mm_xor_si128(v, _mm_slli_si128(v, 4));
+                v = _mm_xor_si128(v, _mm_slli_si128(v, 8));
+                v = _mm_xor_si128(v, carry);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k), v);
+                carry = _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 3));
+            }
+            previous = out[XOR_GROUP - 1];
+#else
+            for (size_t k = 0; k < XOR_GROUP; k++) out[k] = previous ^= deltas[k];
+#endif
+        }
+    }
+    return true;
+}
+
+// Block index + footer (written after everything else)
+std::vector<char> build_xor_index(const std::vector<uint64_t>& block_sizes) {
+    std::vector<char> index(block_sizes.size() * sizeof(uint64_t));
+    std::memcpy(index.data(), block_sizes.data(), index.size());
+    XorFooter footer;
+    footer.checksum = XXH3_64bits(index.data(), index.size());
+    footer.blocks = block_sizes.size();
+    std::memcpy(footer.magic, "HXOR", 4);
+    const char* bytes = reinterpret_cast<const char*>(&footer);
+    index.insert(index.end(), bytes, bytes + sizeof(footer));
+    return index;
+}
+
+void print_xor_summary(const std::vector<uint64_t>& block_sizes, size_t raw_bytes, std::ostream& log) {
+    uint64_t coded = 0;
+    for (uint64_t size : block_sizes) coded += size;
+    log << "  🧬 XOR-coded " << block_sizes.size() << " blocks: " << raw_bytes / 1024.0 / 1024.0 << " MB → "
+              << coded / 1024.0 / 1024.0 << " MB (" << (double)raw_bytes / coded << "x)\n";
+}
+
+// Header flags describing the payload layout (shuffling only pays off under zstd, zstd already
+// squeezes constant runs down to nothing - and so does the XOR codec)
+uint32_t layout_flags(const ConvertSettings& settings, bool compress) {
+    const bool xor_codec = !compress && settings.xor_codec;
+    return (compress ? settings.shuffle : 0) | (settings.planar ? HMICAP_FLAG_PLANAR : 0) |
+           (settings.checksums ? HMICAP_FLAG_CHECKSUMS : 0) | (settings.overview ? HMICAP_FLAG_OVERVIEW : 0) |
+           (!compress && !xor_codec && settings.runs ? HMICAP_FLAG_RUNS : 0) | (xor_codec ? HMICAP_FLAG_XOR : 0) |
+           (compress && settings.lz4 ? HMICAP_FLAG_LZ4 : 0) | (!compress && settings.page_align ? HMICAP_FLAG_PAGE_ALIGNED : 0);
+}
+
+// 🧱 ONE PAYLOAD BLOCK: interleaved floats → on-disk bytes (planar, packed to the sample format,
+// then shuffled - whichever of those apply - or XOR-coded)
+struct BlockEncoder {
+    uint32_t flags = 0;
+    uint16_t format = SAMPLE_FLOAT32;
+    std::vector<float> planes;
+    std::vector<char> packed;
+    std::vector<uint8_t> scratch;
+    
+    BlockEncoder(uint32_t f, uint16_t sample_format) : flags(f), format(sample_format) {}
+    
+    // Nothing to do: the samples already are the on-disk bytes
+    bool passthrough() const {
+        return !(flags & (HMICAP_SHUFFLE_FLAGS | HMICAP_FLAG_PLANAR | HMICAP_FLAG_XOR)) && format == SAMPLE_FLOAT32;
+    }
+    
+    void encode(const float* samples, size_t frames, int channels, std::vector<char>& out) {
+        if (flags & HMICAP_FLAG_XOR) {
+            xor_encode_block(samples, frames, channels, out);
+            return;
+        }
+        const float* source = samples;
+        size_t count = frames * channels;
+        if (flags & HMICAP_FLAG_PLANAR) {
+            size_t stride = planar_stride(frames);
+            planes.resize(stride * channels);
+            planarize_block(samples, frames, channels, stride, planes.data());
+            source = planes.data();
+            count = planes.size();
+        }
+        const size_t width = sample_bytes(format);
+        const uint32_t shuffle = flags & HMICAP_SHUFFLE_FLAGS;
+        out.resize(count * width);
+        if (!shuffle) {
+            pack_samples(format, source, count, out.data());
+        } else if (format == SAMPLE_FLOAT32) {
+            shuffle_samples(shuffle, reinterpret_cast<const char*>(source), count, width, out.data(), scratch);
+        } else {
+            packed.resize(count * width);
+            pack_samples(format, source, count, packed.data());
+            shuffle_samples(shuffle, packed.data(), count, width, out.data(), scratch);
+        }
+    }
+};
+
+// 🔒 BLOCK CHECKSUMS ════════════════════════════════════════════════════════
+// HMICAP_FLAG_CHECKSUMS: a table of little-endian xxh3-64 hashes follows the payload. Entry 0
+// covers the header (all payload_offset bytes), entry 1 + b covers block b exactly as stored
+// (planar/packed/shuffled), blocks being header.block_frames frames. HMICAP7 compresses the
+// table with everything else - seekable files as one extra frame before the seek table - so
+// `zstd -d` still gives a complete .hmicap.
+
+int64_t block_count(int64_t total_frames, size_t block_frames) {
+    return (total_frames + block_frames - 1) / block_frames;
+}
+
+// Bytes block b takes up in the payload (planar: only the last block pads its planes)
+size_t block_bytes(int64_t total_frames, int channels, size_t width, size_t block_frames, uint32_t flags,
+                   int64_t block) {
+    size_t frames = std::min<int64_t>(block_frames, total_frames - block * (int64_t)block_frames);
+    if (flags & HMICAP_FLAG_PLANAR) frames = planar_stride(frames);
+    return frames * channels * width;
+}
+
+size_t checksum_table_bytes(int64_t total_frames, size_t block_frames, uint32_t flags) {
+    return (flags & HMICAP_FLAG_CHECKSUMS) ? (block_count(total_frames, block_frames) + 1) * sizeof(uint64_t) : 0;
+}
+
+std::vector<char> build_checksum_table(const std::vector<uint64_t>& hashes) {
+    std::vector<char> table;
+    table.reserve(hashes.size() * sizeof(uint64_t));
+    for (uint64_t hash : hashes) {
+        for (int i = 0; i < 8; i++) table.push_back(static_cast<char>((hash >> (8 * i)) & 0xFF));
+    }
+    return table;
+}
+
+// 🔒 Hash the header and every block as it will be stored - blocks are independent, so each
+// worker (own encoder) grabs the next one. Runs alongside the writer, which only needs the
+// table once the payload is out.
+std::vector<uint64_t> payload_checksums(const AudioData& audio, const std::vector<char>& head, uint32_t flags,
+                                        uint16_t format, size_t block_frames) {
+    const int64_t blocks = block_count(audio.total_samples, block_frames);
+    std::vector<uint64_t> hashes(blocks + 1);
+    hashes[0] = XXH3_64bits(head.data(), head.size());
+    std::atomic<int64_t> next_block{0};
+    
+    auto worker = [&]() {
+        BlockEncoder encoder(flags, format);
+        std::vector<char> encoded;
+        int64_t block;
+        while ((block = next_block++) < blocks) {
+            int64_t first = block * (int64_t)block_frames;
+            size_t frames = std::min<int64_t>(block_frames, audio.total_samples - first);
+            const float* samples = audio.interleaved_data.data() + first * audio.channels;
+            if (encoder.passthrough()) {
+                hashes[block + 1] = XXH3_64bits(samples, frames * audio.channels * sizeof(float));
+            } else {
+                encoder.encode(samples, frames, audio.channels, encoded);
+                hashes[block + 1] = XXH3_64bits(encoded.data(), encoded.size());
+            }
+        }
+    };
+    
+    std::vector<std::thread> pool;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 1; i < threads; i++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    return hashes;
+}
+
+// Start payload_checksums on its own thread (no-op without HMICAP_FLAG_CHECKSUMS)
+std::thread start_checksums(const AudioData& audio, const std::vector<char>& head, uint32_t flags, uint16_t format,
+                            size_t block_frames, std::vector<uint64_t>& hashes, std::ostream& log) {
+    if (!(flags & HMICAP_FLAG_CHECKSUMS)) return std::thread();
+    log << "  🔒 xxh3 checksum per " << block_frames << "-frame block (hashed in parallel)\n";
+    return std::thread([&audio, &head, flags, format, block_frames, &hashes]() {
+        hashes = payload_checksums(audio, head, flags, format, block_frames);
+    });
+}
+
+// 📈 OVERVIEW PYRAMID ═══════════════════════════════════════════════════════
+// HMICAP_FLAG_OVERVIEW: per-channel min/max/RMS for every 256, 4096 and 65536 frames, so a
+// waveform or the loud parts of a track come out of a few KB instead of every sample.
+// Section (after the payload and any checksum table):
+//   OverviewHeader, then one OverviewLevelInfo per level, then per level, bucket and channel:
+//   int16 min, int16 max (floor/ceil of x * 32768, saturated), uint16 rms (ceil of rms * 65535)
+// HMICAP7 compresses it as a zstd frame of its own after the samples so it can be read without
+// decompressing them: seekable files list it in the seek table, single-frame files end with an
+// OVERVIEW_LOCATOR skippable frame holding its compressed size.
+const uint32_t OVERVIEW_LEVEL_FRAMES[] = {256, 4096, 65536}; // Each level merges 16 buckets of the one before
+const size_t OVERVIEW_LEVELS = sizeof(OVERVIEW_LEVEL_FRAMES) / sizeof(OVERVIEW_LEVEL_FRAMES[0]);
+const uint32_t OVERVIEW_LOCATOR_MAGIC = 0x184D2A5B; // zstd skippable frame (the seek table uses ...5E)
+
+struct OverviewHeader {
+    char magic[8];     // "HMIOVW01"
+    uint32_t levels;
+    uint32_t channels;
+    uint64_t checksum; // xxh3-64 of everything after this header
+};
+
+struct OverviewLevelInfo {
+    uint32_t bucket_frames;
+    uint32_t reserved;
+    uint64_t buckets;
+};
+
+static_assert(sizeof(OverviewHeader) == 24 && sizeof(OverviewLevelInfo) == 16, "overview layout is fixed");
+
+// Running min/max/sum of squares of one channel over one bucket
+struct OverviewBucket {
+    float min = INFINITY;
+    float max = -INFINITY;
+    double sum_squares = 0.0;
+};
+
+// 📈 Fold frames [first, first + count) of the track into the finest-level buckets (channels per
+// bucket). Any split works - the pipeline feeds it block by block, the whole-track writers split
+// the track across threads on bucket boundaries.
+void overview_scan(const float* samples, int64_t first, size_t count, int channels, OverviewBucket* buckets) {
+    const size_t bucket_frames = OVERVIEW_LEVEL_FRAMES[0];
+    while (count > 0) {
+        const size_t frames = std::min<size_t>(count, bucket_frames - first % bucket_frames);
+        OverviewBucket* bucket = buckets + (first / bucket_frames) * channels;
+        const size_t n = frames * channels;
+        size_t i = 0;
+#if defined(__SSE2__)
+        // 1/2/4 channels: lane l of every 4 samples always holds channel l % channels
+        if (4 % channels == 0 && n >= 4) {
+            __m128 lo = _mm_set1_ps(INFINITY), hi = _mm_set1_ps(-INFINITY), squares = _mm_setzero_ps();
+            for (; i + 4 <= n; i += 4) {
+                __m128 v = _mm_loadu_ps(samples + i);
+                lo = _mm_min_ps(lo, v);
+                hi = _mm_max_ps(hi, v);
+                squares = _mm_add_ps(squares, _mm_mul_ps(v, v));
+            }
+            float lanes_lo[4], lanes_hi[4], lanes_sq[4];
+            _mm_storeu_ps(lanes_lo, lo);
+            _mm_storeu_ps(lanes_hi, hi);
+            _mm_storeu_ps(lanes_sq, squares);
+            for (int lane = 0; lane < 4; lane++) {
+                OverviewBucket& b = bucket[lane % channels];
+                b.min = std::min(b.min, lanes_lo[lane]);
+                b.max = std::max(b.max, lanes_hi[lane]);
+                b.sum_squares += lanes_sq[lane];
+            }
+        }
+#endif
+        for (; i < n; i++) {
+            OverviewBucket& b = bucket[i % channels];
+            b.min = std::min(b.min, samples[i]);
+            b.max = std::max(b.max, samples[i]);
+            b.sum_squares += (double)samples[i] * samples[i];
+        }
+        samples += n;
+        first += frames;
+        count -= frames;
+    }
+}
+
+size_t overview_buckets(int64_t total_frames, size_t level) {
+    return (total_frames + OVERVIEW_LEVEL_FRAMES[level] - 1) / OVERVIEW_LEVEL_FRAMES[level];
+}
+
+size_t overview_section_bytes(int64_t total_frames, int channels, uint32_t flags) {
+    if (!(flags & HMICAP_FLAG_OVERVIEW)) return 0;
+    size_t bytes = sizeof(OverviewHeader) + OVERVIEW_LEVELS * sizeof(OverviewLevelInfo);
+    for (size_t level = 0; level < OVERVIEW_LEVELS; level++) {
+        bytes += overview_buckets(total_frames, level) * channels * 3 * sizeof(int16_t);
+    }
+    return bytes;
+}
+
+// 📈 Finest-level buckets → on-disk section (coarser levels merged from the finer ones)
+std::vector<char> build_overview_section(std::vector<OverviewBucket> buckets, int64_t total_frames, int channels) {
+    std::vector<char> section(overview_section_bytes(total_frames, channels, HMICAP_FLAG_OVERVIEW));
+    OverviewHeader header;
+    std::memcpy(header.magic, "HMIOVW01", 8);
+    header.levels = OVERVIEW_LEVELS;
+    header.channels = channels;
+    
+    char* out = section.data() + sizeof(OverviewHeader) + OVERVIEW_LEVELS * sizeof(OverviewLevelInfo);
+    for (size_t level = 0; level < OVERVIEW_LEVELS; level++) {
+        const size_t count = overview_buckets(total_frames, level);
+        if (level > 0) {
+            // 16 buckets of the level below make one of this level
+            const size_t merge = OVERVIEW_LEVEL_FRAMES[level] / OVERVIEW_LEVEL_FRAMES[level - 1];
+            for (size_t b = 0; b < count; b++) {
+                for (int ch = 0; ch < channels; ch++) {
+                    OverviewBucket merged;
+                    for (size_t k = b * merge; k < std::min(buckets.size() / channels, (b + 1) * merge); k++) {
+                        const OverviewBucket& child = buckets[k * channels + ch];
+                        merged.min = std::min(merged.min, child.min);
+                        merged.max = std::max(merged.max, child.max);
+                        merged.sum_squares += child.sum_squares;
+                    }
+                    buckets[b * channels + ch] = merged;
+                }
+            }
+            buckets.resize(count * channels);
+        }
+        
+        OverviewLevelInfo info = {OVERVIEW_LEVEL_FRAMES[level], 0, count};
+        std::memcpy(section.data() + sizeof(OverviewHeader) + level * sizeof(OverviewLevelInfo), &info, sizeof(info));
+        
+        for (size_t b = 0; b < count; b++) {
+            const int64_t frames = std::min<int64_t>(info.bucket_frames, total_frames - (int64_t)b * info.bucket_frames);
+            for (int ch = 0; ch < channels; ch++) {
+                const OverviewBucket& bucket = buckets[b * channels + ch];
+                int16_t values[3];
+                values[0] = (int16_t)std::max(-32768.0f, std::min(32767.0f, std::floor(bucket.min * 32768.0f)));
+                values[1] = (int16_t)std::max(-32768.0f, std::min(32767.0f, std::ceil(bucket.max * 32768.0f)));
+                uint16_t rms = (uint16_t)std::min(65535.0, std::ceil(std::sqrt(bucket.sum_squares / frames) * 65535.0));
+                std::memcpy(&values[2], &rms, sizeof(rms));
+                std::memcpy(out, values, sizeof(values));
+                out += sizeof(values);
+            }
+        }
+    }
+    
+    header.checksum = XXH3_64bits(section.data() + sizeof(header), section.size() - sizeof(header));
+    std::memcpy(section.data(), &header, sizeof(header));
+    return section;
+}
+
+// 📈 Whole track in memory: threads take bucket-aligned chunks of it
+std::vector<char> compute_overview(const AudioData& audio) {
+    const size_t chunk_frames = (size_t)OVERVIEW_LEVEL_FRAMES[0] * 1024;
+    std::vector<OverviewBucket> buckets(overview_buckets(audio.total_samples, 0) * audio.channels);
+    std::atomic<int64_t> next_chunk{0};
+    
+    auto worker = [&]() {
+        int64_t first;
+        while ((first = next_chunk++ * (int64_t)chunk_frames) < audio.total_samples) {
+            size_t frames = std::min<int64_t>(chunk_frames, audio.total_samples - first);
+            overview_scan(audio.interleaved_data.data() + first * audio.channels, first, frames, audio.channels,
+                          buckets.data());
+        }
+    };
+    
+    std::vector<std::thread> pool;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 1; i < threads; i++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    return build_overview_section(std::move(buckets), audio.total_samples, audio.channels);
+}
+
+void print_overview_levels(std::ostream& log) {
+    log << "  📈 Overview: min/max/RMS every";
+    for (size_t level = 0; level < OVERVIEW_LEVELS; level++) {
+        log << (level ? "/" : " ") << OVERVIEW_LEVEL_FRAMES[level];
+    }
+    log << " frames";
+}
+
+// Start compute_overview on its own thread (no-op without HMICAP_FLAG_OVERVIEW)
+std::thread start_overview(const AudioData& audio, uint32_t flags, std::vector<char>& section, std::ostream& log) {
+    if (!(flags & HMICAP_FLAG_OVERVIEW)) return std::thread();
+    print_overview_levels(log);
+    log << " (computed in parallel)\n";
+    return std::thread([&audio, &section]() { section = compute_overview(audio); });
+}
+
+// ⏸️ CONSTANT RUNS (HMICAP only) ════════════════════════════════════════════
+// HMICAP_FLAG_RUNS: every stretch of at least MIN_RUN_FRAMES bit-identical frames (digital
+// silence, DC offsets) is cut out of the payload. The payload holds only the frames left over
+// ("stored" frames) - blocked, planar/packed and checksummed exactly like a track that long -
+// and a run table follows everything else in the file: per run u64 first frame, u64 frames and
+// one float32 per channel, then a RunFooter at the very end. The player synthesizes the runs.
+// Opt-in (--runs): the magic stays HMICAP01 and players that predate header.flags would read the
+// shortened payload as the whole track, so the default HMICAP keeps every frame.
+const size_t MIN_RUN_FRAMES = 256; // A run entry costs 16 + 4 * channels bytes
+
+struct RunFooter {
+    uint64_t stored_frames;
+    uint64_t checksum; // xxh3-64 of the run entries
+    uint32_t runs;
+    char magic[4];     // "HRUN"
+};
+static_assert(sizeof(RunFooter) == 24, "run footer is 24 bytes on disk");
+
+struct SampleRun {
+    int64_t first;
+    int64_t frames;
+    std::vector<float> value; // One sample per channel
+};
+
+// Leading frames of `frames` (n of them) that equal `value` bit for bit
+size_t count_equal_frames(const float* frames, size_t n, const float* value, int channels) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    // 1/2/4 channels: four samples at a time against the value repeated across the lanes
+    if (4 % channels == 0) {
+        int32_t lanes[4];
+        for (int lane = 0; lane < 4; lane++) std::memcpy(&lanes[lane], &value[lane % channels], 4);
+        const __m128i repeated = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes));
+        const size_t samples = n * channels;
+        size_t k = 0;
+        for (; k + 4 <= samples; k += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(frames + k));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(v, repeated)) != 0xFFFF) break;
+        }
+        i = k / channels;
+    }
+#endif
+    for (; i < n && std::memcmp(frames + i * channels, value, channels * sizeof(float)) == 0; i++) {
+    }
+    return i;
+}
+
+// First frame in [from, n) that equals the frame before it (n if none)
+size_t find_repeated_frame(const float* frames, size_t from, size_t n, int channels) {
+    size_t k = from * channels;
+    const size_t samples = n * channels;
+    while (k < samples) {
+#if defined(__SSE2__)
+        // Skip four samples at a time while none of them matches the sample one frame earlier
+        for (; k + 4 <= samples; k += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(frames + k));
+            __m128i before = _mm_loadu_si128(reinterpret_cast<const __m128i*>(frames + k - channels));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(v, before))) break;
+        }
+        if (k >= samples) break;
+#endif
+        size_t frame = k / channels;
+        if (std::memcmp(frames + frame * channels, frames + (frame - 1) * channels, channels * sizeof(float)) == 0) {
+            return frame;
+        }
+        k = (frame + 1) * channels;
+    }
+    return n;
+}
+
+// ⏸️ STREAMING RUN SPLITTER: feed the track in pieces of any size; runs land in `runs`, every
+// other frame (in order) in `stored` for the caller to take block by block. The frames of a
+// run-to-be are all the same, so nothing has to be buffered while deciding whether it grows
+// long enough - only counted.
+struct RunSplitter {
+    int channels;
+    std::vector<SampleRun> runs;
+    std::vector<float> stored;   // Stored frames not taken yet
+    int64_t stored_frames = 0;   // Stored frames so far
+    int64_t position = 0;        // Frames fed so far
+    int64_t pending = 0;         // Trailing frames equal to `value`, not yet stored or cut
+    int64_t carried = 0;         // ...of which came from earlier pieces
+    std::vector<float> value;
+    
+    explicit RunSplitter(int channels) : channels(channels), value(channels) {}
+    
+    void store(const float* frames, size_t n) {
+        stored.insert(stored.end(), frames, frames + n * channels);
+        stored_frames += n;
+    }
+    
+    void store_copies(int64_t n) {
+        for (int64_t i = 0; i < n; i++) stored.insert(stored.end(), value.begin(), value.end());
+        stored_frames += n;
+    }
+    
+    // The candidate ends: cut it out if it's long enough, else it stays in the payload
+    void close_candidate(const float* frames, size_t& stored_from, size_t end) {
+        if (pending >= (int64_t)MIN_RUN_FRAMES) {
+            store(frames + stored_from * channels, end - (size_t)(pending - carried) - stored_from);
+            runs.push_back({position + (int64_t)end - pending, pending, value});
+            stored_from = end;
+        } else {
+            store_copies(carried);
+        }
+        pending = carried = 0;
+    }
+    
+    void feed(const float* frames, size_t n) {
+        size_t i = 0, stored_from = 0;
+        while (i < n) {
+            if (pending > 0) {
+                size_t same = count_equal_frames(frames + i * channels, n - i, value.data(), channels);
+                pending += same;
+                i += same;
+                if (i == n) break;
+                close_candidate(frames, stored_from, i);
+            }
+            // Frames that differ from their predecessor can't start a run - jump to the next repeat
+            size_t repeat = find_repeated_frame(frames, i + 1, n, channels);
+            std::memcpy(value.data(), frames + (repeat - 1) * channels, channels * sizeof(float));
+            pending = 1;
+            i = repeat;
+        }
+        store(frames + stored_from * channels, n - (size_t)(pending - carried) - stored_from);
+        carried = pending;
+        position += n;
+    }
+    
+    void finish() {
+        size_t stored_from = 0;
+        close_candidate(nullptr, stored_from, 0);
+    }
+    
+    // Move the next block_frames stored frames (or whatever is left, once finished) into `block`
+    bool take_block(size_t block_frames, bool finished, std::vector<float>& block) {
+        size_t available = stored.size() / channels;
+        if (available == 0 || (!finished && available < block_frames)) return false;
+        size_t frames = std::min(available, block_frames);
+        block.assign(stored.begin(), stored.begin() + frames * channels);
+        stored.erase(stored.begin(), stored.begin() + frames * channels);
+        return true;
+    }
+};
+
+// ⏸️ Run entries + footer. Run values go through the sample format and back, so a synthesized run
+// sounds exactly like the stored frames around it would have.
+std::vector<char> build_run_table(const RunSplitter& splitter, uint16_t format) {
+    const int channels = splitter.channels;
+    std::vector<char> table;
+    std::vector<char> packed(channels * sample_bytes(format));
+    std::vector<float> value(channels);
+    for (const auto& run : splitter.runs) {
+        pack_samples(format, run.value.data(), channels, packed.data());
+        expand_samples(format, packed.data(), channels, value.data());
+        const char* first = reinterpret_cast<const char*>(&run.first);
+        const char* frames = reinterpret_cast<const char*>(&run.frames);
+        table.insert(table.end(), first, first + sizeof(run.first));
+        table.insert(table.end(), frames, frames + sizeof(run.frames));
+        table.insert(table.end(), reinterpret_cast<const char*>(value.data()),
+                     reinterpret_cast<const char*>(value.data() + channels));
+    }
+    
+    RunFooter footer;
+    footer.stored_frames = splitter.stored_frames;
+    footer.checksum = XXH3_64bits(table.data(), table.size());
+    footer.runs = splitter.runs.size();
+    std::memcpy(footer.magic, "HRUN", 4);
+    const char* bytes = reinterpret_cast<const char*>(&footer);
+    table.insert(table.end(), bytes, bytes + sizeof(footer));
+    return table;
+}
+
+void print_run_summary(const RunSplitter& splitter, int sample_rate, size_t frame_bytes, std::ostream& log) {
+    int64_t cut = splitter.position - splitter.stored_frames;
+    log << "  ⏸️  " << splitter.runs.size() << " constant runs cut out: " << cut << " frames ("
+              << (double)cut / sample_rate << " s, " << cut * frame_bytes / 1024.0 / 1024.0
+              << " MB) synthesized on playback\n";
+}
+
+// ⏱️ PARSE "90", "90.5" or "1:30.5" INTO SECONDS
+bool parse_time_arg(const std::string& text, double& seconds) {
+    size_t colon = text.find(':');
+    char* end = nullptr;
+    
+    if (colon == std::string::npos) {
+        seconds = std::strtod(text.c_str(), &end);
+        return end && *end == '\0' && !text.empty() && seconds >= 0.0;
+    }
+    
+    std::string min_part = text.substr(0, colon);
+    std::string sec_part = text.substr(colon + 1);
+    long minutes = std::strtol(min_part.c_str(), &end, 10);
+    if (min_part.empty() || *end != '\0' || minutes < 0) return false;
+    double secs = std::strtod(sec_part.c_str(), &end);
+    if (sec_part.empty() || *end != '\0' || secs < 0.0) return false;
+    
+    seconds = minutes * 60.0 + secs;
+    return true;
+}
+
+// ✂️ TURN --start/--end SECONDS INTO A [start, end) FRAME RANGE
+// total_frames < 0 means the length is unknown (MP3); end_frame < 0 then means "until EOF"
+bool resolve_frame_range(const ConvertSettings& settings, int sample_rate, int64_t total_frames,
+                         int64_t& start_frame, int64_t& end_frame, std::ostream& log) {
+    start_frame = std::llround(settings.start_seconds * sample_rate);
+    end_frame = settings.end_seconds < 0.0 ? total_frames
+                                           : std::llround(settings.end_seconds * sample_rate);
+    
+    if (total_frames >= 0 && (end_frame < 0 || end_frame > total_frames)) {
+        end_frame = total_frames;
+    }
+    
+    if (total_frames >= 0 && start_frame >= total_frames) {
+        std::cerr << "❌ Start time " << settings.start_seconds << "s is past the end of the track ("
+                  << (float)total_frames / sample_rate << "s)\n";
+        return false;
+    }
+    
+    if (end_frame >= 0 && end_frame <= start_frame) {
+        std::cerr << "❌ Empty time range (end must be after start)\n";
+        return false;
+    }
+    
+    if (start_frame > 0 || settings.end_seconds >= 0.0) {
+        log << "  ✂️  Excerpt: frames " << start_frame << " → "
+                  << (end_frame < 0 ? std::string("end") : std::to_string(end_frame)) << "\n";
+    }
+    
+    return true;
+}
+
+// 🔁 TRANSCODE SOURCES ═════════════════════════════════════════════════════
+// HMICA and HMICA7 (the text formats of hmica/) and HMICAP/HMICAP7 read back as sources, so any
+// of the four converts into any other without going back to the original audio. Inputs are
+// mapped, never loaded whole: compressed ones decompress only as far as the next block needs,
+// and the samples come out block by block through read_source_frames like MP3 frames do.
+const uint32_t LZ4_FRAME_MAGIC = 0x184D2204;
+
+// 🗺️ WHOLE INPUT FILE, MAPPED READ-ONLY (or, after narrow(), one track of a mapped pack)
+struct InputMapping {
+    const char* data = nullptr;
+    size_t size = 0;
+    const char* base = nullptr; // The mapping itself (data/size may be a window into it)
+    size_t mapped = 0;
+    
+    InputMapping() = default;
+    InputMapping(const InputMapping&) = delete;
+    InputMapping& operator=(const InputMapping&) = delete;
+    ~InputMapping() {
+        if (base) munmap(const_cast<char*>(base), mapped);
+    }
+    
+    bool open(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        struct stat info;
+        void* region = fstat(fd, &info) == 0 && info.st_size > 0
+                           ? mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0)
+                           : MAP_FAILED;
+        close(fd);
+        if (region == MAP_FAILED) return false;
+        base = static_cast<const char*>(region);
+        mapped = info.st_size;
+        narrow(0, mapped);
+        return true;
+    }
+    
+    // Only [offset, offset + length) gets read, front to back (the caller checked it's in the file)
+    void narrow(uint64_t offset, uint64_t length) {
+        data = base + offset;
+        size = length;
+        const size_t page = sysconf(_SC_PAGESIZE);
+        const size_t lead = offset % page;
+        madvise(const_cast<char*>(data - lead), size + lead, MADV_SEQUENTIAL);
+    }
+};
+
+// 🌀 A MAPPED zstd/LZ4 FILE, DECOMPRESSED ON DEMAND: peek()/consume() walk the decompressed bytes
+// one output buffer at a time. zstd runs straight on across frame boundaries (seekable and
+// multi-frame files) and steps over skippable frames; LZ4 ends with its first frame (anything
+// after it is the overview).
+class CompressedStream {
+public:
+    CompressedStream() = default;
+    CompressedStream(const CompressedStream&) = delete;
+    CompressedStream& operator=(const CompressedStream&) = delete;
+    ~CompressedStream() {
+        ZSTD_freeDCtx(zstd);
+#if HMICAP_HAVE_LZ4
+        if (lz4) LZ4F_freeDecompressionContext(lz4);
+#endif
+    }
+    
+    // Start at the frame at `data` - false if it's neither zstd nor LZ4 (or LZ4 in a build without it)
+    bool open(const char* data, size_t size) {
+        uint32_t magic = 0;
+        if (size >= sizeof(magic)) std::memcpy(&magic, data, sizeof(magic));
+        if (magic == LZ4_FRAME_MAGIC) {
+#if HMICAP_HAVE_LZ4
+            if (LZ4F_isError(LZ4F_createDecompressionContext(&lz4, LZ4F_VERSION))) return false;
+#else
+            std::cerr << "❌ LZ4 input, but this converter was built without LZ4 (-DHMICAP_WITH_LZ4)\n";
+            return false;
+#endif
+        } else if (magic == ZSTD_MAGICNUMBER) {
+            zstd = ZSTD_createDCtx();
+        } else {
+            return false;
+        }
+        input = data;
+        input_size = size;
+        buffer.resize(ZSTD_DStreamOutSize());
+        return true;
+    }
+    
+    bool is_lz4() const {
+#if HMICAP_HAVE_LZ4
+        return lz4 != nullptr;
+#else
+        return false;
+#endif
+    }
+    
+    bool failed() const { return broken; }
+    
+    // Decompressed bytes ready to look at - false at the end of the data (or when it's corrupt)
+    bool peek(const char*& data, size_t& size) {
+        if (pending == filled && !refill()) return false;
+        data = buffer.data() + pending;
+        size = filled - pending;
+        return true;
+    }
+    
+    void consume(size_t size) { pending += size; }
+    
+    // Exactly `size` bytes into `out` - false if the data ends first
+    bool read(char* out, size_t size) {
+        const char* data;
+        size_t available;
+        while (size > 0 && peek(data, available)) {
+            size_t n = std::min(size, available);
+            std::memcpy(out, data, n);
+            consume(n);
+            out += n;
+            size -= n;
+        }
+        return size == 0;
+    }
+
+private:
+    bool refill() {
+        pending = filled = 0;
+        while (filled == 0 && !broken && (input_pos < input_size || more)) {
+            size_t consumed = 0;
+            if (zstd) {
+                ZSTD_inBuffer in = {input, input_size, input_pos};
+                ZSTD_outBuffer out = {buffer.data(), buffer.size(), 0};
+                broken = ZSTD_isError(ZSTD_decompressStream(zstd, &out, &in));
+                consumed = in.pos - input_pos;
+                filled = out.pos;
+            }
+#if HMICAP_HAVE_LZ4
+            else {
+                size_t out = buffer.size();
+                consumed = input_size - input_pos;
+                size_t hint = LZ4F_decompress(lz4, buffer.data(), &out, input + input_pos, &consumed, nullptr);
+                broken = LZ4F_isError(hint);
+                filled = broken ? 0 : out;
+                if (hint == 0) input_size = input_pos + consumed; // First frame done
+            }
+#endif
+            input_pos += consumed;
+            more = filled == buffer.size(); // A full buffer may leave output held back in the context
+            if (consumed == 0 && filled == 0) break; // No progress: the data ends mid-frame
+        }
+        return filled > 0;
+    }
+    
+    ZSTD_DCtx* zstd = nullptr;
+#if HMICAP_HAVE_LZ4
+    LZ4F_dctx* lz4 = nullptr;
+#endif
+    const char* input = nullptr;
+    size_t input_size = 0;
+    size_t input_pos = 0;
+    std::vector<char> buffer;
+    size_t pending = 0; // First byte of `buffer` not consumed yet
+    size_t filled = 0;
+    bool more = false;
+    bool broken = false;
+};
+
+// 💾 HMICAP/HMICAP7 AS A SOURCE: stored blocks come out of the mapping (HMICAP) or the
+// decompressed stream (HMICAP7), are checked against the checksum table, then unshuffled,
+// expanded and interleaved - or XOR-decoded - the way the player does it. Cut-out constant runs
+// are synthesized back in between them.
+struct HmicapSource {
+    InputMapping file;
+    std::unique_ptr<CompressedStream> stream; // HMICAP7 (nullptr = HMICAP, straight from the mapping)
+    HMICAPHeader header;
+    std::vector<char> head;           // HMICAP7: all payload_offset header bytes (checksum entry 0)
+    int channels = 0;
+    size_t width = sizeof(float);
+    size_t block_frames = 0;          // Stored frames per block (PAYLOAD_BLOCK_FRAMES for unblocked files)
+    int64_t stored_frames = 0;
+    int64_t blocks = 0;
+    int64_t next_block = 0;
+    const char* payload = nullptr;    // HMICAP: first payload byte in the mapping
+    size_t payload_pos = 0;           // HMICAP: where the next block starts in it
+    const char* checksums = nullptr;  // HMICAP: the checksum table in the mapping (nullptr = none)
+    std::vector<uint64_t> hashes;     // HMICAP7: blocks hashed so far, checked once the table arrives
+    std::vector<uint64_t> xor_starts; // HMICAP_FLAG_XOR: where each coded block starts, then where it ends
+    std::vector<SampleRun> runs;
+    size_t next_run = 0;
+    int64_t position = 0;             // Track frame of the next frame read
+    std::vector<float> block;         // Current block, interleaved
+    size_t block_used = 0;
+    size_t block_length = 0;
+    std::vector<char> stored;
+    std::vector<char> unshuffled;
+    std::vector<float> planes;
+    std::vector<uint8_t> scratch;
+    bool failed = false;
+};
+
+bool hmicap_source_error(HmicapSource& in, const std::string& message) {
+    std::cerr << "❌ " << message << "\n";
+    in.failed = true;
+    return false;
+}
+
+uint64_t checksum_entry(const char* table, int64_t index) {
+    uint64_t hash;
+    std::memcpy(&hash, table + index * sizeof(hash), sizeof(hash));
+    return hash;
+}
+
+// Next stored block into in.block - false after the last one (or on a bad block)
+bool next_hmicap_block(HmicapSource& in) {
+    if (in.failed || in.next_block >= in.blocks) return false;
+    const int64_t b = in.next_block++;
+    const uint32_t flags = in.header.flags;
+    const size_t frames = std::min<int64_t>(in.block_frames, in.stored_frames - b * (int64_t)in.block_frames);
+    const size_t size = (flags & HMICAP_FLAG_XOR)
+                            ? in.xor_starts[b + 1] - in.xor_starts[b]
+                            : block_bytes(in.stored_frames, in.channels, in.width, in.block_frames, flags, b);
+    
+    const char* bytes = in.payload + in.payload_pos;
+    if (in.stream) {
+        in.stored.resize(size);
+        if (!in.stream->read(in.stored.data(), size)) {
+            return hmicap_source_error(in, "Compressed input is corrupt or truncated (block " + std::to_string(b) + ")");
+        }
+        bytes = in.stored.data();
+    }
+    in.payload_pos += size;
+    
+    // 🔒 Blocks as stored; HMICAP7's table only comes after the last one
+    if (flags & HMICAP_FLAG_CHECKSUMS) {
+        uint64_t hash = XXH3_64bits(bytes, size);
+        if (in.stream) {
+            in.hashes.push_back(hash);
+        } else if (hash != checksum_entry(in.checksums, 1 + b)) {
+            return hmicap_source_error(in, "Block " + std::to_string(b) + " checksum mismatch - the input is corrupt");
+        }
+    }
+    
+    in.block.resize(frames * in.channels);
+    if (flags & HMICAP_FLAG_XOR) {
+        const size_t stride = planar_stride(in.block_frames);
+        in.planes.resize(stride * in.channels);
+        if (!xor_decode_block(bytes, size, frames, in.channels, in.planes.data(), stride)) {
+            return hmicap_source_error(in, "XOR block " + std::to_string(b) + " is corrupt");
+        }
+        interleave_planes(in.planes.data(), stride, in.channels, frames, in.block.data());
+    } else {
+        const uint32_t shuffle = flags & HMICAP_SHUFFLE_FLAGS;
+        if (shuffle) {
+            in.unshuffled.resize(size);
+            unshuffle_samples(shuffle, bytes, size / in.width, in.width, in.unshuffled.data(), in.scratch);
+            bytes = in.unshuffled.data();
+        }
+        if (flags & HMICAP_FLAG_PLANAR) {
+            const size_t stride = planar_stride(frames);
+            in.planes.resize(stride * in.channels);
+            expand_samples(in.header.sample_format, bytes, in.planes.size(), in.planes.data());
+            interleave_planes(in.planes.data(), stride, in.channels, frames, in.block.data());
+        } else {
+            expand_samples(in.header.sample_format, bytes, in.block.size(), in.block.data());
+        }
+    }
+    
+    if (in.stream && (flags & HMICAP_FLAG_CHECKSUMS) && in.next_block == in.blocks) {
+        std::vector<char> table((in.blocks + 1) * sizeof(uint64_t));
+        if (!in.stream->read(table.data(), table.size())) {
+            return hmicap_source_error(in, "Compressed input ends before its checksum table");
+        }
+        if (checksum_entry(table.data(), 0) != XXH3_64bits(in.head.data(), in.head.size())) {
+            return hmicap_source_error(in, "Header checksum mismatch - the input is corrupt");
+        }
+        for (int64_t i = 0; i < in.blocks; i++) {
+            if (checksum_entry(table.data(), 1 + i) != in.hashes[i]) {
+                return hmicap_source_error(in, "Block " + std::to_string(i) + " checksum mismatch - the input is corrupt");
+            }
+        }
+    }
+    
+    in.block_used = 0;
+    in.block_length = frames;
+    return true;
+}
+
+// Up to max_frames interleaved frames, runs synthesized in place (fewer = end of the track or an error)
+size_t read_hmicap_frames(HmicapSource& in, float* out, size_t max_frames) {
+    const int channels = in.channels;
+    size_t done = 0;
+    while (done < max_frames && !in.failed) {
+        if (in.next_run < in.runs.size() && in.position >= in.runs[in.next_run].first) {
+            const SampleRun& run = in.runs[in.next_run];
+            const size_t n = std::min<int64_t>(max_frames - done, run.first + run.frames - in.position);
+            for (size_t i = 0; i < n; i++) {
+                std::memcpy(out + (done + i) * channels, run.value.data(), channels * sizeof(float));
+            }
+            done += n;
+            in.position += n;
+            if (in.position == run.first + run.frames) in.next_run++;
+            continue;
+        }
+        if (in.block_used == in.block_length && !next_hmicap_block(in)) break;
+        
+        int64_t n = std::min<int64_t>(max_frames - done, in.block_length - in.block_used);
+        if (in.next_run < in.runs.size()) n = std::min<int64_t>(n, in.runs[in.next_run].first - in.position);
+        std::memcpy(out + done * channels, in.block.data() + in.block_used * channels, n * channels * sizeof(float));
+        in.block_used += n;
+        done += n;
+        in.position += n;
+    }
+    return done;
+}
+
+// 📜 HMICA TEXT, PIECE BY PIECE: straight out of the mapping (HMICA) or a CompressedStream (HMICA7)
+struct TextFeed {
+    const char* text = nullptr; // HMICA: what's left of the text
+    size_t size = 0;
+    std::unique_ptr<CompressedStream> stream;
+    
+    bool peek(const char*& data, size_t& n) {
+        if (stream) return stream->peek(data, n);
+        data = text;
+        n = size;
+        return n > 0;
+    }
+    
+    void consume(size_t n) {
+        if (stream) {
+            stream->consume(n);
+        } else {
+            text += n;
+            size -= n;
+        }
+    }
+    
+    bool failed() const { return stream && stream->failed(); }
+    
+    // Move past the first `tag` - false if the text ends first
+    bool skip_past(const std::string& tag) {
+        std::string tail; // Last bytes of the previous piece (the tag may straddle two)
+        const char* data;
+        size_t n;
+        while (peek(data, n)) {
+            if (!tail.empty()) {
+                std::string joined = tail + std::string(data, std::min(n, tag.size() - 1));
+                size_t hit = joined.find(tag);
+                if (hit != std::string::npos) {
+                    consume(hit + tag.size() - tail.size());
+                    return true;
+                }
+            }
+            const char* hit = std::search(data, data + n, tag.begin(), tag.end());
+            if (hit != data + n) {
+                consume(hit - data + tag.size());
+                return true;
+            }
+            size_t keep = std::min(n, tag.size() - 1);
+            tail.assign(data + n - keep, keep);
+            consume(n);
+        }
+        return false;
+    }
+};
+
+// 🎨 ONE HMICA CHANNEL, PARSED AS IT'S READ: tokens "v" or "first-last=v", comma separated.
+// Same rules as hmica/play.cpp - a run fills first..last, samples it jumps over stay silent and
+// so does everything past the closing brace - but only as much text as the read needs is parsed.
+struct HmicaChannel {
+    TextFeed text;
+    std::string tag;         // "C<n>{", looked for on the first read
+    bool positioned = false;
+    bool ended = false;      // Closing brace (or the end of the text) reached
+    std::string error;       // What's wrong with the text (reported after the read)
+    int64_t next = 0;        // Sample index of the next value read
+    int64_t silent = 0;      // Zeros to hand out first...
+    int64_t repeat = 0;      // ...then this many copies of value
+    float value = 0.0f;
+    std::string token;
+    
+    // Next token into silent/repeat - false at the end of the channel (or on an error)
+    bool parse_next() {
+        while (!ended) {
+            token.clear();
+            bool delimited = false;
+            const char* data;
+            size_t n;
+            while (!delimited && text.peek(data, n)) {
+                size_t i = 0;
+                while (i < n && data[i] != ',' && data[i] != '}') i++;
+                token.append(data, i);
+                if (i < n) {
+                    delimited = true;
+                    ended = data[i] == '}';
+                    text.consume(i + 1);
+                } else {
+                    text.consume(n);
+                }
+            }
+            if (!delimited) ended = true;
+            if (text.failed()) {
+                error = "HMICA7 text is corrupt (zstd)";
+                return false;
+            }
+            
+            token.erase(std::remove_if(token.begin(), token.end(), ::isspace), token.end());
+            if (token.empty()) continue;
+            
+            const char* start = token.c_str();
+            char* end = nullptr;
+            size_t dash = token.find('-');
+            size_t eq = token.find('=');
+            if (dash != std::string::npos && eq != std::string::npos) {
+                int64_t first = std::strtoll(start, &end, 10);
+                bool ok = end == start + dash;
+                int64_t last = std::strtoll(start + dash + 1, &end, 10);
+                ok = ok && end == start + eq && first >= 0 && last >= first;
+                value = std::strtof(start + eq + 1, &end);
+                if (!ok || *end != '\0') return bad_token();
+                silent = std::max<int64_t>(0, first - next);
+                repeat = std::max<int64_t>(0, last + 1 - std::max(first, next));
+            } else {
+                value = std::strtof(start, &end);
+                if (end == start || *end != '\0') return bad_token();
+                silent = 0;
+                repeat = 1;
+            }
+            return true;
+        }
+        return false;
+    }
+    
+    bool bad_token() {
+        error = "bad token \"" + token.substr(0, 40) + "\"";
+        return false;
+    }
+    
+    void read(float* out, size_t count) {
+        if (!positioned) {
+            positioned = true;
+            if (!text.skip_past(tag)) {
+                ended = true;
+                error = tag + " not found";
+            }
+        }
+        size_t i = 0;
+        while (i < count) {
+            if (silent == 0 && repeat == 0 && (!error.empty() || !parse_next())) {
+                std::fill(out + i, out + count, 0.0f);
+                break;
+            }
+            int64_t& left = silent > 0 ? silent : repeat;
+            const float sample = silent > 0 ? 0.0f : value;
+            const size_t n = std::min<int64_t>(left, count - i);
+            std::fill(out + i, out + i + n, sample);
+            left -= n;
+            next += n;
+            i += n;
+        }
+    }
+};
+
+// 📜 HMICA/HMICA7 AS A SOURCE: one cursor per channel (the text is channel-major), all of them
+// parsing in parallel, one thread per channel per read
+struct HmicaSource {
+    InputMapping file;
+    std::vector<HmicaChannel> channels;
+    std::vector<float> planes; // One plane per channel, interleaved once every channel has its part
+    bool failed = false;
+};
+
+size_t read_hmica_frames(HmicaSource& in, float* out, size_t frames) {
+    const int channels = in.channels.size();
+    in.planes.resize(frames * channels);
+    std::vector<std::thread> workers;
+    for (int ch = 1; ch < channels; ch++) {
+        workers.emplace_back([&in, ch, frames]() { in.channels[ch].read(in.planes.data() + ch * frames, frames); });
+    }
+    in.channels[0].read(in.planes.data(), frames);
+    for (auto& worker : workers) worker.join();
+    
+    for (int ch = 0; ch < channels; ch++) {
+        if (!in.channels[ch].error.empty()) {
+            std::cerr << "❌ Channel " << ch + 1 << ": " << in.channels[ch].error << "\n";
+            in.failed = true;
+            return 0;
+        }
+    }
+    interleave_planes(in.planes.data(), frames, channels, frames, out);
+    return frames;
+}
+
+// 📦 TRACK PACKS ═══════════════════════════════════════════════════════════
+// A .hmipack holds many HMICAP/HMICAP7 tracks back to back, each the unchanged file image on its
+// own PACK_ALIGN boundary (page-aligned payloads and O_DIRECT reads still line up inside it).
+// The index fills the first pages: header, fixed-size entries sorted by name, then the names.
+// Map it and one binary search reaches any track; "library.hmipack:NAME" names a packed track
+// wherever an input path goes.
+const size_t PACK_ALIGN = 4096;
+const char* PACK_EXTENSION = ".hmipack";
+
+struct PackHeader {
+    char magic[8];           // "HMIPACK1"
+    uint32_t flags;          // None defined yet (readers refuse unknown ones)
+    uint32_t tracks;
+    uint64_t index_bytes;    // Entries + name table, right after this header
+    uint64_t index_checksum; // xxh3 of those index_bytes
+    uint64_t data_offset;    // First track (PACK_ALIGN-aligned: the index pages end here)
+    uint64_t pack_bytes;     // Whole file - a shorter one was cut off
+    uint8_t reserved[16];
+};
+static_assert(sizeof(PackHeader) == 64, "pack header is 64 bytes on disk");
+
+const uint16_t PACK_TRACK_HMICAP = 0;
+const uint16_t PACK_TRACK_HMICAP7 = 1;
+
+struct PackEntry {
+    uint64_t offset;        // Track image in the pack (PACK_ALIGN-aligned)
+    uint64_t length;        // Track image bytes
+    uint64_t total_samples; // Per channel
+    uint32_t sample_rate;
+    uint16_t channels;
+    uint16_t format;        // PACK_TRACK_HMICAP / PACK_TRACK_HMICAP7
+    uint32_t header_flags;  // The track's own header.flags (seekable, LZ4, ...)
+    uint32_t name_offset;   // Into the name table (names aren't NUL-terminated)
+    uint32_t name_length;
+    uint32_t reserved;
+};
+static_assert(sizeof(PackEntry) == 48, "pack entry is 48 bytes on disk");
+
+inline uint64_t pack_align_up(uint64_t offset) {
+    return (offset + PACK_ALIGN - 1) / PACK_ALIGN * PACK_ALIGN;
+}
+
+// "library.hmipack:Artist/Song" → "library.hmipack" + "Artist/Song" (false for any other path)
+bool split_pack_path(const std::string& path, std::string& pack, std::string& track) {
+    std::string lower = path;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    size_t at = lower.find(std::string(PACK_EXTENSION) + ":");
+    if (at == std::string::npos) return false;
+    pack = path.substr(0, at + std::strlen(PACK_EXTENSION));
+    track = path.substr(at + std::strlen(PACK_EXTENSION) + 1);
+    return true;
+}
+
+// 🔍 THE INDEX OF A MAPPED PACK, read in place (entries sit 8-aligned right after the header)
+struct PackIndex {
+    const PackHeader* header = nullptr;
+    const PackEntry* entries = nullptr;
+    const char* names = nullptr;
+    
+    // False (after saying why) unless the header, checksum and every entry add up
+    bool parse(const char* data, size_t size) {
+        header = reinterpret_cast<const PackHeader*>(data);
+        const char* problem = nullptr;
+        if (size < sizeof(PackHeader) || std::memcmp(header->magic, "HMIPACK1", 8) != 0) {
+            problem = "bad magic number";
+        } else if (header->flags != 0) {
+            problem = "written by a newer converter";
+        } else if (header->pack_bytes != size) {
+            problem = "truncated";
+        } else if (header->index_bytes > size - sizeof(PackHeader) ||
+                   (uint64_t)header->tracks * sizeof(PackEntry) > header->index_bytes ||
+                   header->data_offset < sizeof(PackHeader) + header->index_bytes || header->data_offset > size) {
+            problem = "index out of bounds";
+        } else if (XXH3_64bits(data + sizeof(PackHeader), header->index_bytes) != header->index_checksum) {
+            problem = "index checksum mismatch";
+        }
+        entries = reinterpret_cast<const PackEntry*>(data + sizeof(PackHeader));
+        names = reinterpret_cast<const char*>(entries + (problem ? 0 : header->tracks));
+        const uint64_t name_bytes = problem ? 0 : header->index_bytes - header->tracks * sizeof(PackEntry);
+        for (uint32_t i = 0; !problem && i < header->tracks; i++) {
+            const PackEntry& entry = entries[i];
+            if (entry.offset % PACK_ALIGN || entry.offset < header->data_offset || entry.length > size - entry.offset ||
+                entry.format > PACK_TRACK_HMICAP7 || entry.name_offset > name_bytes ||
+                entry.name_length > name_bytes - entry.name_offset || (i > 0 && !less(entries[i - 1], entry))) {
+                problem = "bad track entry";
+            }
+        }
+        if (problem) {
+            std::cerr << "❌ Invalid pack (" << problem << ")\n";
+            return false;
+        }
+        return true;
+    }
+    
+    std::string name(const PackEntry& entry) const {
+        return std::string(names + entry.name_offset, entry.name_length);
+    }
+    
+    // Byte order, shorter first on a tie - the order std::string sorts the names in when packing
+    bool less(const PackEntry& entry, const char* name, size_t length) const {
+        int order = std::memcmp(names + entry.name_offset, name, std::min<size_t>(entry.name_length, length));
+        return order < 0 || (order == 0 && entry.name_length < length);
+    }
+    
+    bool less(const PackEntry& a, const PackEntry& b) const {
+        return less(a, names + b.name_offset, b.name_length);
+    }
+    
+    const PackEntry* find(const std::string& track) const {
+        const PackEntry* end = entries + header->tracks;
+        const PackEntry* entry = std::lower_bound(entries, end, track, [this](const PackEntry& e, const std::string& name) {
+            return less(e, name.data(), name.size());
+        });
+        return entry != end && entry->name_length == track.size() &&
+                       std::memcmp(names + entry->name_offset, track.data(), track.size()) == 0
+                   ? entry
+                   : nullptr;
+    }
+};
+
+// 📋 One line per track: name, format, rate, channels, length, size
+void print_pack_index(const PackIndex& pack) {
+    for (uint32_t i = 0; i < pack.header->tracks; i++) {
+        const PackEntry& entry = pack.entries[i];
+        std::cout << "  🎵 " << std::left << std::setw(40) << pack.name(entry) << std::right
+                  << std::setw(8) << (entry.format == PACK_TRACK_HMICAP7 ? "HMICAP7" : "HMICAP")
+                  << std::setw(7) << entry.sample_rate << " Hz " << entry.channels << " ch "
+                  << std::setw(8) << std::fixed << std::setprecision(1)
+                  << (double)entry.total_samples / std::max<uint32_t>(1, entry.sample_rate) << " s "
+                  << std::setw(8) << entry.length / 1024.0 / 1024.0 << " MB\n" << std::defaultfloat << std::setprecision(6);
+    }
+}
+
+// 📂 HEADER OF A MAPPED HMICAP/HMICAP7 IMAGE (decompressing only its first bytes) - what the index records
+bool read_track_header(const InputMapping& file, bool compressed, HMICAPHeader& header) {
+    if (compressed) {
+        CompressedStream stream;
+        if (!stream.open(file.data, file.size) || !stream.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+            return false;
+        }
+    } else if (file.size >= sizeof(header)) {
+        std::memcpy(&header, file.data, sizeof(header));
+    } else {
+        return false;
+    }
+    return std::memcmp(header.magic, "HMICAP01", 8) == 0;
+}
+
+// 🎚️ STREAMING AUDIO SOURCE (MP3, libsndfile or an HMICA/HMICAP file, already seeked to the excerpt)
+struct AudioSource {
+    mpg123_handle* mh = nullptr;
+    SNDFILE* sf = nullptr;
+    int sample_rate = 0;
+    int channels = 0;
+    int64_t total_frames = -1; // Frames in the selected range (-1 = unknown, read until EOF)
+    int64_t frames_read = 0;
+    uint16_t native_format = SAMPLE_FLOAT32; // SampleFormat --sample-format auto stores this source as
+    bool owns_mh = true;       // false = borrowed from CodecContexts, only closed
+    std::unique_ptr<HmicapSource> hmicap; // Transcoding from HMICAP/HMICAP7
+    std::unique_ptr<HmicaSource> hmica;   // Transcoding from HMICA/HMICA7
+    bool failed = false;       // The transcode input turned out corrupt - stop, don't pad with silence
+};
+
+// ♻️ PER-WORKER DECODER/COMPRESSOR CONTEXTS (long-running modes reuse them across jobs)
+struct CodecContexts {
+    mpg123_handle* mh = nullptr;
+    ZSTD_CCtx* cctx = nullptr;
+};
+
+void close_audio_source(AudioSource& src) {
+    if (src.mh) {
+        mpg123_close(src.mh);
+        if (src.owns_mh) mpg123_delete(src.mh);
+        src.mh = nullptr;
+    }
+    if (src.sf) {
+        sf_close(src.sf);
+        src.sf = nullptr;
+    }
+    src.hmicap.reset();
+    src.hmica.reset();
+}
+
+// 🎵 NEW MPG123 HANDLE, FORCED TO FLOAT
+mpg123_handle* create_mp3_handle() {
+    int err;
+    mpg123_handle* mh = mpg123_new(nullptr, &err);
+    if (!mh) {
+        std::cerr << "❌ Failed to create mpg123 handle\n";
+        return nullptr;
+    }
+    
+    mpg123_param(mh, MPG123_ADD_FLAGS, MPG123_FORCE_FLOAT, 0.);
+    mpg123_param(mh, MPG123_INDEX_SIZE, -1, 0.); // Growing frame index = exact seeks without decoding
+    return mh;
+}
+
+// 📏 Does the MP3 go on past end_frame? Seeking there walks (and indexes) frame headers only
+// that far, so checking an excerpt costs its own length, not the file's. One MPEG frame of slack
+// keeps the gapless padding at the very end out of it - a range that reaches it gets scanned.
+const int64_t MP3_FRAME_SAMPLES = 1152;
+
+bool mp3_reaches(mpg123_handle* mh, int64_t end_frame) {
+    const int64_t probe = end_frame + MP3_FRAME_SAMPLES;
+    return mpg123_seek(mh, probe, SEEK_SET) >= probe;
+}
+
+// 🎵 MP3 SOURCE - STRAIGHT TO INTERLEAVED BABY!!
+// exact_length makes the excerpt length known up front: from --end when the track reaches past it,
+// otherwise by scanning the frame headers (no decoding).
+// reuse_mh borrows an existing handle instead of creating one per file.
+bool open_mp3_source(const std::string& path, const ConvertSettings& settings, AudioSource& src,
+                     bool exact_length, std::ostream& log, mpg123_handle* reuse_mh = nullptr) {
+    log << "🎵 Loading MP3 with mpg123...\n";
+    
+    src.owns_mh = (reuse_mh == nullptr);
+    src.mh = reuse_mh ? reuse_mh : create_mp3_handle();
+    if (!src.mh) {
+        return false;
+    }
+    
+    // A borrowed handle still has the last file's rate/channels locked in (see below) - unlock them
+    if (reuse_mh) mpg123_format_all(src.mh);
+    
+    if (mpg123_open(src.mh, path.c_str()) != MPG123_OK) {
+        std::cerr << "❌ Failed to open MP3\n";
+        close_audio_source(src);
+        return false;
+    }
+    
+    long rate;
+    int channels, encoding;
+    mpg123_getformat(src.mh, &rate, &channels, &encoding);
+    
+    mpg123_format_none(src.mh);
+    mpg123_format(src.mh, rate, channels, MPG123_ENC_FLOAT_32);
+    
+    src.sample_rate = rate;
+    src.channels = channels;
+    src.native_format = SAMPLE_INT16; // Lossy source - 16 bits is all MP3 is ever mastered from
+    
+    log << "  ✅ " << rate << "Hz, " << channels << " channels\n";
+    
+    // An excerpt that ends inside the track has its length already - no need to scan the whole file
+    int64_t length = -1;
+    const bool probed = exact_length && settings.end_seconds >= 0.0; // Moves the read position
+    const bool bounded = probed && mp3_reaches(src.mh, std::llround(settings.end_seconds * rate));
+    if (exact_length && !bounded && mpg123_scan(src.mh) == MPG123_OK) {
+        off_t scanned = mpg123_length(src.mh);
+        if (scanned >= 0) length = scanned;
+    }
+    
+    int64_t start_frame, end_frame;
+    if (!resolve_frame_range(settings, rate, length, start_frame, end_frame, log)) {
+        close_audio_source(src);
+        return false;
+    }
+    
+    // Skip straight to the excerpt (frame index walk, nothing before it gets decoded)
+    if ((start_frame > 0 || probed) && mpg123_seek(src.mh, start_frame, SEEK_SET) < 0) {
+        std::cerr << "❌ Failed to seek MP3: " << mpg123_strerror(src.mh) << "\n";
+        close_audio_source(src);
+        return false;
+    }
+    
+    src.total_frames = end_frame >= 0 ? end_frame - start_frame : -1;
+    return true;
+}
+
+// 🎼 LIBSNDFILE SOURCE
+bool open_sndfile_source(const std::string& path, const ConvertSettings& settings, AudioSource& src, std::ostream& log) {
+    log << "🎼 Loading with libsndfile...\n";
+    
+    SF_INFO sfinfo;
+    src.sf = sf_open(path.c_str(), SFM_READ, &sfinfo);
+    
+    if (!src.sf) {
+        std::cerr << "❌ Failed to open audio file\n";
+        return false;
+    }
+    
+    src.sample_rate = sfinfo.samplerate;
+    src.channels = sfinfo.channels;
+    switch (sfinfo.format & SF_FORMAT_SUBMASK) {
+        case SF_FORMAT_PCM_S8:
+        case SF_FORMAT_PCM_U8:
+        case SF_FORMAT_PCM_16:
+        case SF_FORMAT_ULAW:
+        case SF_FORMAT_ALAW:
+        case SF_FORMAT_VORBIS:
+            src.native_format = SAMPLE_INT16;
+            break;
+        case SF_FORMAT_PCM_24:
+            src.native_format = SAMPLE_INT24;
+            break;
+        default:
+            src.native_format = SAMPLE_FLOAT32; // 32-bit PCM, float, double, ...
+    }
+    
+    log << "  ✅ " << sfinfo.samplerate << "Hz, " << sfinfo.channels << " channels\n";
+    log << "  📊 " << sfinfo.frames << " samples per channel\n";
+    log << "  ⏱️  Duration: " << (float)sfinfo.frames / sfinfo.samplerate << " seconds\n";
+    
+    int64_t start_frame, end_frame;
+    if (!resolve_frame_range(settings, sfinfo.samplerate, sfinfo.frames, start_frame, end_frame, log)) {
+        close_audio_source(src);
+        return false;
+    }
+    
+    if (start_frame > 0 && sf_seek(src.sf, start_frame, SEEK_SET) < 0) {
+        std::cerr << "❌ Failed to seek: " << sf_strerror(src.sf) << "\n";
+        close_audio_source(src);
+        return false;
+    }
+    
+    src.total_frames = end_frame - start_frame;
+    return true;
+}
+
+// 💾 HMICAP/HMICAP7 SOURCE (validated like the player validates it, then read block by block)
+// (`track` set = `path` is a pack: the named track is read in place, its format comes from the index)
+bool open_hmicap_source(const std::string& path, const ConvertSettings& settings, AudioSource& src, bool compressed,
+                        std::ostream& log, const std::string& track = std::string()) {
+    std::unique_ptr<HmicapSource> hmicap(new HmicapSource);
+    HmicapSource& in = *hmicap;
+    HMICAPHeader& header = in.header;
+    if (!in.file.open(path)) {
+        std::cerr << "❌ Failed to open " << path << "\n";
+        return false;
+    }
+    if (!track.empty()) {
+        PackIndex pack;
+        if (!pack.parse(in.file.data, in.file.size)) return false;
+        const PackEntry* entry = pack.find(track);
+        if (!entry) {
+            std::cerr << "❌ No track \"" << track << "\" in " << path << "\n";
+            return false;
+        }
+        compressed = entry->format == PACK_TRACK_HMICAP7;
+        in.file.narrow(entry->offset, entry->length);
+        log << "📦 Track \"" << track << "\" at offset " << entry->offset << " of the pack\n";
+    }
+    log << (compressed ? "🌀 Transcoding HMICAP7 (decompressed as it's read)...\n"
+                             : "💾 Transcoding HMICAP (mapped, zero-copy)...\n");
+    if (compressed) {
+        in.stream.reset(new CompressedStream);
+        if (!in.stream->open(in.file.data, in.file.size) ||
+            !in.stream->read(reinterpret_cast<char*>(&header), sizeof(header))) {
+            std::cerr << "❌ Not a zstd/LZ4 compressed HMICAP7\n";
+            return false;
+        }
+    } else if (in.file.size >= sizeof(header)) {
+        std::memcpy(&header, in.file.data, sizeof(header));
+    } else {
+        std::cerr << "❌ File too small to be HMICAP\n";
+        return false;
+    }
+    
+    const uint32_t flags = header.flags;
+    const char* problem = nullptr;
+    if (std::memcmp(header.magic, "HMICAP01", 8) != 0) {
+        problem = "bad magic number";
+    } else if (header.sample_rate == 0 || header.channels == 0) {
+        problem = "no sample rate or channels";
+    } else if (header.sample_format > SAMPLE_FLOAT16) {
+        problem = "unknown sample format";
+    } else if ((flags & (HMICAP_FLAG_PLANAR | HMICAP_FLAG_CHECKSUMS | HMICAP_FLAG_XOR | HMICAP_SHUFFLE_FLAGS)) &&
+               header.block_frames == 0) {
+        problem = "blocked layout without a block size";
+    } else if ((flags & HMICAP_FLAG_PLANAR) && header.block_frames % PLANAR_ALIGN_FRAMES) {
+        problem = "planar blocks of a bad size";
+    } else if ((flags & HMICAP_FLAG_XOR) &&
+               (header.sample_format != SAMPLE_FLOAT32 || (flags & (HMICAP_FLAG_PLANAR | HMICAP_FLAG_RUNS)))) {
+        problem = "XOR coding with a bad layout";
+    } else if (compressed && (flags & (HMICAP_FLAG_RUNS | HMICAP_FLAG_XOR))) {
+        problem = "HMICAP-only layout inside an HMICAP7";
+    } else if (compressed && bool(flags & HMICAP_FLAG_LZ4) != in.stream->is_lz4()) {
+        problem = "header and frame disagree on zstd vs LZ4";
+    }
+    if (problem) {
+        std::cerr << "❌ Invalid " << (compressed ? "HMICAP7" : "HMICAP") << " (" << problem << ")\n";
+        return false;
+    }
+    
+    in.channels = header.channels;
+    in.width = sample_bytes(header.sample_format);
+    in.block_frames = header.block_frames ? header.block_frames : PAYLOAD_BLOCK_FRAMES;
+    in.stored_frames = header.total_samples;
+    const int64_t total_frames = header.total_samples;
+    const size_t offset = payload_offset(flags);
+    if (compressed) {
+        in.head.assign(reinterpret_cast<const char*>(&header), reinterpret_cast<const char*>(&header + 1));
+        in.head.resize(offset);
+        if (!in.stream->read(in.head.data() + sizeof(header), offset - sizeof(header))) {
+            std::cerr << "❌ Compressed input is corrupt or truncated (header)\n";
+            return false;
+        }
+    } else if (in.file.size < offset) {
+        std::cerr << "❌ File is truncated (header)\n";
+        return false;
+    }
+    size_t content_end = in.file.size; // Where the run table or XOR block index starts
+    
+    // ⏸️ Run table: footer at the very end, entries right before it
+    if (flags & HMICAP_FLAG_RUNS) {
+        RunFooter footer;
+        const size_t entry = 2 * sizeof(uint64_t) + in.channels * sizeof(float);
+        bool ok = in.file.size >= offset + sizeof(footer);
+        if (ok) std::memcpy(&footer, in.file.data + in.file.size - sizeof(footer), sizeof(footer));
+        ok = ok && std::memcmp(footer.magic, "HRUN", 4) == 0 && footer.stored_frames <= (uint64_t)total_frames &&
+             (uint64_t)footer.runs * entry <= in.file.size - offset - sizeof(footer);
+        content_end = in.file.size - sizeof(footer) - (ok ? footer.runs * entry : 0);
+        const char* entries = in.file.data + content_end;
+        ok = ok && XXH3_64bits(entries, footer.runs * entry) == footer.checksum;
+        int64_t end = 0, skipped = 0;
+        for (uint32_t i = 0; ok && i < footer.runs; i++) {
+            uint64_t first, frames;
+            std::memcpy(&first, entries + i * entry, sizeof(first));
+            std::memcpy(&frames, entries + i * entry + sizeof(first), sizeof(frames));
+            ok = first >= (uint64_t)end && frames > 0 && first <= (uint64_t)total_frames &&
+                 frames <= total_frames - first;
+            SampleRun run;
+            run.first = first;
+            run.frames = frames;
+            run.value.resize(in.channels);
+            std::memcpy(run.value.data(), entries + i * entry + 2 * sizeof(uint64_t), in.channels * sizeof(float));
+            in.runs.push_back(std::move(run));
+            end = first + frames;
+            skipped += frames;
+        }
+        if (!ok || (uint64_t)skipped + footer.stored_frames != (uint64_t)total_frames) {
+            std::cerr << "❌ Run table is missing or corrupt\n";
+            return false;
+        }
+        in.stored_frames = footer.stored_frames;
+    }
+    in.blocks = block_count(in.stored_frames, in.block_frames);
+    
+    // 🧬 XOR block index: footer at the very end, one coded size per block right before it
+    if (flags & HMICAP_FLAG_XOR) {
+        XorFooter footer;
+        const size_t index_bytes = in.blocks * sizeof(uint64_t);
+        bool ok = in.file.size >= offset + sizeof(footer);
+        if (ok) std::memcpy(&footer, in.file.data + in.file.size - sizeof(footer), sizeof(footer));
+        ok = ok && std::memcmp(footer.magic, "HXOR", 4) == 0 && footer.blocks == in.blocks &&
+             index_bytes <= in.file.size - offset - sizeof(footer);
+        content_end = in.file.size - sizeof(footer) - (ok ? index_bytes : 0);
+        ok = ok && XXH3_64bits(in.file.data + content_end, index_bytes) == footer.checksum;
+        in.xor_starts.assign(1, 0);
+        for (int64_t b = 0; ok && b < in.blocks; b++) {
+            uint64_t size = checksum_entry(in.file.data + content_end, b);
+            ok = size <= content_end - offset - in.xor_starts.back();
+            in.xor_starts.push_back(in.xor_starts.back() + size);
+        }
+        if (!ok) {
+            std::cerr << "❌ XOR block index is missing or corrupt\n";
+            return false;
+        }
+    }
+    
+    if (!compressed) {
+        const size_t payload_bytes = (flags & HMICAP_FLAG_XOR)
+            ? in.xor_starts.back()
+            : payload_samples(in.stored_frames, in.channels, header.block_frames, flags) * in.width;
+        const size_t table_bytes = checksum_table_bytes(in.stored_frames, header.block_frames, flags);
+        if (content_end < offset + payload_bytes + table_bytes) {
+            std::cerr << "❌ File is truncated (" << in.file.size << " bytes, header says "
+                      << offset + payload_bytes + table_bytes << ")\n";
+            return false;
+        }
+        in.payload = in.file.data + offset;
+        if (table_bytes) {
+            in.checksums = in.payload + payload_bytes;
+            if (checksum_entry(in.checksums, 0) != XXH3_64bits(in.file.data, offset)) {
+                std::cerr << "❌ Header checksum mismatch - the input is corrupt\n";
+                return false;
+            }
+        }
+    }
+    
+    src.sample_rate = header.sample_rate;
+    src.channels = header.channels;
+    src.native_format = header.sample_format;
+    log << "  ✅ " << src.sample_rate << "Hz, " << src.channels << " channels, "
+              << sample_format_name(header.sample_format) << " samples\n";
+    log << "  📊 " << total_frames << " samples per channel";
+    if (!in.runs.empty()) log << " (" << in.runs.size() << " constant runs synthesized back in)";
+    log << "\n";
+    if (flags & HMICAP_FLAG_CHECKSUMS) log << "  🔒 Block checksums verified as the blocks are read\n";
+    
+    int64_t start_frame, end_frame;
+    if (!resolve_frame_range(settings, src.sample_rate, total_frames, start_frame, end_frame, log)) {
+        return false;
+    }
+    
+    // Blocks only decode in order: read up to the excerpt and drop it
+    std::vector<float> skipped(std::min<int64_t>(start_frame, PAYLOAD_BLOCK_FRAMES) * src.channels);
+    for (int64_t left = start_frame; left > 0;) {
+        size_t got = read_hmicap_frames(in, skipped.data(), std::min<int64_t>(left, PAYLOAD_BLOCK_FRAMES));
+        if (got == 0) return false;
+        left -= got;
+    }
+    
+    src.hmicap = std::move(hmicap);
+    src.total_frames = end_frame - start_frame;
+    return true;
+}
+
+// 📜 HMICA/HMICA7 SOURCE (text: one parsing cursor per channel)
+bool open_hmica_source(const std::string& path, const ConvertSettings& settings, AudioSource& src, bool compressed, std::ostream& log) {
+    log << (compressed ? "🌀 Transcoding HMICA7 (decompressed as it's parsed)...\n"
+                             : "📜 Transcoding HMICA (mapped, parsed as it's read)...\n");
+    
+    std::unique_ptr<HmicaSource> hmica(new HmicaSource);
+    HmicaSource& in = *hmica;
+    if (!in.file.open(path)) {
+        std::cerr << "❌ Failed to open " << path << "\n";
+        return false;
+    }
+    
+    // 📋 info{} block: hz=, c=, sam=
+    TextFeed info_text;
+    if (compressed) {
+        info_text.stream.reset(new CompressedStream);
+        if (!info_text.stream->open(in.file.data, in.file.size)) {
+            std::cerr << "❌ Not a zstd compressed HMICA7\n";
+            return false;
+        }
+    } else {
+        info_text.text = in.file.data;
+        info_text.size = in.file.size;
+    }
+    std::string info;
+    const char* data;
+    size_t n;
+    const size_t max_info = 4096;
+    while (info.find('}') == std::string::npos && info.size() < max_info && info_text.peek(data, n)) {
+        n = std::min(n, max_info - info.size());
+        info.append(data, n);
+        info_text.consume(n);
+    }
+    size_t info_start = info.find("info{");
+    size_t info_end = info.find('}', info_start);
+    if (info_start == std::string::npos || info_end == std::string::npos) {
+        std::cerr << "❌ No info block found!\n";
+        return false;
+    }
+    int64_t rate = 0, channels = 0, total_frames = 0;
+    std::istringstream lines(info.substr(info_start + 5, info_end - info_start - 5));
+    std::string line;
+    while (std::getline(lines, line)) {
+        line.erase(std::remove_if(line.begin(), line.end(), ::isspace), line.end());
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        int64_t value = std::strtoll(line.c_str() + eq + 1, nullptr, 10);
+        std::string key = line.substr(0, eq);
+        if (key == "hz") rate = value;
+        if (key == "c") channels = value;
+        if (key == "sam") total_frames = value;
+    }
+    if (rate <= 0 || rate > INT32_MAX || channels <= 0 || channels > UINT16_MAX || total_frames <= 0) {
+        std::cerr << "❌ Invalid audio parameters in info block!\n";
+        return false;
+    }
+    
+    // 🧭 HMICA7 written one zstd frame per channel: each cursor starts at its channel's frame
+    // instead of decompressing every channel in front of it (single-frame files start at 0)
+    std::vector<size_t> channel_frame(channels, 0);
+    for (size_t offset = 0; compressed && offset < in.file.size;) {
+        size_t frame = ZSTD_findFrameCompressedSize(in.file.data + offset, in.file.size - offset);
+        if (ZSTD_isError(frame) || (offset == 0 && frame == in.file.size)) break;
+        CompressedStream probe;
+        char lead[16] = {};
+        if (probe.open(in.file.data + offset, frame) && probe.peek(data, n) && n > 1 && data[0] == 'C') {
+            std::memcpy(lead, data, std::min(n, sizeof(lead) - 1));
+            long channel = std::strtol(lead + 1, nullptr, 10);
+            if (channel >= 1 && channel <= channels) channel_frame[channel - 1] = offset;
+        }
+        offset += frame;
+    }
+    
+    in.channels.resize(channels);
+    const char* search_from = in.file.data;
+    for (int ch = 0; ch < channels; ch++) {
+        HmicaChannel& channel = in.channels[ch];
+        channel.tag = "C" + std::to_string(ch + 1) + "{";
+        if (compressed) {
+            channel.text.stream.reset(new CompressedStream);
+            size_t offset = channel_frame[ch];
+            channel.text.stream->open(in.file.data + offset, in.file.size - offset);
+            continue;
+        }
+        // HMICA: find the tags up front, each search starting where the previous channel did
+        channel.text.text = search_from;
+        channel.text.size = in.file.data + in.file.size - search_from;
+        if (!channel.text.skip_past(channel.tag)) {
+            channel.text.text = in.file.data;
+            channel.text.size = in.file.size;
+            if (!channel.text.skip_past(channel.tag)) {
+                std::cerr << "❌ Channel " << ch + 1 << " not found!\n";
+                return false;
+            }
+        }
+        channel.positioned = true;
+        search_from = channel.text.text;
+    }
+    
+    src.sample_rate = rate;
+    src.channels = channels;
+    src.native_format = SAMPLE_INT24; // 6 decimal places - a little under 20 bits
+    log << "  ✅ " << rate << "Hz, " << channels << " channels\n";
+    log << "  📊 " << total_frames << " samples per channel\n";
+    
+    int64_t start_frame, end_frame;
+    if (!resolve_frame_range(settings, rate, total_frames, start_frame, end_frame, log)) {
+        return false;
+    }
+    
+    // The text only parses front to back: parse up to the excerpt and drop it
+    std::vector<float> skipped(std::min<int64_t>(start_frame, PAYLOAD_BLOCK_FRAMES) * channels);
+    for (int64_t left = start_frame; left > 0;) {
+        size_t got = read_hmica_frames(in, skipped.data(), std::min<int64_t>(left, PAYLOAD_BLOCK_FRAMES));
+        if (got == 0) return false;
+        left -= got;
+    }
+    
+    src.hmica = std::move(hmica);
+    src.total_frames = end_frame - start_frame;
+    return true;
+}
+
+// 🚀 UNIVERSAL AUDIO SOURCE
+bool open_audio_source(const std::string& path, const ConvertSettings& settings, AudioSource& src,
+                       bool exact_length, std::ostream& log, CodecContexts* contexts = nullptr) {
+    std::string ext;
+    size_t dot_pos = path.find_last_of('.');
+    if (dot_pos != std::string::npos) {
+        ext = path.substr(dot_pos + 1);
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    }
+    
+    std::string pack, track;
+    if (split_pack_path(path, pack, track)) {
+        log << "🔍 Detected format: packed track\n";
+        return open_hmicap_source(pack, settings, src, false, log, track);
+    }
+    
+    log << "🔍 Detected format: ." << ext << "\n";
+    
+    if (ext == "mp3") {
+        return open_mp3_source(path, settings, src, exact_length, log, contexts ? contexts->mh : nullptr);
+    }
+    if (ext == "hmicap" || ext == "hmicap7") {
+        return open_hmicap_source(path, settings, src, ext == "hmicap7", log);
+    }
+    if (ext == "hmica" || ext == "hmica7") {
+        return open_hmica_source(path, settings, src, ext == "hmica7", log);
+    }
+    
+    return open_sndfile_source(path, settings, src, log);
+}
+
+// 📥 DECODE UP TO max_frames INTERLEAVED FRAMES (0 = end of the excerpt)
+size_t read_source_frames(AudioSource& src, float* out, size_t max_frames) {
+    if (src.total_frames >= 0) {
+        max_frames = std::min<int64_t>(max_frames, src.total_frames - src.frames_read);
+    }
+    if (max_frames == 0) return 0;
+    
+    size_t frames = 0;
+    
+    if (src.mh) {
+        size_t frame_bytes = src.channels * sizeof(float);
+        size_t wanted = max_frames * frame_bytes;
+        size_t got = 0;
+        
+        while (got < wanted) {
+            size_t done = 0;
+            int read_err = mpg123_read(src.mh, reinterpret_cast<unsigned char*>(out) + got, wanted - got, &done);
+            got += done;
+            if (read_err == MPG123_NEW_FORMAT) continue;
+            if (read_err != MPG123_OK || done == 0) break;
+        }
+        
+        frames = got / frame_bytes;
+    } else if (src.sf) {
+        sf_count_t read_count = sf_readf_float(src.sf, out, max_frames);
+        frames = read_count > 0 ? read_count : 0;
+    } else if (src.hmicap) {
+        frames = read_hmicap_frames(*src.hmicap, out, max_frames);
+        src.failed = src.hmicap->failed;
+    } else if (src.hmica) {
+        frames = read_hmica_frames(*src.hmica, out, max_frames);
+        src.failed = src.hmica->failed;
+    }
+    
+    src.frames_read += frames;
+    return frames;
+}
+
+// 🧼 SANITIZE SAMPLES (NaN/inf → 0, clamp to [-1, 1])
+void sanitize_samples(float* samples, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        float sample = samples[i];
+        if (!std::isfinite(sample)) sample = 0.0f;
+        samples[i] = std::max(-1.0f, std::min(1.0f, sample));
+    }
+}
+
+// 🚀 UNIVERSAL AUDIO LOADER (whole excerpt into memory)
+bool load_audio(const std::string& path, AudioData& audio, const ConvertSettings& settings,
+                std::ostream& log, CodecContexts* contexts = nullptr) {
+    AudioSource src;
+    if (!open_audio_source(path, settings, src, false, log, contexts)) {
+        return false;
+    }
+    
+    audio.sample_rate = src.sample_rate;
+    audio.channels = src.channels;
+    audio.native_format = src.native_format;
+    audio.interleaved_data.clear();
+    
+    if (src.total_frames >= 0) {
+        audio.interleaved_data.reserve(src.total_frames * src.channels);
+    }
+    
+    // Decode in big chunks straight into the interleaved buffer
+    const size_t chunk_frames = 65536;
+    while (true) {
+        size_t used = audio.interleaved_data.size();
+        audio.interleaved_data.resize(used + chunk_frames * src.channels);
+        size_t frames = read_source_frames(src, audio.interleaved_data.data() + used, chunk_frames);
+        audio.interleaved_data.resize(used + frames * src.channels);
+        if (frames == 0) break;
+    }
+    
+    if (src.failed) {
+        close_audio_source(src);
+        return false;
+    }
+    
+    if (src.total_frames >= 0 && src.frames_read != src.total_frames) {
+        log << "  ⚠️  Only read " << src.frames_read << "/" << src.total_frames << " samples\n";
+    }
+    
+    close_audio_source(src);
+    
+    if (audio.interleaved_data.empty()) {
+        std::cerr << "❌ No audio decoded (start past the end of the file?)\n";
+        return false;
+    }
+    
+    sanitize_samples(audio.interleaved_data.data(), audio.interleaved_data.size());
+    audio.total_samples = audio.interleaved_data.size() / audio.channels;
+    
+    log << "  📊 Loaded " << audio.total_samples << " samples per channel\n";
+    log << "  ⏱️  Duration: " << (float)audio.total_samples / audio.sample_rate << " seconds\n";
+    
+    return true;
+}
+
+// ⚡ ASYNC FILE I/O ════════════════════════════════════════════════════════
+// io_uring through the raw kernel ABI (no liburing needed): up to IO_QUEUE_DEPTH aligned
+// IO_CHUNK_BYTES requests stay in flight while the caller decodes/compresses the chunk before.
+// Kernels or sandboxes without io_uring get the same interface on plain pread/pwrite.
+// --direct opens files with O_DIRECT as well: the page cache is bypassed, which needs the
+// buffer, the file offset and the length all in whole IO_ALIGN units.
+const size_t IO_CHUNK_BYTES = 1 << 20;
+const unsigned IO_QUEUE_DEPTH = 4;
+const size_t IO_ALIGN = 4096;
+
+inline size_t io_align_up(size_t length) {
+    return (length + IO_ALIGN - 1) / IO_ALIGN * IO_ALIGN;
+}
+
+inline bool io_aligned(const void* buffer, uint64_t offset) {
+    return reinterpret_cast<uintptr_t>(buffer) % IO_ALIGN == 0 && offset % IO_ALIGN == 0;
+}
+
+// Full pread/pwrite of `length` bytes (stops early only at EOF) - bytes done, or -errno
+int64_t io_full(bool write, int fd, char* buffer, size_t length, uint64_t offset) {
+    size_t done = 0;
+    while (done < length) {
+        ssize_t n = write ? pwrite(fd, buffer + done, length - done, offset + done)
+                          : pread(fd, buffer + done, length - done, offset + done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) return -errno;
+        if (n == 0) break;
+        done += n;
+    }
+    return done;
+}
+
+struct IoCompletion {
+    uint64_t tag;
+    int64_t result; // Bytes transferred or -errno
+};
+
+// 🔁 ONE SUBMISSION/COMPLETION RING (or the synchronous stand-in)
+class IoRing {
+public:
+    explicit IoRing(unsigned depth) {
+#if HMICAP_HAVE_IO_URING
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ring_fd = (int)syscall(__NR_io_uring_setup, depth, &params);
+        if (ring_fd < 0) return;
+        
+        sq_bytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_bytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single_map = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_map) sq_bytes = cq_bytes = std::max(sq_bytes, cq_bytes);
+        sqe_bytes = params.sq_entries * sizeof(io_uring_sqe);
+        
+        sq_map = mmap(nullptr, sq_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+        cq_map = single_map ? sq_map
+                            : mmap(nullptr, cq_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+        void* sqe_map = mmap(nullptr, sqe_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+        if (sq_map == MAP_FAILED || cq_map == MAP_FAILED || sqe_map == MAP_FAILED) {
+            if (sqe_map != MAP_FAILED) munmap(sqe_map, sqe_bytes);
+            sqes = nullptr;
+            teardown();
+            return;
+        }
+        
+        char* sq = static_cast<char*>(sq_map);
+        char* cq = static_cast<char*>(cq_map);
+        sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        sqes = static_cast<io_uring_sqe*>(sqe_map);
+#else
+        (void)depth;
+#endif
+    }
+    
+    ~IoRing() { teardown(); }
+    IoRing(const IoRing&) = delete;
+    IoRing& operator=(const IoRing&) = delete;
+    
+    bool uring() const { return ring_fd >= 0; }
+    
+    // Queue one read/write (never more than `depth` outstanding); the fallback does it right away
+    void submit(bool write, int fd, char* buffer, size_t length, uint64_t offset, uint64_t tag) {
+#if HMICAP_HAVE_IO_URING
+        if (uring()) {
+            unsigned tail = *sq_tail;
+            unsigned index = tail & sq_mask;
+            io_uring_sqe& sqe = sqes[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = write ? IORING_OP_WRITE : IORING_OP_READ;
+            sqe.fd = fd;
+            sqe.addr = reinterpret_cast<uint64_t>(buffer);
+            sqe.len = length;
+            sqe.off = offset;
+            sqe.user_data = tag;
+            sq_array[index] = index;
+            __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+            
+            bool queued = true;
+            while (syscall(__NR_io_uring_enter, ring_fd, 1, 0, 0, nullptr, 0) < 0) {
+                if (errno == EINTR || errno == EAGAIN) continue;
+                // Never taken by the kernel - do it here so the caller still gets its completion
+                __atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+                queued = false;
+                break;
+            }
+            if (queued) return;
+        }
+#endif
+        finished.push_back({tag, io_full(write, fd, buffer, length, offset)});
+    }
+    
+    // Next completion, in whatever order the device finished them
+    IoCompletion wait() {
+        if (!finished.empty()) {
+            IoCompletion completion = finished.front();
+            finished.pop_front();
+            return completion;
+        }
+#if HMICAP_HAVE_IO_URING
+        while (uring()) {
+            unsigned head = *cq_head;
+            if (head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+                const io_uring_cqe& cqe = cqes[head & cq_mask];
+                IoCompletion completion = {cqe.user_data, cqe.res};
+                __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+                return completion;
+            }
+            if (syscall(__NR_io_uring_enter, ring_fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR) {
+                return {~0ull, -errno};
+            }
+        }
+#endif
+        return {~0ull, -EINVAL}; // Nothing outstanding
+    }
+    
+private:
+    void teardown() {
+#if HMICAP_HAVE_IO_URING
+        if (sqes) munmap(sqes, sqe_bytes);
+        if (cq_map != MAP_FAILED && cq_map != sq_map) munmap(cq_map, cq_bytes);
+        if (sq_map != MAP_FAILED) munmap(sq_map, sq_bytes);
+        sqes = nullptr;
+        sq_map = cq_map = MAP_FAILED;
+#endif
+        if (ring_fd >= 0) close(ring_fd);
+        ring_fd = -1;
+    }
+    
+    int ring_fd = -1;
+    std::deque<IoCompletion> finished; // Done synchronously, not handed out yet
+#if HMICAP_HAVE_IO_URING
+    void* sq_map = MAP_FAILED;
+    void* cq_map = MAP_FAILED;
+    size_t sq_bytes = 0, cq_bytes = 0, sqe_bytes = 0;
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_array = nullptr;
+    unsigned sq_mask = 0;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned cq_mask = 0;
+    io_uring_cqe* cqes = nullptr;
+    io_uring_sqe* sqes = nullptr;
+#endif
+};
+
+// One aligned chunk buffer and the request it is part of
+struct IoSlot {
+    char* buffer = nullptr;
+    uint64_t offset = 0;
+    size_t length = 0;
+    int64_t result = 0;
+    bool busy = false; // Submitted, completion not seen yet
+};
+
+const char* io_engine_name(const IoRing& ring) {
+    return ring.uring() ? "io_uring" : "pread/pwrite";
+}
+
+// 📖 ASYNC READER: streams a file front to back with the next reads already in flight, or
+// reads a range straight into the caller's buffer IO_QUEUE_DEPTH chunks at a time. Opened
+// `direct`, aligned reads go through a second O_DIRECT descriptor; anything unaligned (small
+// metadata reads, a range's last partial page, EOF stragglers) still takes the cached one.
+class AsyncReader {
+public:
+    AsyncReader() : ring(IO_QUEUE_DEPTH), slots(IO_QUEUE_DEPTH) {}
+    ~AsyncReader() { close_file(); }
+    AsyncReader(const AsyncReader&) = delete;
+    AsyncReader& operator=(const AsyncReader&) = delete;
+    
+    bool open(const std::string& path, bool direct = false) {
+        close_file();
+        fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat info;
+        if (fd < 0 || fstat(fd, &info) != 0) {
+            close_file();
+            return false;
+        }
+        file_size = info.st_size;
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        // Filesystems without O_DIRECT refuse it (EINVAL) - then everything stays cached, see direct()
+        if (direct) direct_fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT);
+        return true;
+    }
+    
+    uint64_t size() const { return file_size; }
+    bool direct() const { return direct_fd >= 0; }
+    const char* engine() const { return io_engine_name(ring); }
+    
+    // Stream [offset, size()) in order: each next() hands out one chunk (valid until the
+    // following call) and puts the slot it had back to work further ahead
+    void start(uint64_t offset = 0) {
+        drain();
+        next_offset = offset;
+        head = 0;
+        current = -1;
+        for (size_t i = 0; i < slots.size(); i++) {
+            if (!slots[i].buffer) slots[i].buffer = static_cast<char*>(std::aligned_alloc(IO_ALIGN, IO_CHUNK_BYTES));
+            queue_slot(i);
+        }
+    }
+    
+    bool next(const char*& data, size_t& length) {
+        if (current >= 0) queue_slot(current);
+        current = -1;
+        
+        IoSlot& slot = slots[head];
+        if (!slot.busy) return false; // Past the end
+        while (slot.busy && !failed) reap();
+        if (failed) return false;
+        
+        data = slot.buffer;
+        length = slot.result;
+        current = head;
+        head = (head + 1) % slots.size();
+        return length > 0;
+    }
+    
+    // Read [offset, offset + length) into `out` (must exist in the file) with several requests in flight
+    bool read_at(char* out, size_t length, uint64_t offset) {
+        drain();
+        if (offset + length > file_size) return false;
+        
+        // O_DIRECT takes the whole pages; the partial one at the end comes from the cached descriptor
+        const bool bypass = direct_fd >= 0 && io_aligned(out, offset);
+        const size_t tail = bypass ? length % IO_ALIGN : 0;
+        const int read_fd = bypass ? direct_fd : fd;
+        length -= tail;
+        
+        std::vector<IoSlot> ranges((length + IO_CHUNK_BYTES - 1) / IO_CHUNK_BYTES);
+        size_t submitted = 0, completed = 0;
+        // Keep going until everything submitted has landed - the kernel must be done with `out` when we return
+        while (completed < submitted || (submitted < ranges.size() && !failed)) {
+            while (!failed && submitted < ranges.size() && submitted - completed < IO_QUEUE_DEPTH) {
+                IoSlot& range = ranges[submitted];
+                range.buffer = out + submitted * IO_CHUNK_BYTES;
+                range.offset = offset + submitted * IO_CHUNK_BYTES;
+                range.length = std::min(IO_CHUNK_BYTES, length - submitted * IO_CHUNK_BYTES);
+                ring.submit(false, read_fd, range.buffer, range.length, range.offset, submitted);
+                submitted++;
+            }
+            IoCompletion completion = ring.wait();
+            if (completion.tag >= ranges.size()) {
+                failed = true; // The ring itself broke
+                break;
+            }
+            IoSlot& range = ranges[completion.tag];
+            finish_read(range, completion.result);
+            if (range.result != (int64_t)range.length) failed = true;
+            completed++;
+        }
+        if (tail && !failed && io_full(false, fd, out + length, tail, offset + length) != (int64_t)tail) failed = true;
+        return !failed;
+    }
+    
+    bool ok() const { return !failed; }
+    
+private:
+    void queue_slot(size_t index) {
+        IoSlot& slot = slots[index];
+        if (next_offset >= file_size) return;
+        slot.offset = next_offset;
+        slot.length = std::min<uint64_t>(IO_CHUNK_BYTES, file_size - next_offset);
+        slot.busy = true;
+        next_offset += slot.length;
+        // O_DIRECT reads the whole pages, finish_read picks up the partial one at the end of the file
+        const size_t pages = slot.length / IO_ALIGN * IO_ALIGN;
+        if (direct_fd >= 0 && slot.offset % IO_ALIGN == 0 && pages > 0) {
+            ring.submit(false, direct_fd, slot.buffer, pages, slot.offset, index);
+        } else {
+            ring.submit(false, fd, slot.buffer, slot.length, slot.offset, index);
+        }
+    }
+    
+    // A short read that isn't EOF just means "not all of it yet" - finish it synchronously
+    // (through the cached descriptor, the rest needn't be aligned)
+    void finish_read(IoSlot& slot, int64_t result) {
+        if (result >= 0 && (size_t)result < slot.length) {
+            int64_t rest = io_full(false, fd, slot.buffer + result, slot.length - result, slot.offset + result);
+            result = rest < 0 ? rest : result + rest;
+        }
+        slot.result = result;
+    }
+    
+    void reap() {
+        IoCompletion completion = ring.wait();
+        if (completion.tag >= slots.size()) {
+            lose_ring();
+            return;
+        }
+        IoSlot& slot = slots[completion.tag];
+        slot.busy = false;
+        finish_read(slot, completion.result);
+        if (slot.result != (int64_t)slot.length) failed = true;
+    }
+    
+    // The ring itself broke: nothing more will complete
+    void lose_ring() {
+        for (IoSlot& slot : slots) slot.busy = false;
+        failed = true;
+    }
+    
+    void drain() {
+        for (IoSlot& slot : slots) {
+            while (slot.busy) reap();
+        }
+        failed = false;
+    }
+    
+    void close_file() {
+        drain();
+        for (IoSlot& slot : slots) {
+            std::free(slot.buffer);
+            slot.buffer = nullptr;
+        }
+        if (fd >= 0) close(fd);
+        if (direct_fd >= 0) close(direct_fd);
+        fd = direct_fd = -1;
+    }
+    
+    IoRing ring;
+    std::vector<IoSlot> slots;
+    int fd = -1;
+    int direct_fd = -1; // O_DIRECT twin of fd (opened `direct` and supported), else -1
+    uint64_t file_size = 0;
+    uint64_t next_offset = 0;
+    size_t head = 0;  // Slot holding the next chunk in file order
+    int current = -1; // Slot handed out by the last next()
+    bool failed = false;
+};
+
+// 💾 ASYNC WRITER: write() copies into the current aligned chunk; full chunks go to the kernel
+// and the caller keeps compressing while up to IO_QUEUE_DEPTH of them are being written.
+// Opened `direct`, chunks bypass the page cache (O_DIRECT); the last one is zero padded to a
+// whole page and the file truncated back to its real size afterwards.
+class AsyncWriter {
+public:
+    AsyncWriter() : ring(IO_QUEUE_DEPTH), slots(IO_QUEUE_DEPTH) {}
+    ~AsyncWriter() { close_file(); }
+    AsyncWriter(const AsyncWriter&) = delete;
+    AsyncWriter& operator=(const AsyncWriter&) = delete;
+    
+    bool open(const std::string& path, bool direct = false) {
+        close_file();
+        fd = direct ? ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | O_DIRECT, 0644) : -1;
+        direct_io = fd >= 0;
+        if (fd < 0) fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644); // No O_DIRECT here
+        if (fd < 0) return false;
+        for (IoSlot& slot : slots) {
+            slot.buffer = static_cast<char*>(std::aligned_alloc(IO_ALIGN, IO_CHUNK_BYTES));
+        }
+        failed = false;
+        file_offset = 0;
+        current = 0;
+        fill = 0;
+        return true;
+    }
+    
+    bool direct() const { return direct_io; }
+    const char* engine() const { return io_engine_name(ring); }
+    
+    bool write(const char* data, size_t size) {
+        while (size > 0 && !failed) {
+            IoSlot& slot = slots[current];
+            while (slot.busy && !failed) reap(); // Recycle the oldest chunk once it's on disk
+            
+            size_t n = std::min(size, IO_CHUNK_BYTES - fill);
+            std::memcpy(slot.buffer + fill, data, n);
+            fill += n;
+            data += n;
+            size -= n;
+            if (fill == IO_CHUNK_BYTES) queue_current();
+        }
+        return !failed;
+    }
+    
+    // Flush the partial chunk, wait for everything and close - false if any write failed
+    bool finish() {
+        if (fd < 0) return false;
+        if (fill > 0 && !failed) queue_current();
+        if (direct_io) {
+            for (IoSlot& slot : slots) {
+                while (slot.busy) reap();
+            }
+            if (!failed && ftruncate(fd, file_offset) != 0) failed = true; // Drop the last chunk's padding
+        }
+        bool ok = !failed;
+        close_file();
+        return ok;
+    }
+    
+private:
+    void queue_current() {
+        IoSlot& slot = slots[current];
+        slot.offset = file_offset;
+        slot.length = fill;
+        if (direct_io) {
+            slot.length = io_align_up(fill);
+            std::memset(slot.buffer + fill, 0, slot.length - fill);
+        }
+        slot.busy = true;
+        file_offset += fill;
+        ring.submit(true, fd, slot.buffer, slot.length, slot.offset, current);
+        current = (current + 1) % slots.size();
+        fill = 0;
+    }
+    
+    void reap() {
+        IoCompletion completion = ring.wait();
+        if (completion.tag >= slots.size()) {
+            for (IoSlot& slot : slots) slot.busy = false; // The ring itself broke: nothing more will complete
+            failed = true;
+            return;
+        }
+        IoSlot& slot = slots[completion.tag];
+        slot.busy = false;
+        int64_t result = completion.result;
+        if (result >= 0 && (size_t)result < slot.length) {
+            int64_t rest = io_full(true, fd, slot.buffer + result, slot.length - result, slot.offset + result);
+            result = rest < 0 ? rest : result + rest;
+        }
+        if (result != (int64_t)slot.length) failed = true;
+    }
+    
+    void close_file() {
+        for (IoSlot& slot : slots) {
+            while (slot.busy) reap();
+            std::free(slot.buffer);
+            slot.buffer = nullptr;
+        }
+        if (fd >= 0 && close(fd) != 0) failed = true;
+        fd = -1;
+    }
+    
+    IoRing ring;
+    std::vector<IoSlot> slots;
+    int fd = -1;
+    uint64_t file_offset = 0;
+    size_t current = 0; // Slot being filled
+    size_t fill = 0;    // Bytes in it so far
+    bool direct_io = false; // Opened with O_DIRECT: chunks must be whole pages
+    bool failed = false;
+};
+
+// Open an output file the way --direct asks (and say so when the filesystem can't do O_DIRECT)
+bool open_output(AsyncWriter& file, const std::string& path, const ConvertSettings& settings, std::ostream& log) {
+    if (!file.open(path, settings.direct)) return false;
+    if (settings.direct && !file.direct()) log << "  ⚠️  No O_DIRECT on this filesystem - writing through the page cache\n";
+    return true;
+}
+
+// 💾 WRITE HMICAP FILE (UNCOMPRESSED BINARY - RAW SPEED!!)
+bool write_hmicap(const std::string& path, const AudioData& audio, const ConvertSettings& settings, std::ostream& log) {
+    log << "\n💾 Writing HMICAP file...\n";
+    
+    const uint32_t flags = layout_flags(settings, false);
+    const uint16_t format = resolve_sample_format(settings, audio);
+    
+    HMICAPHeader header;
+    std::memset(&header, 0, sizeof(header));
+    
+    std::memcpy(header.magic, "HMICAP01", 8);
+    header.sample_rate = audio.sample_rate;
+    header.channels = audio.channels;
+    header.sample_format = format;
+    header.total_samples = audio.total_samples;
+    header.flags = flags;
+    if (flags) header.block_frames = PAYLOAD_BLOCK_FRAMES;
+    
+    AsyncWriter file;
+    if (!open_output(file, path, settings, log)) {
+        std::cerr << "❌ Failed to create HMICAP file\n";
+        return false;
+    }
+    
+    // Write header (zero padded up to the payload offset)
+    std::vector<char> head(payload_offset(flags), 0);
+    std::memcpy(head.data(), &header, sizeof(header));
+    bool ok = file.write(head.data(), head.size());
+    
+    // ⏸️ With runs cut out the stored blocks only exist as they're written - hashed right there
+    const bool cut_runs = flags & HMICAP_FLAG_RUNS;
+    std::vector<uint64_t> checksums;
+    std::thread checksummer = cut_runs ? std::thread()
+                                       : start_checksums(audio, head, flags, format, PAYLOAD_BLOCK_FRAMES, checksums, log);
+    std::vector<char> overview;
+    std::thread overview_builder = start_overview(audio, flags, overview, log);
+    
+    BlockEncoder encoder(flags, format);
+    RunSplitter splitter(audio.channels);
+    std::vector<uint64_t> xor_sizes; // HMICAP_FLAG_XOR: coded bytes per block, for the index
+    if (cut_runs) {
+        print_sample_format(format, log);
+        if (flags & HMICAP_FLAG_PLANAR) {
+            log << "  🎚️  Planar " << PAYLOAD_BLOCK_FRAMES << "-frame blocks (channels stored one after another)\n";
+        }
+        if (flags & HMICAP_FLAG_CHECKSUMS) {
+            log << "  🔒 xxh3 checksum per " << PAYLOAD_BLOCK_FRAMES << "-frame block (hashed as it's written)\n";
+            checksums.push_back(XXH3_64bits(head.data(), head.size()));
+        }
+        std::vector<float> stored;
+        std::vector<char> block;
+        for (int64_t first = 0; ok && first < audio.total_samples; first += PAYLOAD_BLOCK_FRAMES) {
+            size_t frames = std::min<int64_t>(PAYLOAD_BLOCK_FRAMES, audio.total_samples - first);
+            const bool finished = first + (int64_t)frames == audio.total_samples;
+            splitter.feed(audio.interleaved_data.data() + first * audio.channels, frames);
+            if (finished) splitter.finish();
+            while (ok && splitter.take_block(PAYLOAD_BLOCK_FRAMES, finished, stored)) {
+                if (encoder.passthrough()) {
+                    block.assign(reinterpret_cast<const char*>(stored.data()),
+                                 reinterpret_cast<const char*>(stored.data() + stored.size()));
+                } else {
+                    encoder.encode(stored.data(), stored.size() / audio.channels, audio.channels, block);
+                }
+                if (flags & HMICAP_FLAG_CHECKSUMS) checksums.push_back(XXH3_64bits(block.data(), block.size()));
+                ok = file.write(block.data(), block.size());
+            }
+        }
+    } else if (encoder.passthrough()) {
+        // Write interleaved sample data (ALREADY READY TO GO!!)
+        ok = ok && file.write(reinterpret_cast<const char*>(audio.interleaved_data.data()),
+                              audio.interleaved_data.size() * sizeof(float));
+    } else {
+        print_sample_format(format, log);
+        if (flags & HMICAP_FLAG_PLANAR) {
+            log << "  🎚️  Planar " << PAYLOAD_BLOCK_FRAMES << "-frame blocks (channels stored one after another)\n";
+        }
+        if (flags & HMICAP_FLAG_XOR) {
+            log << "  🧬 XOR-delta coding " << PAYLOAD_BLOCK_FRAMES << "-frame blocks (" << XOR_GROUP
+                      << "-sample groups)\n";
+        }
+        std::vector<char> block;
+        for (int64_t first = 0; ok && first < audio.total_samples; first += PAYLOAD_BLOCK_FRAMES) {
+            size_t frames = std::min<int64_t>(PAYLOAD_BLOCK_FRAMES, audio.total_samples - first);
+            encoder.encode(audio.interleaved_data.data() + first * audio.channels, frames, audio.channels, block);
+            if (flags & HMICAP_FLAG_XOR) xor_sizes.push_back(block.size());
+            ok = file.write(block.data(), block.size());
+        }
+    }
+    
+    if (checksummer.joinable()) checksummer.join();
+    if (flags & HMICAP_FLAG_CHECKSUMS) {
+        std::vector<char> table = build_checksum_table(checksums);
+        ok = ok && file.write(table.data(), table.size());
+    }
+    if (overview_builder.joinable()) {
+        overview_builder.join();
+        ok = ok && file.write(overview.data(), overview.size());
+    }
+    if (cut_runs) {
+        std::vector<char> run_table = build_run_table(splitter, format);
+        ok = ok && file.write(run_table.data(), run_table.size());
+    }
+    if (flags & HMICAP_FLAG_XOR) {
+        std::vector<char> index = build_xor_index(xor_sizes);
+        ok = ok && file.write(index.data(), index.size());
+    }
+    
+    if (!file.finish() || !ok) {
+        std::cerr << "❌ Write failed (disk full?)\n";
+        return false;
+    }
+    
+    if (cut_runs) print_run_summary(splitter, audio.sample_rate, audio.channels * sample_bytes(format), log);
+    if (flags & HMICAP_FLAG_XOR) print_xor_summary(xor_sizes, audio.interleaved_data.size() * sizeof(float), log);
+    size_t file_size = fs::file_size(path);
+    log << "  ✅ HMICAP written: " << file_size / 1024.0 / 1024.0 << " MB\n";
+    
+    return true;
+}
+
+// 🗜️ COMPRESSION PROFILES ═════════════════════════════════════════════════
+// Named zstd setups for HMICAP7. Windows stop at 2^27 (128 MB, ~6 minutes of float stereo):
+// that's zstd's default decoder limit, so every loader reads them without extra parameters.
+// Long-distance matching finds repeats far back in that window (a chorus, a loop). Workers only
+// help the big single streaming frame; seekable and overview frames stay on the zstd thread.
+// The fast-decode profiles trade size for load time: zstd's negative levels skip entropy coding
+// of literals (decompression gets close to memcpy), and "lz4" writes LZ4 frames instead, flagged
+// with HMICAP_FLAG_LZ4 - loaders tell the codec apart by the frame magic. LZ4 is single-frame only.
+struct CompressionProfile {
+    const char* name;
+    int level;          // zstd level (negative = fast levels), or the LZ4 level (LZ4 HC from 3)
+    int window_log;     // 0 = the level's default window
+    bool long_distance; // ZSTD_c_enableLongDistanceMatching
+    bool workers;       // ZSTD_c_nbWorkers = one per core (--jobs 1 / single file only)
+    bool lz4;           // LZ4 frames instead of zstd (HMICAP_HAVE_LZ4 builds)
+    const char* summary;
+};
+
+const CompressionProfile COMPRESSION_PROFILES[] = {
+    {"fast", 3, 0, false, true, false, "zstd 3 - drafts, seconds per track"},
+    {"balanced", 9, 25, true, true, false, "zstd 9 + 32 MB window + long-distance matching"},
+    {"max", 19, 0, false, false, false, "zstd 19, the classic HMICAP7 setting (default)"},
+    {"archive", 19, 27, true, true, false, "zstd 19 + 128 MB window + long-distance matching"},
+    {"ultra", 22, 27, true, true, false, "zstd 22 + 128 MB window + long-distance matching (slow)"},
+    {"fast-decode", -1, 0, false, false, false, "zstd -1 - level-1 size, ~3x faster to load than max"},
+    {"instant", -5, 0, false, false, false, "zstd -5 - literals stored raw, loads at memory speed"},
+    {"lz4", 9, 0, false, false, true, "LZ4 HC 9 frames (needs a -DHMICAP_WITH_LZ4 build)"},
+};
+
+const CompressionProfile* find_compression_profile(const std::string& name) {
+    for (const auto& profile : COMPRESSION_PROFILES) {
+        if (name == profile.name) return &profile;
+    }
+    return nullptr;
+}
+
+void apply_profile(const CompressionProfile& profile, unsigned workers, ConvertSettings& settings) {
+    settings.zstd_level = profile.level;
+    settings.zstd_window_log = profile.window_log;
+    settings.zstd_long_distance = profile.long_distance;
+    settings.zstd_workers = profile.workers ? workers : 0;
+    settings.lz4 = profile.lz4;
+}
+
+// 🗜️ Set level/window/LDM (and workers, for the streaming frame) on a freshly reset context
+void apply_compression(ZSTD_CCtx* cctx, const ConvertSettings& settings, int level, bool streaming) {
+    ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, level);
+    if (settings.zstd_window_log > 0) ZSTD_CCtx_setParameter(cctx, ZSTD_c_windowLog, settings.zstd_window_log);
+    if (settings.zstd_long_distance) ZSTD_CCtx_setParameter(cctx, ZSTD_c_enableLongDistanceMatching, 1);
+    if (streaming && settings.zstd_workers > 0 &&
+        ZSTD_isError(ZSTD_CCtx_setParameter(cctx, ZSTD_c_nbWorkers, settings.zstd_workers))) {
+        static std::once_flag warned;
+        std::call_once(warned, [] { std::cerr << "⚠️  libzstd built without threads - compressing on one core\n"; });
+    }
+}
+
+void print_compression(const ConvertSettings& settings, int level, bool streaming, std::ostream& log) {
+    if (settings.lz4) {
+        log << "  ⚡ LZ4" << (level >= 3 ? " HC " : " ") << level << " frame (fast decode)\n";
+        return;
+    }
+    log << "  🗜️  zstd " << level;
+    if (settings.zstd_window_log > 0) log << ", " << (1u << settings.zstd_window_log) / 1024 / 1024 << " MB window";
+    if (settings.zstd_long_distance) log << ", long-distance matching";
+    if (streaming && settings.zstd_workers > 0) log << ", " << settings.zstd_workers << " worker(s)";
+    log << "\n";
+}
+
+// 🎯 ADAPTIVE LEVEL (--budget): time a trial compression of `sample` (the payload's own bytes,
+// `sample_seconds` of audio) at rising levels and keep the strongest whose projected cost fits
+// zstd_budget seconds per minute of audio. The trial runs on one thread, so workers only add
+// headroom. Level 1 is the floor even when nothing fits.
+const double BUDGET_TRIAL_SECONDS = 10.0; // Audio per trial slice
+const int BUDGET_LEVELS[] = {1, 3, 5, 7, 9, 12, 15, 17, 19, 22};
+
+int pick_budget_level(const ConvertSettings& settings, const char* sample, size_t size, double sample_seconds, std::ostream& log) {
+    if (size == 0 || sample_seconds <= 0.0) return settings.zstd_level;
+    
+    ZSTD_CCtx* cctx = ZSTD_createCCtx();
+    std::vector<char> out(ZSTD_compressBound(size));
+    int chosen = BUDGET_LEVELS[0];
+    
+    log << "  🎯 Budget " << settings.zstd_budget << " s per audio minute, trial on "
+              << sample_seconds << " s (" << size / 1024.0 / 1024.0 << " MB):";
+    for (int level : BUDGET_LEVELS) {
+        ZSTD_CCtx_reset(cctx, ZSTD_reset_session_and_parameters);
+        apply_compression(cctx, settings, level, false);
+        auto start = std::chrono::steady_clock::now();
+        size_t written = ZSTD_compress2(cctx, out.data(), out.size(), sample, size);
+        double per_minute = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() *
+                            60.0 / sample_seconds;
+        if (ZSTD_isError(written)) break;
+        
+        log << " " << level << "→" << std::fixed << std::setprecision(1) << per_minute << "s"
+                  << std::defaultfloat << std::setprecision(6);
+        if (per_minute > settings.zstd_budget) break;
+        chosen = level;
+    }
+    log << "\n";
+    
+    ZSTD_freeCCtx(cctx);
+    return chosen;
+}
+
+// 🎯 Level for the whole-track writers: the profile's, or the budget pick on a middle slice
+int resolve_level(const AudioData& audio, const ConvertSettings& settings, uint32_t flags, uint16_t format, std::ostream& log) {
+    if (settings.zstd_budget <= 0.0) return settings.zstd_level;
+    
+    size_t frames = std::min<int64_t>(audio.total_samples, (int64_t)(BUDGET_TRIAL_SECONDS * audio.sample_rate));
+    size_t first = (audio.total_samples - frames) / 2;
+    BlockEncoder encoder(flags, format);
+    std::vector<char> sample;
+    encoder.encode(audio.interleaved_data.data() + first * audio.channels, frames, audio.channels, sample);
+    return pick_budget_level(settings, sample.data(), sample.size(), (double)frames / audio.sample_rate, log);
+}
+
+// ⚡ LZ4 FRAMES ══════════════════════════════════════════════════════════════
+// HMICAP_FLAG_LZ4 files hold standard LZ4 frames (plain `lz4 -d` works) in the places zstd frames
+// would go: the header + payload frame, then the overview frame and its OVERVIEW_LOCATOR (zstd
+// and LZ4 share the skippable frame magics). Content size is in the frame header so loaders can
+// size their buffer, like zstd's pledged size. Builds without HMICAP_HAVE_LZ4 get the same
+// interface, failing with a message - main() refuses LZ4 profiles there anyway.
+const size_t LZ4_STREAM_SLICE = 4 << 20; // Input per LZ4F_compressUpdate call (output room is its worst case)
+
+#if HMICAP_HAVE_LZ4
+bool lz4_ok(size_t result) {
+    if (!LZ4F_isError(result)) return true;
+    std::cerr << "❌ LZ4 failed: " << LZ4F_getErrorName(result) << "\n";
+    return false;
+}
+
+LZ4F_preferences_t lz4_preferences(int level, uint64_t content_size) {
+    LZ4F_preferences_t prefs;
+    std::memset(&prefs, 0, sizeof(prefs));
+    prefs.compressionLevel = level;
+    prefs.frameInfo.blockSizeID = LZ4F_max4MB;
+    prefs.frameInfo.contentSize = content_size;
+    return prefs;
+}
+
+// ⚡ ONE LZ4 FRAME, streamed: update() for every input chunk, then end(). Each call leaves the
+// compressed bytes it produced in `out` (the frame header comes out with the first one).
+struct Lz4FrameStream {
+    LZ4F_cctx* cctx = nullptr;
+    LZ4F_preferences_t prefs;
+    bool started = false;
+    std::vector<char> out;
+    
+    Lz4FrameStream(int level, uint64_t content_size) : prefs(lz4_preferences(level, content_size)) {
+        LZ4F_createCompressionContext(&cctx, LZ4F_VERSION);
+    }
+    ~Lz4FrameStream() { LZ4F_freeCompressionContext(cctx); }
+    
+    bool begin() {
+        out.resize(LZ4F_HEADER_SIZE_MAX);
+        size_t written = LZ4F_compressBegin(cctx, out.data(), out.size(), &prefs);
+        out.resize(LZ4F_isError(written) ? 0 : written);
+        started = true;
+        return lz4_ok(written);
+    }
+    
+    bool update(const char* data, size_t size) {
+        out.clear();
+        if (!started && !begin()) return false;
+        while (size > 0) {
+            size_t n = std::min(size, LZ4_STREAM_SLICE), used = out.size();
+            out.resize(used + LZ4F_compressBound(n, &prefs));
+            size_t written = LZ4F_compressUpdate(cctx, out.data() + used, out.size() - used, data, n, nullptr);
+            if (!lz4_ok(written)) return false;
+            out.resize(used + written);
+            data += n;
+            size -= n;
+        }
+        return true;
+    }
+    
+    bool end() {
+        out.clear();
+        if (!started && !begin()) return false;
+        size_t used = out.size();
+        out.resize(used + LZ4F_compressBound(0, &prefs));
+        size_t written = LZ4F_compressEnd(cctx, out.data() + used, out.size() - used, nullptr);
+        if (!lz4_ok(written)) return false;
+        out.resize(used + written);
+        return true;
+    }
+};
+
+// ⚡ `size` bytes as one whole LZ4 frame
+bool lz4_compress_frame(int level, const char* data, size_t size, std::vector<char>& out) {
+    LZ4F_preferences_t prefs = lz4_preferences(level, size);
+    out.resize(LZ4F_compressFrameBound(size, &prefs));
+    size_t written = LZ4F_compressFrame(out.data(), out.size(), data, size, &prefs);
+    if (!lz4_ok(written)) return false;
+    out.resize(written);
+    return true;
+}
+
+// ⚡ Decompress the whole LZ4 frame at the start of `data` into `out` (sized from the frame header)
+bool lz4_decompress_frame(const char* data, size_t size, std::vector<char>& out) {
+    LZ4F_dctx* dctx = nullptr;
+    if (!lz4_ok(LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION))) return false;
+    LZ4F_frameInfo_t info;
+    size_t consumed = size;
+    size_t hint = LZ4F_getFrameInfo(dctx, &info, data, &consumed);
+    bool ok = lz4_ok(hint) && info.contentSize > 0;
+    if (ok) {
+        out.resize(info.contentSize);
+        size_t produced = 0;
+        while (ok && hint != 0 && consumed < size) {
+            size_t dst = out.size() - produced, src = size - consumed;
+            hint = LZ4F_decompress(dctx, out.data() + produced, &dst, data + consumed, &src, nullptr);
+            ok = lz4_ok(hint) && (dst > 0 || src > 0);
+            produced += dst;
+            consumed += src;
+        }
+        ok = ok && hint == 0 && produced == out.size();
+    }
+    LZ4F_freeDecompressionContext(dctx);
+    return ok;
+}
+#else
+struct Lz4FrameStream {
+    std::vector<char> out;
+    Lz4FrameStream(int, uint64_t) {}
+    bool update(const char*, size_t) { return end(); }
+    bool end() {
+        std::cerr << "❌ This converter was built without LZ4 (-DHMICAP_WITH_LZ4)\n";
+        return false;
+    }
+};
+
+bool lz4_compress_frame(int, const char*, size_t, std::vector<char>&) { return Lz4FrameStream(0, 0).end(); }
+bool lz4_decompress_frame(const char*, size_t, std::vector<char>&) { return Lz4FrameStream(0, 0).end(); }
+#endif
+
+// 🧭 ZSTD SEEKABLE FORMAT (zstd contrib/seekable_format) ═══════════════════
+// Independent zstd frames, then a skippable frame listing (compressed, decompressed) size per
+// frame and a 9-byte footer. Plain `zstd -d` still decompresses the whole thing to a .hmicap.
+const uint32_t ZSTD_SEEKABLE_SKIPPABLE_MAGIC = 0x184D2A5E;
+const uint32_t ZSTD_SEEKABLE_FOOTER_MAGIC = 0x8F92EAB1;
+const size_t ZSTD_SEEKABLE_MAX_FRAME_SIZE = 0x40000000; // Spec limit for one frame's decompressed size
+
+struct SeekTableEntry {
+    uint32_t compressed_size;
+    uint32_t decompressed_size;
+};
+
+void put_le32(std::vector<char>& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+std::vector<char> build_seek_table(const std::vector<SeekTableEntry>& entries) {
+    std::vector<char> table;
+    put_le32(table, ZSTD_SEEKABLE_SKIPPABLE_MAGIC);
+    put_le32(table, entries.size() * 8 + 9);
+    for (const auto& entry : entries) {
+        put_le32(table, entry.compressed_size);
+        put_le32(table, entry.decompressed_size);
+    }
+    put_le32(table, entries.size());
+    table.push_back(0); // Descriptor: no per-frame checksums
+    put_le32(table, ZSTD_SEEKABLE_FOOTER_MAGIC);
+    return table;
+}
+
+// 📈 Single-frame HMICAP7: overview frame (in the file's codec) + OVERVIEW_LOCATOR skippable frame
+// (its compressed size)
+bool compress_overview_frame(ZSTD_CCtx* cctx, const ConvertSettings& settings, const std::vector<char>& section,
+                             std::vector<char>& out) {
+    size_t written = 0;
+    if (settings.lz4) {
+        if (!lz4_compress_frame(settings.zstd_level, section.data(), section.size(), out)) return false;
+        written = out.size();
+    } else {
+        ZSTD_CCtx_reset(cctx, ZSTD_reset_session_only);
+        out.resize(ZSTD_compressBound(section.size()));
+        written = ZSTD_compress2(cctx, out.data(), out.size(), section.data(), section.size());
+        if (ZSTD_isError(written)) {
+            std::cerr << "❌ Compression failed: " << ZSTD_getErrorName(written) << "\n";
+            return false;
+        }
+        out.resize(written);
+    }
+    put_le32(out, OVERVIEW_LOCATOR_MAGIC);
+    put_le32(out, 8);
+    put_le32(out, written);
+    out.insert(out.end(), {'H', 'O', 'V', 'W'});
+    return true;
+}
+
+// Frames per seekable block (0 = classic single-frame HMICAP7)
+size_t seek_block_frames(const ConvertSettings& settings, int sample_rate, int channels) {
+    if (settings.block_seconds <= 0.0) return 0;
+    size_t frames = std::max<size_t>(1, std::llround(settings.block_seconds * sample_rate));
+    frames = std::min(frames, ZSTD_SEEKABLE_MAX_FRAME_SIZE / (channels * sizeof(float))); // Any sample format fits
+    if (settings.planar) {
+        // Whole 64-byte planes in every block but the last
+        frames = std::max(PLANAR_ALIGN_FRAMES, frames / PLANAR_ALIGN_FRAMES * PLANAR_ALIGN_FRAMES);
+    }
+    return frames;
+}
+
+// Compress `size` bytes as one independent frame (cctx parameters already set)
+bool compress_seekable_frame(ZSTD_CCtx* cctx, const char* data, size_t size, std::vector<char>& out,
+                             std::vector<SeekTableEntry>& entries) {
+    out.resize(ZSTD_compressBound(size));
+    size_t written = ZSTD_compress2(cctx, out.data(), out.size(), data, size);
+    if (ZSTD_isError(written)) {
+        std::cerr << "❌ Compression failed: " << ZSTD_getErrorName(written) << "\n";
+        return false;
+    }
+    out.resize(written);
+    entries.push_back({(uint32_t)written, (uint32_t)size});
+    return true;
+}
+
+// 🧭 WRITE SEEKABLE HMICAP7: header frame, one frame per block, seek table
+bool write_hmicap7_seekable(const std::string& path, const AudioData& audio, size_t block_frames,
+                            const ConvertSettings& settings, ZSTD_CCtx* cctx, std::ostream& log) {
+    const uint32_t flags = layout_flags(settings, true);
+    const uint16_t format = resolve_sample_format(settings, audio);
+    
+    HMICAPHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "HMICAP01", 8);
+    header.sample_rate = audio.sample_rate;
+    header.channels = audio.channels;
+    header.sample_format = format;
+    header.total_samples = audio.total_samples;
+    header.flags = HMICAP_FLAG_SEEKABLE | flags;
+    header.block_frames = block_frames;
+    
+    AsyncWriter file;
+    if (!open_output(file, path, settings, log)) {
+        std::cerr << "❌ Failed to create HMICAP7 file\n";
+        return false;
+    }
+    
+    ZSTD_CCtx* own_cctx = cctx ? nullptr : ZSTD_createCCtx();
+    if (!cctx) cctx = own_cctx;
+    ZSTD_CCtx_reset(cctx, ZSTD_reset_session_and_parameters);
+    const int level = resolve_level(audio, settings, flags, format, log);
+    apply_compression(cctx, settings, level, false);
+    
+    const size_t payload_bytes = payload_offset(flags) +
+        payload_samples(audio.total_samples, audio.channels, block_frames, flags) * sample_bytes(format) +
+        checksum_table_bytes(audio.total_samples, block_frames, flags) +
+        overview_section_bytes(audio.total_samples, audio.channels, flags);
+    log << "  🧭 Seekable: " << block_frames << "-frame blocks ("
+              << (double)block_frames / audio.sample_rate << " s each)\n";
+    print_compression(settings, level, false, log);
+    print_sample_format(format, log);
+    if (flags & HMICAP_SHUFFLE_FLAGS) log << "  🔀 " << shuffle_name(flags) << "-shuffled blocks\n";
+    if (flags & HMICAP_FLAG_PLANAR) log << "  🎚️  Planar blocks (channels stored one after another)\n";
+    log << "  🔄 Compressing " << payload_bytes / 1024.0 / 1024.0 << " MB...\n";
+    
+    // Frame 0 = header (+ padding up to the payload offset), so `zstd -d` still gives a valid .hmicap
+    std::vector<char> head(payload_offset(flags), 0);
+    std::memcpy(head.data(), &header, sizeof(header));
+    
+    std::vector<uint64_t> checksums;
+    std::thread checksummer = start_checksums(audio, head, flags, format, block_frames, checksums, log);
+    std::vector<char> overview;
+    std::thread overview_builder = start_overview(audio, flags, overview, log);
+    
+    std::vector<SeekTableEntry> entries;
+    std::vector<char> frame;
+    bool ok = compress_seekable_frame(cctx, head.data(), head.size(), frame, entries) &&
+              file.write(frame.data(), frame.size());
+    
+    BlockEncoder encoder(flags, format);
+    std::vector<char> block;
+    for (int64_t first = 0; ok && first < audio.total_samples; first += block_frames) {
+        size_t frames = std::min<int64_t>(block_frames, audio.total_samples - first);
+        encoder.encode(audio.interleaved_data.data() + first * audio.channels, frames, audio.channels, block);
+        ok = compress_seekable_frame(cctx, block.data(), block.size(), frame, entries) &&
+             file.write(frame.data(), frame.size());
+    }
+    
+    // 🔒 Checksum table = one more frame after the last block
+    if (checksummer.joinable()) {
+        checksummer.join();
+        block = build_checksum_table(checksums);
+        ok = ok && compress_seekable_frame(cctx, block.data(), block.size(), frame, entries) &&
+             file.write(frame.data(), frame.size());
+    }
+    
+    // 📈 Overview = the last frame, readable without touching any block
+    if (overview_builder.joinable()) {
+        overview_builder.join();
+        ok = ok && compress_seekable_frame(cctx, overview.data(), overview.size(), frame, entries) &&
+             file.write(frame.data(), frame.size());
+    }
+    
+    if (own_cctx) ZSTD_freeCCtx(own_cctx);
+    
+    std::vector<char> table = build_seek_table(entries);
+    ok = ok && file.write(table.data(), table.size());
+    if (!file.finish()) {
+        std::cerr << "❌ Write failed (disk full?)\n";
+        return false;
+    }
+    if (!ok) return false; // Compression error, already reported
+    
+    size_t compressed_size = fs::file_size(path);
+    log << "  ✅ HMICAP7 written: " << compressed_size / 1024.0 / 1024.0 << " MB ("
+              << block_count(audio.total_samples, block_frames) << " blocks + "
+              << ((flags & HMICAP_FLAG_CHECKSUMS) ? "checksum table + " : "")
+              << ((flags & HMICAP_FLAG_OVERVIEW) ? "overview + " : "") << "seek table)\n";
+    log << "  📊 Compression ratio: " << (float)payload_bytes / compressed_size << "x 💯\n";
+    
+    return true;
+}
+
+// 🌀 WRITE HMICAP7 FILE (ZSTD COMPRESSED - MAXIMUM COMPRESSION!!)
+// The header and the samples (in place, or one encoded block at a time) stream through the
+// compressor and every ZSTD_CStreamOutSize() piece goes straight to the file - nothing the size
+// of the audio gets allocated on top of the audio itself.
+// cctx (optional) is a reusable compression context - saves re-allocating level-19 tables per file
+bool write_hmicap7(const std::string& path, const AudioData& audio, const ConvertSettings& settings,
+                   std::ostream& log, ZSTD_CCtx* cctx = nullptr) {
+    log << "\n🌀 Writing HMICAP7 file (compressed)...\n";
+    
+    const uint32_t flags = layout_flags(settings, true);
+    const uint16_t format = resolve_sample_format(settings, audio);
+    const size_t offset = payload_offset(flags);
+    const size_t payload_bytes = offset + payload_samples(audio.total_samples, audio.channels, PAYLOAD_BLOCK_FRAMES, flags) *
+                                              sample_bytes(format) +
+                                 checksum_table_bytes(audio.total_samples, PAYLOAD_BLOCK_FRAMES, flags);
+    
+    HMICAPHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "HMICAP01", 8);
+    header.sample_rate = audio.sample_rate;
+    header.channels = audio.channels;
+    header.sample_format = format;
+    header.total_samples = audio.total_samples;
+    header.flags = flags;
+    if (flags) header.block_frames = PAYLOAD_BLOCK_FRAMES;
+    
+    print_sample_format(format, log);
+    if (flags & HMICAP_SHUFFLE_FLAGS) {
+        log << "  🔀 " << shuffle_name(flags) << "-shuffled in " << PAYLOAD_BLOCK_FRAMES << "-frame blocks\n";
+    }
+    if (flags & HMICAP_FLAG_PLANAR) {
+        log << "  🎚️  Planar " << PAYLOAD_BLOCK_FRAMES << "-frame blocks (channels stored one after another)\n";
+    }
+    
+    AsyncWriter file;
+    if (!open_output(file, path, settings, log)) {
+        std::cerr << "❌ Failed to create HMICAP7 file\n";
+        return false;
+    }
+    
+    // Compress with the profile's zstd setup (level 19 by default, SHEEEESH) - content size
+    // pledged so loaders can size their buffer
+    ZSTD_CCtx* own_cctx = cctx ? nullptr : ZSTD_createCCtx();
+    if (!cctx) cctx = own_cctx;
+    ZSTD_CCtx_reset(cctx, ZSTD_reset_session_and_parameters);
+    const int level = resolve_level(audio, settings, flags, format, log);
+    apply_compression(cctx, settings, level, true);
+    ZSTD_CCtx_setPledgedSrcSize(cctx, payload_bytes);
+    
+    print_compression(settings, level, true, log);
+    log << "  🔄 Compressing " << payload_bytes / 1024.0 / 1024.0 << " MB...\n";
+    
+    std::vector<char> out(ZSTD_CStreamOutSize());
+    size_t compressed_size = 0;
+    Lz4FrameStream lz4(level, payload_bytes);
+    
+    // Feed one input chunk (or the final flush), writing whatever comes out
+    auto feed = [&](const char* data, size_t size, ZSTD_EndDirective mode) -> bool {
+        if (settings.lz4) {
+            bool ok = (mode == ZSTD_e_end ? lz4.end() : lz4.update(data, size)) && file.write(lz4.out.data(), lz4.out.size());
+            compressed_size += lz4.out.size();
+            return ok;
+        }
+        ZSTD_inBuffer input = {data, size, 0};
+        while (true) {
+            ZSTD_outBuffer output = {out.data(), out.size(), 0};
+            size_t remaining = ZSTD_compressStream2(cctx, &output, &input, mode);
+            if (ZSTD_isError(remaining)) {
+                std::cerr << "❌ Compression failed: " << ZSTD_getErrorName(remaining) << "\n";
+                return false;
+            }
+            if (!file.write(out.data(), output.pos)) return false; // Lands in the background while we keep compressing
+            compressed_size += output.pos;
+            if (mode == ZSTD_e_end ? remaining == 0 : input.pos == input.size) return true;
+        }
+    };
+    
+    // Header (zero padded up to the payload offset), then the samples
+    std::vector<char> head(offset, 0);
+    std::memcpy(head.data(), &header, sizeof(header));
+    bool ok = feed(head.data(), head.size(), ZSTD_e_continue);
+    
+    std::vector<uint64_t> checksums;
+    std::thread checksummer = start_checksums(audio, head, flags, format, PAYLOAD_BLOCK_FRAMES, checksums, log);
+    std::vector<char> overview;
+    std::thread overview_builder = start_overview(audio, flags, overview, log);
+    
+    BlockEncoder encoder(flags, format);
+    if (encoder.passthrough()) {
+        ok = ok && feed(reinterpret_cast<const char*>(audio.interleaved_data.data()),
+                        audio.interleaved_data.size() * sizeof(float), ZSTD_e_continue);
+    } else {
+        // Planar, packed and/or shuffled block by block if asked
+        std::vector<char> block;
+        for (int64_t first = 0; ok && first < audio.total_samples; first += PAYLOAD_BLOCK_FRAMES) {
+            size_t frames = std::min<int64_t>(PAYLOAD_BLOCK_FRAMES, audio.total_samples - first);
+            encoder.encode(audio.interleaved_data.data() + first * audio.channels, frames, audio.channels, block);
+            ok = feed(block.data(), block.size(), ZSTD_e_continue);
+        }
+    }
+    if (checksummer.joinable()) {
+        checksummer.join();
+        std::vector<char> table = build_checksum_table(checksums);
+        ok = ok && feed(table.data(), table.size(), ZSTD_e_continue);
+    }
+    ok = ok && feed(nullptr, 0, ZSTD_e_end);
+    
+    // 📈 Overview = a frame of its own after the samples, found through the locator at the end
+    if (overview_builder.joinable()) {
+        overview_builder.join();
+        std::vector<char> frame;
+        ok = ok && compress_overview_frame(cctx, settings, overview, frame) && file.write(frame.data(), frame.size());
+        compressed_size += frame.size();
+    }
+    
+    if (own_cctx) ZSTD_freeCCtx(own_cctx);
+    if (!file.finish()) {
+        std::cerr << "❌ Write failed (disk full?)\n";
+        return false;
+    }
+    if (!ok) return false; // Compression error, already reported
+    
+    float ratio = (float)(payload_bytes + overview.size()) / compressed_size;
+    
+    log << "  ✅ HMICAP7 written: " << compressed_size / 1024.0 / 1024.0 << " MB\n";
+    log << "  📊 Compression ratio: " << ratio << "x 💯\n";
+    
+    return true;
+}
+
+// 🚰 BOUNDED QUEUE BETWEEN PIPELINE STAGES (full queue blocks the producer = backpressure)
+template <typename T>
+struct BoundedQueue {
+    explicit BoundedQueue(size_t capacity) : capacity(capacity) {}
+    
+    // Returns false if the queue was closed (pipeline aborted)
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_full.wait(lock, [&] { return items.size() < capacity || closed; });
+        if (closed) return false;
+        items.push_back(std::move(item));
+        not_empty.notify_one();
+        return true;
+    }
+    
+    // Returns false once the queue is closed AND drained
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_empty.wait(lock, [&] { return !items.empty() || closed; });
+        if (items.empty()) return false;
+        item = std::move(items.front());
+        items.pop_front();
+        not_full.notify_one();
+        return true;
+    }
+    
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+    
+    size_t capacity;
+    bool closed = false;
+    std::deque<T> items;
+    std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+};
+
+using PipelineClock = std::chrono::steady_clock;
+
+double seconds_since(PipelineClock::time_point start) {
+    return std::chrono::duration<double>(PipelineClock::now() - start).count();
+}
+
+// 📊 PER-STAGE OCCUPANCY (busy = real work, starved = waiting on input, blocked = waiting on output)
+struct StageStats {
+    const char* name = "";
+    double busy_seconds = 0.0;
+    double starved_seconds = 0.0;
+    double blocked_seconds = 0.0;
+    int64_t blocks = 0;
+    size_t bytes_out = 0;
+};
+
+// 📦 ONE BLOCK FLOWING THROUGH THE PIPELINE (raw samples → encoded bytes → compressed bytes)
+struct PipelineBlock {
+    std::vector<char> bytes;
+    int64_t frames = 0;
+    bool own_frame = false; // Single-frame HMICAP7: compress after the main frame, on its own (the overview)
+};
+
+// ⏱️ Timed pop/push so every stage gets the same bookkeeping
+template <typename T>
+bool timed_pop(BoundedQueue<T>& queue, T& item, StageStats& stats) {
+    auto wait_start = PipelineClock::now();
+    bool ok = queue.pop(item);
+    stats.starved_seconds += seconds_since(wait_start);
+    return ok;
+}
+
+template <typename T>
+bool timed_push(BoundedQueue<T>& queue, T item, StageStats& stats) {
+    auto wait_start = PipelineClock::now();
+    bool ok = queue.push(std::move(item));
+    stats.blocked_seconds += seconds_since(wait_start);
+    return ok;
+}
+
+void print_pipeline_stats(const std::vector<StageStats>& stages, double wall_seconds, std::ostream& log) {
+    log << "\n⚙️  ═══ PIPELINE STATS ═══ ⚙️\n";
+    log << std::fixed << std::setprecision(2);
+    
+    const StageStats* slowest = &stages.front();
+    for (const auto& stage : stages) {
+        double occupancy = wall_seconds > 0.0 ? stage.busy_seconds / wall_seconds * 100.0 : 0.0;
+        log << "  " << std::left << std::setw(8) << stage.name << std::right
+                  << " busy " << std::setw(7) << stage.busy_seconds << "s ("
+                  << std::setw(5) << occupancy << "%) | starved " << std::setw(6) << stage.starved_seconds
+                  << "s | blocked " << std::setw(6) << stage.blocked_seconds << "s | "
+                  << stage.blocks << " blocks, " << stage.bytes_out / 1024.0 / 1024.0 << " MB out\n";
+        if (stage.busy_seconds > slowest->busy_seconds) slowest = &stage;
+    }
+    
+    log << "  ⏱️  End-to-end: " << wall_seconds << "s (slowest stage: " << slowest->name
+              << " " << slowest->busy_seconds << "s)\n";
+    log << std::defaultfloat << std::setprecision(6);
+}
+
+// 📝 HMICA/HMICA7 TEXT OUTPUT ═══════════════════════════════════════════════
+// The text formats of hmica/ (HMICA.CPP writes them, play.cpp plays them): an info{} block, then
+// per channel "C<n>{" and comma-separated samples at 6 decimals, 5+ samples within 1e-5 of each
+// other written as "first-last=value". HMICA7 is that text through zstd. The text is channel-
+// major, so it's built like HMICA.CPP's pipeline: one RLE thread per channel, all fed the same
+// decoded blocks; C1 streams into the file while C2..N spill to temp files that are appended
+// once C1 closes. Each channel compresses its own zstd frame on its own thread - play.cpp reads
+// concatenated frames, and the HMICA7 source here starts each channel at its frame.
+
+// 🎯 STREAMING RLE ENCODER (HMICA.CPP's, byte for byte: same text as its compress_channel_data)
+struct RleChannelEncoder {
+    int64_t total = 0;          // Samples in the whole channel (decides the trailing comma)
+    float epsilon = 0.00001f;
+    int64_t next_index = 0;
+    int64_t run_start = 0;
+    int64_t run_length = 0;     // 0 = no run open yet
+    float run_value = 0.0f;
+    float pending[5];           // Raw values of a short run (<5 samples are written one by one)
+    
+    void flush_run(std::ostream& out) {
+        if (run_length >= 5) {
+            int64_t end_idx = run_start + run_length - 1;
+            out << run_start << "-" << end_idx << "=" << run_value;
+            if (end_idx < total - 1) out << ",";
+        } else {
+            for (int64_t j = 0; j < run_length; j++) {
+                out << pending[j];
+                if (run_start + j < total - 1) out << ",";
+            }
+        }
+        run_length = 0;
+    }
+    
+    // Feed `count` samples read with `stride` (so interleaved blocks need no de-interleave copy)
+    void feed(const float* samples, size_t count, size_t stride, std::ostream& out) {
+        for (size_t i = 0; i < count; i++) {
+            float sample = samples[i * stride];
+            
+            if (run_length > 0 && std::abs(sample - run_value) < epsilon) {
+                if (run_length < 5) pending[run_length] = sample;
+                run_length++;
+            } else {
+                if (run_length > 0) flush_run(out);
+                run_start = next_index;
+                run_value = sample;
+                pending[0] = sample;
+                run_length = 1;
+            }
+            next_index++;
+        }
+    }
+    
+    void finish(std::ostream& out) {
+        if (run_length > 0) flush_run(out);
+    }
+};
+
+std::string hmica_info_block(const AudioData& audio) {
+    std::stringstream data;
+    data << "info{\n";
+    data << "hz=" << audio.sample_rate << "\n";
+    data << "c=" << audio.channels << "\n";
+    data << "sam=" << audio.total_samples << "\n";
+    data << "}\n\n";
+    return data.str();
+}
+
+// 🏭 PIPELINED TEXT CONVERSION: decode → RLE text (+ zstd) per channel → write
+bool convert_to_hmica(const std::string& input_path, const std::string& output_path, bool compress,
+                      const ConvertSettings& settings, AudioData& audio, std::ostream& log, CodecContexts* contexts = nullptr) {
+    AudioSource src;
+    if (!open_audio_source(input_path, settings, src, true, log, contexts)) {
+        return false;
+    }
+    
+    if (src.total_frames < 0) {
+        std::cerr << "❌ Could not determine the track length up front (needed for sam=)\n";
+        close_audio_source(src);
+        return false;
+    }
+    
+    audio.sample_rate = src.sample_rate;
+    audio.channels = src.channels;
+    audio.total_samples = src.total_frames;
+    audio.native_format = src.native_format;
+    
+    const int channels = audio.channels;
+    std::vector<FILE*> spills(channels, nullptr); // C2..N until C1 is written
+    for (int ch = 1; ch < channels; ch++) {
+        spills[ch] = std::tmpfile();
+        if (!spills[ch]) {
+            std::cerr << "❌ Failed to create a temp file for channel " << ch + 1 << "\n";
+            for (FILE* spill : spills) if (spill) std::fclose(spill);
+            close_audio_source(src);
+            return false;
+        }
+    }
+    
+    AsyncWriter file;
+    if (!open_output(file, output_path, settings, log)) {
+        std::cerr << "❌ Failed to create " << output_path << "\n";
+        for (FILE* spill : spills) if (spill) std::fclose(spill);
+        close_audio_source(src);
+        return false;
+    }
+    
+    const size_t block_frames = PAYLOAD_BLOCK_FRAMES;
+    const size_t queue_depth = 4;
+    
+    log << "\n🏭 Pipelined " << (compress ? "HMICA7" : "HMICA") << " conversion → " << output_path << "\n";
+    log << "  🎨 " << channels << " RLE encoder thread(s)";
+    if (channels > 1) {
+        log << ", C2" << (channels > 2 ? "..C" + std::to_string(channels) : "") << " spilled to temp files until C1 is written";
+    }
+    log << "\n";
+    if (compress) print_compression(settings, settings.zstd_level, false, log);
+    
+    using SharedBlock = std::shared_ptr<const PipelineBlock>;
+    std::vector<std::unique_ptr<BoundedQueue<SharedBlock>>> channel_queues;
+    for (int ch = 0; ch < channels; ch++) {
+        channel_queues.emplace_back(new BoundedQueue<SharedBlock>(queue_depth));
+    }
+    BoundedQueue<PipelineBlock> to_writer(queue_depth);
+    
+    StageStats decode_stats, write_stats;
+    std::vector<StageStats> channel_stats(channels);
+    std::vector<std::string> channel_names(channels);
+    decode_stats.name = "decode";
+    write_stats.name = "write";
+    for (int ch = 0; ch < channels; ch++) {
+        channel_names[ch] = "rle C" + std::to_string(ch + 1);
+        channel_stats[ch].name = channel_names[ch].c_str();
+    }
+    std::vector<size_t> text_bytes(channels, 0);
+    
+    std::atomic<bool> failed{false};
+    auto abort_pipeline = [&]() {
+        failed = true;
+        for (auto& queue : channel_queues) queue->close();
+        to_writer.close();
+    };
+    
+    auto wall_start = PipelineClock::now();
+    
+    // 🎵 DECODER: sanitized interleaved blocks, broadcast to every channel encoder
+    std::thread decoder([&]() {
+        int64_t produced = 0;
+        bool warned_short = false;
+        
+        while (produced < audio.total_samples && !failed) {
+            auto work_start = PipelineClock::now();
+            
+            auto block = std::make_shared<PipelineBlock>();
+            block->frames = std::min<int64_t>(block_frames, audio.total_samples - produced);
+            block->bytes.assign(block->frames * channels * sizeof(float), 0);
+            
+            // sam= promised total_samples frames - missing ones stay silent
+            float* samples = reinterpret_cast<float*>(block->bytes.data());
+            size_t got = read_source_frames(src, samples, block->frames);
+            if (src.failed) {
+                abort_pipeline();
+                break;
+            }
+            if ((int64_t)got < block->frames && !warned_short) {
+                log << "  ⚠️  Decoder ended early at frame " << produced + got << ", padding with silence\n";
+                warned_short = true;
+            }
+            sanitize_samples(samples, block->frames * channels);
+            
+            produced += block->frames;
+            decode_stats.busy_seconds += seconds_since(work_start);
+            decode_stats.blocks++;
+            decode_stats.bytes_out += block->bytes.size();
+            
+            SharedBlock shared = std::move(block);
+            bool ok = true;
+            for (auto& queue : channel_queues) {
+                ok = timed_push(*queue, shared, decode_stats) && ok;
+            }
+            if (!ok) break;
+        }
+        
+        for (auto& queue : channel_queues) queue->close();
+    });
+    
+    // 🎨 ONE CHANNEL: its text (inside its own zstd frame for HMICA7), handed to `out` block by block
+    auto encode_channel = [&](int ch, const std::function<bool(const char*, size_t)>& out) -> bool {
+        StageStats& stats = channel_stats[ch];
+        RleChannelEncoder encoder;
+        encoder.total = audio.total_samples;
+        
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(6);
+        if (ch == 0) text << hmica_info_block(audio);
+        text << "C" << ch + 1 << "{\n";
+        
+        ZSTD_CCtx* cctx = compress ? ZSTD_createCCtx() : nullptr;
+        if (cctx) apply_compression(cctx, settings, settings.zstd_level, false);
+        std::vector<char> packed(compress ? ZSTD_CStreamOutSize() : 0);
+        
+        // Pass the text so far on (the last call ends the frame)
+        auto flush = [&](bool last) -> bool {
+            std::string chunk = text.str();
+            text.str("");
+            text_bytes[ch] += chunk.size();
+            if (!cctx) {
+                stats.bytes_out += chunk.size();
+                return chunk.empty() || out(chunk.data(), chunk.size());
+            }
+            ZSTD_inBuffer input = {chunk.data(), chunk.size(), 0};
+            while (true) {
+                ZSTD_outBuffer output = {packed.data(), packed.size(), 0};
+                size_t remaining = ZSTD_compressStream2(cctx, &output, &input, last ? ZSTD_e_end : ZSTD_e_continue);
+                if (ZSTD_isError(remaining)) {
+                    std::cerr << "❌ Compression failed: " << ZSTD_getErrorName(remaining) << "\n";
+                    return false;
+                }
+                stats.bytes_out += output.pos;
+                if (output.pos > 0 && !out(packed.data(), output.pos)) return false;
+                if (last ? remaining == 0 : input.pos == input.size) return true;
+            }
+        };
+        
+        bool ok = true;
+        SharedBlock block;
+        while (ok && timed_pop(*channel_queues[ch], block, stats)) {
+            auto work_start = PipelineClock::now();
+            double blocked_before = stats.blocked_seconds;
+            encoder.feed(reinterpret_cast<const float*>(block->bytes.data()) + ch, block->frames, channels, text);
+            block.reset();
+            ok = flush(false);
+            stats.blocks++;
+            stats.busy_seconds += seconds_since(work_start) - (stats.blocked_seconds - blocked_before);
+        }
+        if (ok && !failed) {
+            auto work_start = PipelineClock::now();
+            encoder.finish(text);
+            text << (ch < channels - 1 ? "\n}\n\n" : "\n}\n");
+            ok = flush(true);
+            stats.busy_seconds += seconds_since(work_start);
+        }
+        
+        ZSTD_freeCCtx(cctx);
+        if (!ok) abort_pipeline();
+        return ok && !failed;
+    };
+    
+    // Channels 2..N into their temp files
+    std::vector<std::future<bool>> spilled;
+    for (int ch = 1; ch < channels; ch++) {
+        spilled.push_back(std::async(std::launch::async, [&, ch]() {
+            return encode_channel(ch, [&, ch](const char* data, size_t size) {
+                if (std::fwrite(data, 1, size, spills[ch]) == size) return true;
+                std::cerr << "❌ Failed to spill channel " << ch + 1 << " to a temp file (disk full?)\n";
+                return false;
+            });
+        }));
+    }
+    
+    // C1 streams straight to the writer, then the spilled channels follow in order
+    std::thread first_channel([&]() {
+        StageStats& stats = channel_stats[0];
+        auto push = [&](const char* data, size_t size) {
+            PipelineBlock piece;
+            piece.bytes.assign(data, data + size);
+            return timed_push(to_writer, std::move(piece), stats);
+        };
+        bool ok = encode_channel(0, push);
+        
+        for (int ch = 1; ch < channels; ch++) {
+            ok = spilled[ch - 1].get() && ok;
+            if (!ok) continue;
+            std::rewind(spills[ch]);
+            PipelineBlock piece;
+            piece.bytes.resize(IO_CHUNK_BYTES);
+            size_t got;
+            while (ok && (got = std::fread(piece.bytes.data(), 1, piece.bytes.size(), spills[ch])) > 0) {
+                ok = push(piece.bytes.data(), got);
+            }
+            ok = ok && !std::ferror(spills[ch]);
+        }
+        
+        if (!ok) abort_pipeline();
+        to_writer.close();
+    });
+    
+    // 💾 WRITER: append whatever arrives, in order
+    std::thread writer([&]() {
+        PipelineBlock block;
+        bool ok = true;
+        while (ok && timed_pop(to_writer, block, write_stats)) {
+            auto work_start = PipelineClock::now();
+            ok = file.write(block.bytes.data(), block.bytes.size());
+            write_stats.busy_seconds += seconds_since(work_start);
+            write_stats.blocks++;
+            write_stats.bytes_out += block.bytes.size();
+        }
+        
+        auto work_start = PipelineClock::now();
+        ok = file.finish() && ok;
+        write_stats.busy_seconds += seconds_since(work_start);
+        if (!ok) {
+            std::cerr << "❌ Write failed (disk full?)\n";
+            abort_pipeline();
+        }
+    });
+    
+    decoder.join();
+    first_channel.join();
+    writer.join();
+    
+    double wall_seconds = seconds_since(wall_start);
+    close_audio_source(src);
+    for (FILE* spill : spills) if (spill) std::fclose(spill);
+    
+    if (failed) {
+        return false;
+    }
+    
+    std::vector<StageStats> stages = {decode_stats};
+    stages.insert(stages.end(), channel_stats.begin(), channel_stats.end());
+    stages.push_back(write_stats);
+    print_pipeline_stats(stages, wall_seconds, log);
+    
+    size_t total_text = 0;
+    for (size_t bytes : text_bytes) total_text += bytes;
+    size_t file_size = fs::file_size(output_path);
+    log << "\n  ✅ " << (compress ? "HMICA7" : "HMICA") << " written: " << file_size / 1024.0 / 1024.0 << " MB\n";
+    if (compress) {
+        log << "  📊 Compression ratio: " << (float)total_text / file_size << "x 💯\n";
+    }
+    
+    return true;
+}
+
+// 🏭 PIPELINED CONVERSION: decode → encode → zstd → write, each stage on its own thread
+// Blocks flow through bounded queues so every stage works while the others do. Only audio
+// metadata ends up in `audio` - the samples stream straight through to the output file.
+bool convert_pipelined(const std::string& input_path, const std::string& output_path, bool compress,
+                       const ConvertSettings& settings, AudioData& audio, std::ostream& log) {
+    if (settings.text) {
+        return convert_to_hmica(input_path, output_path, compress, settings, audio, log);
+    }
+    
+    AudioSource src;
+    if (!open_audio_source(input_path, settings, src, true, log)) {
+        return false;
+    }
+    
+    if (src.total_frames < 0) {
+        std::cerr << "❌ Could not determine the track length up front (needed for the header)\n";
+        close_audio_source(src);
+        return false;
+    }
+    
+    audio.sample_rate = src.sample_rate;
+    audio.channels = src.channels;
+    audio.total_samples = src.total_frames;
+    audio.native_format = src.native_format;
+    const uint16_t format = resolve_sample_format(settings, audio);
+    
+    AsyncWriter file;
+    if (!open_output(file, output_path, settings, log)) {
+        std::cerr << "❌ Failed to create " << output_path << "\n";
+        close_audio_source(src);
+        return false;
+    }
+    
+    HMICAPHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "HMICAP01", 8);
+    header.sample_rate = audio.sample_rate;
+    header.channels = audio.channels;
+    header.sample_format = format;
+    header.total_samples = audio.total_samples;
+    
+    // Seekable HMICAP7: every decoded block becomes one independent zstd frame
+    const size_t seekable_frames = compress ? seek_block_frames(settings, audio.sample_rate, audio.channels) : 0;
+    if (seekable_frames > 0) {
+        header.flags = HMICAP_FLAG_SEEKABLE;
+        header.block_frames = seekable_frames;
+    }
+    
+    // Shuffled/planar: each pipeline block is one layout block
+    const uint32_t flags = layout_flags(settings, compress);
+    const size_t block_frames = seekable_frames > 0 ? seekable_frames : PAYLOAD_BLOCK_FRAMES;
+    if (flags) {
+        header.flags |= flags;
+        header.block_frames = block_frames;
+    }
+    const size_t queue_depth = 4;
+    const size_t frame_bytes = audio.channels * sizeof(float);
+    const size_t payload_bytes = payload_offset(flags) +
+        payload_samples(audio.total_samples, audio.channels, block_frames, flags) * sample_bytes(format) +
+        checksum_table_bytes(audio.total_samples, block_frames, flags);
+    const size_t overview_bytes = overview_section_bytes(audio.total_samples, audio.channels, flags);
+    
+    log << "\n🏭 Pipelined " << (compress ? "HMICAP7" : "HMICAP") << " conversion → " << output_path << "\n";
+    if (seekable_frames > 0) {
+        log << "  🧭 Seekable: " << seekable_frames << "-frame blocks ("
+                  << (double)seekable_frames / audio.sample_rate << " s each)\n";
+    }
+    print_sample_format(format, log);
+    if (flags & HMICAP_SHUFFLE_FLAGS) {
+        log << "  🔀 " << shuffle_name(flags) << "-shuffled " << block_frames << "-frame blocks\n";
+    }
+    if (flags & HMICAP_FLAG_PLANAR) {
+        log << "  🎚️  Planar " << block_frames << "-frame blocks (channels stored one after another)\n";
+    }
+    if (flags & HMICAP_FLAG_XOR) {
+        log << "  🧬 XOR-delta coding " << block_frames << "-frame blocks (" << XOR_GROUP
+                  << "-sample groups, in the encode stage)\n";
+    }
+    if (flags & HMICAP_FLAG_CHECKSUMS) {
+        log << "  🔒 xxh3 checksum per " << block_frames << "-frame block (hashed in the encode stage)\n";
+    }
+    if (flags & HMICAP_FLAG_OVERVIEW) {
+        print_overview_levels(log);
+        log << " (in the encode stage)\n";
+    }
+    
+    BoundedQueue<PipelineBlock> decoded(queue_depth);
+    BoundedQueue<PipelineBlock> encoded(queue_depth);
+    BoundedQueue<PipelineBlock> compressed(queue_depth);
+    BoundedQueue<PipelineBlock>& to_writer = compress ? compressed : encoded;
+    
+    StageStats decode_stats, encode_stats, zstd_stats, write_stats;
+    decode_stats.name = "decode";
+    encode_stats.name = "encode";
+    zstd_stats.name = settings.lz4 ? "lz4" : "zstd";
+    write_stats.name = "write";
+    
+    std::atomic<bool> failed{false};
+    auto abort_pipeline = [&]() {
+        failed = true;
+        decoded.close();
+        encoded.close();
+        compressed.close();
+    };
+    
+    auto wall_start = PipelineClock::now();
+    
+    // 🎵 DECODER: pull fixed-size blocks out of mpg123/libsndfile
+    std::thread decoder([&]() {
+        int64_t produced = 0;
+        bool warned_short = false;
+        
+        while (produced < audio.total_samples && !failed) {
+            auto work_start = PipelineClock::now();
+            
+            PipelineBlock block;
+            block.frames = std::min<int64_t>(block_frames, audio.total_samples - produced);
+            block.bytes.resize(block.frames * frame_bytes);
+            
+            float* samples = reinterpret_cast<float*>(block.bytes.data());
+            size_t got = read_source_frames(src, samples, block.frames);
+            if (src.failed) {
+                abort_pipeline();
+                break;
+            }
+            
+            // The header promised total_samples frames - pad if the decoder comes up short
+            if ((int64_t)got < block.frames) {
+                if (!warned_short) {
+                    log << "  ⚠️  Decoder ended early at frame " << produced + got << ", padding with silence\n";
+                    warned_short = true;
+                }
+                std::memset(samples + got * audio.channels, 0, (block.frames - got) * frame_bytes);
+            }
+            
+            produced += block.frames;
+            decode_stats.busy_seconds += seconds_since(work_start);
+            decode_stats.blocks++;
+            decode_stats.bytes_out += block.bytes.size();
+            
+            if (!timed_push(decoded, std::move(block), decode_stats)) break;
+        }
+        
+        decoded.close();
+    });
+    
+    // 🎨 ENCODER: header first, then sanitized (planar/packed/shuffled if asked) sample blocks in HMICAP byte order,
+    // then the checksum table (seekable: it becomes one more frame), the overview and the run table or XOR index.
+    // ⏸️ Cutting runs out re-blocks the frames left over, so blocks stay block_frames stored frames.
+    RunSplitter splitter(audio.channels);
+    std::vector<uint64_t> xor_sizes; // HMICAP_FLAG_XOR: coded bytes per block, for the index
+    std::thread encoder([&]() {
+        BlockEncoder layout(flags, format);
+        std::vector<char> encoded_bytes;
+        std::vector<float> stored;
+        std::vector<uint64_t> checksums;
+        std::vector<OverviewBucket> overview;
+        if (flags & HMICAP_FLAG_OVERVIEW) overview.resize(overview_buckets(audio.total_samples, 0) * audio.channels);
+        int64_t scanned = 0;
+        PipelineBlock header_block;
+        header_block.bytes.assign(payload_offset(flags), 0);
+        std::memcpy(header_block.bytes.data(), &header, sizeof(header));
+        encode_stats.bytes_out += header_block.bytes.size();
+        checksums.push_back(XXH3_64bits(header_block.bytes.data(), header_block.bytes.size()));
+        
+        // Lay one payload block out, hash it and hand it on
+        auto emit = [&](PipelineBlock& block) -> bool {
+            if (!layout.passthrough()) {
+                layout.encode(reinterpret_cast<const float*>(block.bytes.data()), block.frames, audio.channels,
+                              encoded_bytes);
+                block.bytes.swap(encoded_bytes);
+            }
+            if (flags & HMICAP_FLAG_CHECKSUMS) checksums.push_back(XXH3_64bits(block.bytes.data(), block.bytes.size()));
+            if (flags & HMICAP_FLAG_XOR) xor_sizes.push_back(block.bytes.size());
+            encode_stats.blocks++;
+            encode_stats.bytes_out += block.bytes.size();
+            return timed_push(encoded, std::move(block), encode_stats);
+        };
+        
+        // ⏸️ Every full block of stored frames (the rest too, once finished)
+        auto emit_stored = [&](bool finished) -> bool {
+            while (splitter.take_block(block_frames, finished, stored)) {
+                PipelineBlock block;
+                block.frames = stored.size() / audio.channels;
+                block.bytes.assign(reinterpret_cast<const char*>(stored.data()),
+                                   reinterpret_cast<const char*>(stored.data() + stored.size()));
+                if (!emit(block)) return false;
+            }
+            return true;
+        };
+        
+        if (timed_push(encoded, std::move(header_block), encode_stats)) {
+            PipelineBlock block;
+            bool ok = true;
+            while (ok && timed_pop(decoded, block, encode_stats)) {
+                auto work_start = PipelineClock::now();
+                double blocked_before = encode_stats.blocked_seconds;
+                sanitize_samples(reinterpret_cast<float*>(block.bytes.data()), block.frames * audio.channels);
+                if (flags & HMICAP_FLAG_OVERVIEW) {
+                    overview_scan(reinterpret_cast<const float*>(block.bytes.data()), scanned, block.frames,
+                                  audio.channels, overview.data());
+                    scanned += block.frames;
+                }
+                if (flags & HMICAP_FLAG_RUNS) {
+                    splitter.feed(reinterpret_cast<const float*>(block.bytes.data()), block.frames);
+                    ok = emit_stored(false);
+                } else {
+                    ok = emit(block);
+                }
+                encode_stats.busy_seconds += seconds_since(work_start) - (encode_stats.blocked_seconds - blocked_before);
+            }
+            if ((flags & HMICAP_FLAG_RUNS) && ok && !failed) {
+                splitter.finish();
+                emit_stored(true);
+            }
+        }
+        
+        if ((flags & HMICAP_FLAG_CHECKSUMS) && !failed) {
+            PipelineBlock table;
+            table.bytes = build_checksum_table(checksums);
+            encode_stats.bytes_out += table.bytes.size();
+            timed_push(encoded, std::move(table), encode_stats);
+        }
+        if ((flags & HMICAP_FLAG_OVERVIEW) && !failed) {
+            PipelineBlock section;
+            section.bytes = build_overview_section(std::move(overview), audio.total_samples, audio.channels);
+            section.own_frame = true;
+            encode_stats.bytes_out += section.bytes.size();
+            timed_push(encoded, std::move(section), encode_stats);
+        }
+        if ((flags & HMICAP_FLAG_RUNS) && !failed) {
+            PipelineBlock run_table;
+            run_table.bytes = build_run_table(splitter, format);
+            encode_stats.bytes_out += run_table.bytes.size();
+            timed_push(encoded, std::move(run_table), encode_stats);
+        }
+        if ((flags & HMICAP_FLAG_XOR) && !failed) {
+            PipelineBlock index;
+            index.bytes = build_xor_index(xor_sizes);
+            encode_stats.bytes_out += index.bytes.size();
+            timed_push(encoded, std::move(index), encode_stats);
+        }
+        
+        encoded.close();
+    });
+    
+    // 🌀 ZSTD: one streaming frame, content size pledged so loaders can size their buffer
+    std::thread compressor;
+    if (compress) {
+        if (settings.zstd_budget <= 0.0) print_compression(settings, settings.zstd_level, seekable_frames == 0, log);
+        compressor = std::thread([&]() {
+            // 🎯 --budget: hold back the first BUDGET_TRIAL_SECONDS of blocks and time them first
+            std::vector<PipelineBlock> held;
+            int level = settings.zstd_level;
+            if (settings.zstd_budget > 0.0) {
+                auto work_start = PipelineClock::now();
+                double blocked_before = zstd_stats.blocked_seconds;
+                int64_t held_frames = 0;
+                std::vector<char> sample;
+                PipelineBlock next;
+                while (held_frames < BUDGET_TRIAL_SECONDS * audio.sample_rate && timed_pop(encoded, next, zstd_stats)) {
+                    if (next.frames > 0) {
+                        sample.insert(sample.end(), next.bytes.begin(), next.bytes.end());
+                        held_frames += next.frames;
+                    }
+                    bool last = next.own_frame;
+                    held.push_back(std::move(next));
+                    if (last) break;
+                }
+                level = pick_budget_level(settings, sample.data(), sample.size(), (double)held_frames / audio.sample_rate, log);
+                print_compression(settings, level, seekable_frames == 0, log);
+                zstd_stats.busy_seconds += seconds_since(work_start) - (zstd_stats.blocked_seconds - blocked_before);
+            }
+            std::reverse(held.begin(), held.end());
+            auto next_block = [&](PipelineBlock& block) {
+                if (held.empty()) return timed_pop(encoded, block, zstd_stats);
+                block = std::move(held.back());
+                held.pop_back();
+                return true;
+            };
+            
+            ZSTD_CCtx* cctx = ZSTD_createCCtx();
+            apply_compression(cctx, settings, level, seekable_frames == 0);
+            ZSTD_CCtx_setPledgedSrcSize(cctx, payload_bytes);
+            
+            const size_t out_chunk = ZSTD_CStreamOutSize();
+            PipelineBlock out_block;
+            out_block.bytes.resize(out_chunk * 8);
+            size_t out_used = 0;
+            
+            // Feed one input block (or the final flush) and forward full output chunks
+            Lz4FrameStream lz4(level, payload_bytes);
+            auto feed = [&](const char* data, size_t size, ZSTD_EndDirective mode) -> bool {
+                if (settings.lz4) {
+                    if (!(mode == ZSTD_e_end ? lz4.end() : lz4.update(data, size))) return false;
+                    if (lz4.out.empty()) return true; // Still filling LZ4's current block
+                    PipelineBlock piece;
+                    piece.bytes = std::move(lz4.out);
+                    zstd_stats.bytes_out += piece.bytes.size();
+                    zstd_stats.blocks++;
+                    return timed_push(compressed, std::move(piece), zstd_stats);
+                }
+                ZSTD_inBuffer input = {data, size, 0};
+                while (true) {
+                    ZSTD_outBuffer output = {out_block.bytes.data(), out_block.bytes.size(), out_used};
+                    size_t remaining = ZSTD_compressStream2(cctx, &output, &input, mode);
+                    out_used = output.pos;
+                    
+                    if (ZSTD_isError(remaining)) {
+                        std::cerr << "❌ Compression failed: " << ZSTD_getErrorName(remaining) << "\n";
+                        return false;
+                    }
+                    
+                    bool finished = (mode == ZSTD_e_end) ? remaining == 0 : input.pos == input.size;
+                    if (out_used == out_block.bytes.size() || (finished && mode == ZSTD_e_end && out_used > 0)) {
+                        out_block.bytes.resize(out_used);
+                        zstd_stats.bytes_out += out_used;
+                        zstd_stats.blocks++;
+                        if (!timed_push(compressed, std::move(out_block), zstd_stats)) return false;
+                        out_block = PipelineBlock();
+                        out_block.bytes.resize(out_chunk * 8);
+                        out_used = 0;
+                    }
+                    if (finished) return true;
+                }
+            };
+            
+            // 🧭 Seekable: each block (the header first) is its own frame, seek table goes last
+            bool ok = true;
+            PipelineBlock block;
+            std::vector<SeekTableEntry> entries;
+            if (seekable_frames > 0) {
+                ZSTD_CCtx_reset(cctx, ZSTD_reset_session_and_parameters);
+                apply_compression(cctx, settings, level, false);
+                
+                while (ok && next_block(block)) {
+                    auto work_start = PipelineClock::now();
+                    PipelineBlock frame;
+                    ok = compress_seekable_frame(cctx, block.bytes.data(), block.bytes.size(), frame.bytes, entries);
+                    zstd_stats.busy_seconds += seconds_since(work_start);
+                    zstd_stats.blocks++;
+                    zstd_stats.bytes_out += frame.bytes.size();
+                    if (ok) ok = timed_push(compressed, std::move(frame), zstd_stats);
+                }
+                
+                if (ok && !failed) {
+                    PipelineBlock table;
+                    table.bytes = build_seek_table(entries);
+                    zstd_stats.bytes_out += table.bytes.size();
+                    ok = timed_push(compressed, std::move(table), zstd_stats);
+                }
+            }
+            
+            bool own_frame = false;
+            while (seekable_frames == 0 && ok && next_block(block)) {
+                if (block.own_frame) {
+                    own_frame = true;
+                    break;
+                }
+                auto work_start = PipelineClock::now();
+                double blocked_before = zstd_stats.blocked_seconds;
+                ok = feed(block.bytes.data(), block.bytes.size(), ZSTD_e_continue);
+                zstd_stats.busy_seconds += seconds_since(work_start) - (zstd_stats.blocked_seconds - blocked_before);
+            }
+            
+            if (seekable_frames == 0 && ok && !failed) {
+                auto work_start = PipelineClock::now();
+                double blocked_before = zstd_stats.blocked_seconds;
+                ok = feed(nullptr, 0, ZSTD_e_end);
+                zstd_stats.busy_seconds += seconds_since(work_start) - (zstd_stats.blocked_seconds - blocked_before);
+            }
+            
+            // 📈 The overview goes after the main frame, as a frame of its own + locator
+            if (own_frame && ok && !failed) {
+                auto work_start = PipelineClock::now();
+                PipelineBlock frame;
+                ok = compress_overview_frame(cctx, settings, block.bytes, frame.bytes);
+                zstd_stats.busy_seconds += seconds_since(work_start);
+                zstd_stats.blocks++;
+                zstd_stats.bytes_out += frame.bytes.size();
+                if (ok) ok = timed_push(compressed, std::move(frame), zstd_stats);
+            }
+            
+            if (!ok) abort_pipeline();
+            ZSTD_freeCCtx(cctx);
+            compressed.close();
+        });
+    }
+    
+    // 💾 WRITER: append whatever arrives, in order (up to IO_QUEUE_DEPTH chunks in flight at once)
+    std::thread writer([&]() {
+        PipelineBlock block;
+        bool ok = true;
+        while (ok && timed_pop(to_writer, block, write_stats)) {
+            auto work_start = PipelineClock::now();
+            ok = file.write(block.bytes.data(), block.bytes.size());
+            write_stats.busy_seconds += seconds_since(work_start);
+            write_stats.blocks++;
+            write_stats.bytes_out += block.bytes.size();
+        }
+        
+        auto work_start = PipelineClock::now();
+        ok = file.finish() && ok;
+        write_stats.busy_seconds += seconds_since(work_start);
+        if (!ok) {
+            std::cerr << "❌ Write failed (disk full?)\n";
+            abort_pipeline();
+        }
+    });
+    
+    decoder.join();
+    encoder.join();
+    if (compressor.joinable()) compressor.join();
+    writer.join();
+    
+    double wall_seconds = seconds_since(wall_start);
+    close_audio_source(src);
+    
+    if (failed) {
+        return false;
+    }
+    
+    std::vector<StageStats> stages = {decode_stats, encode_stats};
+    if (compress) stages.push_back(zstd_stats);
+    stages.push_back(write_stats);
+    print_pipeline_stats(stages, wall_seconds, log);
+    if (flags & HMICAP_FLAG_RUNS) print_run_summary(splitter, audio.sample_rate, audio.channels * sample_bytes(format), log);
+    if (flags & HMICAP_FLAG_XOR) print_xor_summary(xor_sizes, audio.total_samples * frame_bytes, log);
+    
+    size_t file_size = fs::file_size(output_path);
+    log << "\n  ✅ " << (compress ? "HMICAP7" : "HMICAP") << " written: " << file_size / 1024.0 / 1024.0 << " MB\n";
+    if (compress) {
+        log << "  📊 Compression ratio: " << (float)(payload_bytes + overview_bytes) / file_size << "x 💯\n";
+    }
+    
+    return true;
+}
+
+// 🔁 ONE FILE, WHOLE-TRACK PATH (load everything, then write) - used by --sequential and batch workers
+bool convert_file(const std::string& input_path, const std::string& output_path, bool compress,
+                  const ConvertSettings& settings, AudioData& audio, std::ostream& log, CodecContexts* contexts = nullptr) {
+    if (settings.text) {
+        return convert_to_hmica(input_path, output_path, compress, settings, audio, log, contexts); // Streams either way
+    }
+    
+    if (!load_audio(input_path, audio, settings, log, contexts)) {
+        return false;
+    }
+    
+    log << "\n✅ Audio loaded successfully!! 💚\n";
+    if (!compress) {
+        return write_hmicap(output_path, audio, settings, log);
+    }
+    
+    ZSTD_CCtx* cctx = contexts ? contexts->cctx : nullptr;
+    size_t block_frames = seek_block_frames(settings, audio.sample_rate, audio.channels);
+    return block_frames > 0 ? write_hmicap7_seekable(output_path, audio, block_frames, settings, cctx, log)
+                            : write_hmicap7(output_path, audio, settings, log, cctx);
+}
+
+// ♻️ INCREMENTAL CONVERSION CACHE ══════════════════════════════════════════
+// key = xxh3-128 over (source bytes, output format, settings). The manifest is an append-only
+// text file (later lines win), so a crash or a killed run never loses earlier entries.
+
+const char* CACHE_VERSION = "hmicap-cache-5"; // Bump whenever the writers' output bytes change
+const char* CACHE_FILE_NAME = ".hmicap-cache";
+
+struct CacheEntry {
+    std::string key;
+    std::string content_hash;  // xxh3-128 of the source file
+    uintmax_t source_size = 0; // Source stat - unchanged size+mtime skips re-hashing
+    int64_t source_mtime = 0;
+    uintmax_t output_size = 0; // Output stat when it was written - a rewritten or replaced output is a miss
+    uintmax_t output_inode = 0;
+    int64_t output_mtime = 0;
+    std::string output;
+    std::string source;
+};
+
+// 🪪 Size, inode and mtime (ns) of an output file - false if it's gone
+bool stat_output(const std::string& path, CacheEntry& entry) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) return false;
+    entry.output_size = info.st_size;
+    entry.output_inode = info.st_ino;
+    entry.output_mtime = (int64_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+    return true;
+}
+
+bool same_output(const CacheEntry& a, const CacheEntry& b) {
+    return a.output_size == b.output_size && a.output_inode == b.output_inode && a.output_mtime == b.output_mtime;
+}
+
+std::string hash_hex(XXH128_hash_t hash) {
+    char text[33];
+    std::snprintf(text, sizeof(text), "%016llx%016llx", (unsigned long long)hash.high64, (unsigned long long)hash.low64);
+    return text;
+}
+
+std::string cache_path_string(const fs::path& path) {
+    return fs::absolute(path).lexically_normal().string();
+}
+
+// 🔑 HASH A WHOLE FILE (xxh3 runs at memory speed, the read is the real cost - so the
+// next chunks are already being read while this one is hashed)
+bool hash_file(const fs::path& path, std::string& hex, bool direct) {
+    AsyncReader file;
+    if (!file.open(path.string(), direct)) return false;
+    
+    XXH3_state_t* state = XXH3_createState();
+    XXH3_128bits_reset(state);
+    
+    file.start();
+    const char* chunk;
+    size_t length;
+    while (file.next(chunk, length)) {
+        XXH3_128bits_update(state, chunk, length);
+    }
+    bool ok = file.ok();
+    
+    hex = hash_hex(XXH3_128bits_digest(state));
+    XXH3_freeState(state);
+    return ok;
+}
+
+// Everything that changes the output bytes goes into the key
+std::string cache_key(const std::string& content_hash, const std::string& format, const ConvertSettings& settings) {
+    std::ostringstream text;
+    text << CACHE_VERSION << '\n' << content_hash << '\n' << format << '\n'
+         << std::setprecision(17) << settings.start_seconds << '\n' << settings.end_seconds << '\n'
+         << settings.block_seconds << '\n' << settings.shuffle << '\n' << settings.planar << '\n'
+         << settings.sample_format << '\n' << settings.checksums << '\n' << settings.overview << '\n'
+         << settings.runs << '\n' << settings.xor_codec << '\n' << settings.zstd_level << '\n'
+         << settings.zstd_window_log << '\n' << settings.zstd_long_distance << '\n'
+         << (settings.zstd_workers > 0) << '\n' << settings.zstd_budget << '\n' << settings.lz4 << '\n'
+         << settings.page_align;
+    std::string key_text = text.str();
+    return hash_hex(XXH3_128bits(key_text.data(), key_text.size()));
+}
+
+struct ConversionCache {
+    fs::path manifest_path;
+    std::map<std::string, CacheEntry> by_key;
+    std::map<std::string, CacheEntry> by_source;
+    std::map<std::string, std::string> key_by_output; // An output file holds one result: the last key written to it
+    std::mutex mutex;
+    
+    // 📖 LOAD MANIFEST (missing file = empty cache); compacts it when superseded lines pile up
+    void load(const fs::path& path) {
+        manifest_path = path;
+        std::ifstream file(path);
+        size_t lines = 0;
+        
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            
+            std::vector<std::string> fields;
+            std::istringstream columns(line);
+            std::string field;
+            while (std::getline(columns, field, '\t')) fields.push_back(field);
+            if (fields.size() != 9) continue; // Older manifests lack the output inode/mtime - convert again
+            
+            CacheEntry entry;
+            entry.key = fields[0];
+            entry.content_hash = fields[1];
+            entry.source_size = std::strtoull(fields[2].c_str(), nullptr, 10);
+            entry.source_mtime = std::strtoll(fields[3].c_str(), nullptr, 10);
+            entry.output_size = std::strtoull(fields[4].c_str(), nullptr, 10);
+            entry.output_inode = std::strtoull(fields[5].c_str(), nullptr, 10);
+            entry.output_mtime = std::strtoll(fields[6].c_str(), nullptr, 10);
+            entry.output = fields[7];
+            entry.source = fields[8];
+            remember(entry);
+            lines++;
+        }
+        
+        if (lines > 2 * by_key.size() + 64) {
+            fs::path compacted = path;
+            compacted += ".tmp";
+            std::ofstream out(compacted, std::ios::trunc);
+            out << "# " << CACHE_VERSION << " manifest: key, source hash, source size, source mtime, output size, output inode, output mtime, output, source\n";
+            for (const auto& item : by_key) write_line(out, item.second);
+            out.close();
+            
+            std::error_code ec;
+            fs::rename(compacted, path, ec);
+        }
+    }
+    
+    static void write_line(std::ostream& out, const CacheEntry& entry) {
+        out << entry.key << '\t' << entry.content_hash << '\t' << entry.source_size << '\t' << entry.source_mtime
+            << '\t' << entry.output_size << '\t' << entry.output_inode << '\t' << entry.output_mtime
+            << '\t' << entry.output << '\t' << entry.source << '\n';
+    }
+    
+    // Caller holds the mutex (or is load()). Whatever key last wrote an output owns it: an older
+    // key pointing at the same path now names somebody else's audio, so it's forgotten.
+    void remember(const CacheEntry& entry) {
+        auto previous = key_by_output.find(entry.output);
+        if (previous != key_by_output.end() && previous->second != entry.key) {
+            auto stale = by_key.find(previous->second);
+            if (stale != by_key.end() && stale->second.output == entry.output) by_key.erase(stale);
+        }
+        key_by_output[entry.output] = entry.key;
+        by_key[entry.key] = entry;
+        by_source[entry.source] = entry;
+    }
+    
+    // 🔍 CHECK BEFORE CONVERTING. Fills `entry` for record(). Returns true when `output` already
+    // holds the result - either it is the cached file itself or it was hard-linked to it.
+    bool reuse(const std::string& input, const fs::path& output, const std::string& format,
+               const ConvertSettings& settings, CacheEntry& entry, std::string& action) {
+        std::error_code ec;
+        entry = CacheEntry();
+        entry.source = cache_path_string(input);
+        entry.output = cache_path_string(output);
+        entry.source_size = fs::file_size(input, ec);
+        if (ec) return false;
+        entry.source_mtime = fs::last_write_time(input, ec).time_since_epoch().count();
+        if (ec) return false;
+        
+        bool stat_known = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto known = by_source.find(entry.source);
+            if (known != by_source.end() && known->second.source_size == entry.source_size &&
+                known->second.source_mtime == entry.source_mtime) {
+                entry.content_hash = known->second.content_hash;
+                stat_known = true;
+            }
+        }
+        if (entry.content_hash.empty() && !hash_file(input, entry.content_hash, settings.direct)) {
+            return false;
+        }
+        entry.key = cache_key(entry.content_hash, format, settings);
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        auto hit = by_key.find(entry.key);
+        
+        // The cached output must still be the very file that was written (same inode, size and mtime)
+        CacheEntry current;
+        if (hit != by_key.end() && !(stat_output(hit->second.output, current) && same_output(current, hit->second))) {
+            hit = by_key.end();
+        }
+        
+        if (hit == by_key.end()) {
+            // About to be rewritten in place - unlink first so a hard-linked twin keeps its data
+            if (fs::hard_link_count(output, ec) > 1 && !ec) fs::remove(output, ec);
+            return false;
+        }
+        
+        const CacheEntry& cached = hit->second;        
+        if (cached.output == entry.output || fs::equivalent(cached.output, output, ec)) {
+            action = "up to date";
+        } else {
+            fs::remove(output, ec);
+            fs::create_directories(fs::path(entry.output).parent_path(), ec);
+            fs::create_hard_link(cached.output, output, ec);
+            if (ec) {
+                // Different filesystem - a copy still beats decoding + zstd-19
+                ec.clear();
+                fs::copy_file(cached.output, output, fs::copy_options::overwrite_existing, ec);
+                if (ec) return false;
+                action = "copied from " + cached.output;
+            } else {
+                action = "hard-linked to " + cached.output;
+            }
+        }
+        
+        // Nothing new to remember for a plain re-run over an unchanged file
+        if (!stat_output(entry.output, entry)) return false;
+        if (!stat_known || action != "up to date") append(entry);
+        return true;
+    }
+    
+    // 📝 REMEMBER A FINISHED CONVERSION (entry comes from reuse())
+    void record(CacheEntry entry) {
+        if (entry.key.empty() || !stat_output(entry.output, entry)) return;
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        append(entry);
+    }
+    
+    // Caller holds the mutex
+    void append(const CacheEntry& entry) {
+        remember(entry);
+        
+        bool fresh = !fs::exists(manifest_path);
+        std::ofstream out(manifest_path, std::ios::app);
+        if (!out) return;
+        if (fresh) {
+            out << "# " << CACHE_VERSION << " manifest: key, source hash, source size, source mtime, output size, output inode, output mtime, output, source\n";
+        }
+        write_line(out, entry);
+    }
+};
+
+// 📚 BATCH JOB (one input file → one output file)
+struct BatchJob {
+    fs::path input;
+    fs::path output;
+    uintmax_t input_bytes = 0;
+};
+
+bool is_audio_extension(std::string ext) {
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    static const char* known[] = {".mp3", ".wav", ".flac", ".ogg", ".oga", ".aiff", ".aif", ".au", ".caf", ".w64"};
+    for (const char* candidate : known) {
+        if (ext == candidate) return true;
+    }
+    return false;
+}
+
+// HMICA/HMICAP family files the converter transcodes (batch directories pick these up too, except
+// ones already in the output format; watch mode doesn't, so its own outputs never loop back in)
+bool is_transcode_extension(std::string ext) {
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == ".hmica" || ext == ".hmica7" || ext == ".hmicap" || ext == ".hmicap7";
+}
+
+// 📂 COLLECT BATCH INPUTS: every audio (or other-format HMICA/HMICAP) file under a directory,
+// every track of a pack, or one path per line of a list file
+bool collect_batch_jobs(const std::string& batch_path, const fs::path& out_dir, const std::string& extension,
+                        std::vector<BatchJob>& jobs) {
+    std::error_code ec;
+    std::string batch_ext = fs::path(batch_path).extension().string();
+    std::transform(batch_ext.begin(), batch_ext.end(), batch_ext.begin(), ::tolower);
+    
+    if (batch_ext == PACK_EXTENSION && fs::is_regular_file(batch_path)) {
+        // 📦 One mapping of the index: each track becomes "pack:name", laid out like the pack's names
+        InputMapping file;
+        PackIndex pack;
+        if (!file.open(batch_path) || !pack.parse(file.data, file.size)) {
+            std::cerr << "❌ Failed to read the pack index of " << batch_path << "\n";
+            return false;
+        }
+        for (uint32_t i = 0; i < pack.header->tracks; i++) {
+            const std::string name = pack.name(pack.entries[i]);
+            BatchJob job;
+            job.input = batch_path + ":" + name;
+            job.output = out_dir / (name + extension);
+            job.input_bytes = pack.entries[i].length;
+            jobs.push_back(job);
+        }
+    } else if (fs::is_directory(batch_path)) {
+        for (auto it = fs::recursive_directory_iterator(batch_path, ec); !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+            std::string ext = it->path().extension().string();
+            std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+            if (!it->is_regular_file() || !(is_audio_extension(ext) || (is_transcode_extension(ext) && ext != extension))) continue;
+            
+            // Mirror the source folder layout under the output directory
+            fs::path relative = it->path().lexically_relative(batch_path).parent_path();
+            BatchJob job;
+            job.input = it->path();
+            job.output = out_dir / relative / (it->path().stem().string() + extension);
+            jobs.push_back(job);
+        }
+    } else {
+        std::ifstream list(batch_path);
+        if (!list) {
+            std::cerr << "❌ Batch input is neither a directory nor a readable file list: " << batch_path << "\n";
+            return false;
+        }
+        
+        std::string line;
+        while (std::getline(list, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty() || line[0] == '#') continue;
+            
+            BatchJob job;
+            job.input = line;
+            job.output = out_dir / (job.input.stem().string() + extension);
+            jobs.push_back(job);
+        }
+    }
+    
+    if (ec) {
+        std::cerr << "❌ Failed to scan " << batch_path << ": " << ec.message() << "\n";
+        return false;
+    }
+    
+    // Drop missing inputs and output name clashes up front instead of failing mid-run
+    std::vector<BatchJob> valid;
+    std::vector<fs::path> seen_outputs;
+    std::string pack, track;
+    for (auto& job : jobs) {
+        if (!split_pack_path(job.input.string(), pack, track)) job.input_bytes = fs::file_size(job.input, ec);
+        if (ec) {
+            std::cerr << "⚠️  Skipping missing input: " << job.input.string() << "\n";
+            ec.clear();
+            continue;
+        }
+        if (fs::equivalent(job.input, job.output, ec)) {
+            std::cerr << "⚠️  Skipping " << job.input.string() << " (output would overwrite its own input)\n";
+            continue;
+        }
+        ec.clear();
+        if (std::find(seen_outputs.begin(), seen_outputs.end(), job.output) != seen_outputs.end()) {
+            std::cerr << "⚠️  Skipping " << job.input.string() << " (output name clashes with another input)\n";
+            continue;
+        }
+        seen_outputs.push_back(job.output);
+        valid.push_back(job);
+    }
+    jobs.swap(valid);
+    
+    // Biggest files first so one huge track doesn't start last and leave a long tail
+    std::stable_sort(jobs.begin(), jobs.end(), [](const BatchJob& a, const BatchJob& b) {
+        return a.input_bytes > b.input_bytes;
+    });
+    
+    return true;
+}
+
+// 🏭 BATCH MODE: convert many files on a worker pool, then print aggregate throughput
+int run_batch(const std::string& batch_path, const fs::path& out_dir, bool compress, unsigned workers,
+              const ConvertSettings& settings, ConversionCache* cache) {
+    std::vector<BatchJob> jobs;
+    if (!collect_batch_jobs(batch_path, out_dir, output_extension(compress, settings), jobs)) {
+        return 1;
+    }
+    
+    if (jobs.empty()) {
+        std::cerr << "❌ No audio files found in " << batch_path << "\n";
+        return 1;
+    }
+    
+    workers = std::max(1u, std::min<unsigned>(workers, jobs.size()));
+    std::cout << "📚 Batch: " << jobs.size() << " files → " << output_format_name(compress, settings)
+              << " in " << out_dir.string() << " (" << workers << " workers, largest first)\n\n";
+    
+    // Per-file chatter would interleave across workers - each one converts into its own null stream
+    // and only the one-line results reach std::cout
+    std::mutex print_mutex;
+    std::atomic<size_t> next_job{0};
+    std::atomic<size_t> finished{0};
+    std::atomic<size_t> failures{0};
+    std::atomic<size_t> cache_hits{0};
+    uintmax_t input_bytes = 0;
+    uintmax_t output_bytes = 0;
+    double audio_seconds = 0.0;
+    
+    auto wall_start = PipelineClock::now();
+    
+    auto worker = [&]() {
+        std::ostream quiet(nullptr);
+        size_t index;
+        while ((index = next_job.fetch_add(1)) < jobs.size()) {
+            const BatchJob& job = jobs[index];
+            auto job_start = PipelineClock::now();
+            
+            std::error_code ec;
+            fs::create_directories(job.output.parent_path().empty() ? fs::path(".") : job.output.parent_path(), ec);
+            
+            // ♻️ Unchanged source + same settings = nothing to do
+            CacheEntry entry;
+            std::string cache_action;
+            if (cache && cache->reuse(job.input.string(), job.output, output_format_name(compress, settings), settings, entry, cache_action)) {
+                std::lock_guard<std::mutex> lock(print_mutex);
+                size_t done = ++finished;
+                cache_hits++;
+                std::cout << "[" << done << "/" << jobs.size() << "] ♻️  " << job.output.string() << " ("
+                          << cache_action << ")\n" << std::flush;
+                continue;
+            }
+            
+            AudioData audio;
+            bool ok = convert_file(job.input.string(), job.output.string(), compress, settings, audio, quiet);
+            if (ok && cache) cache->record(entry);
+            uintmax_t written = ok ? fs::file_size(job.output, ec) : 0;
+            double job_seconds = seconds_since(job_start);
+            
+            std::lock_guard<std::mutex> lock(print_mutex);
+            size_t done = ++finished;
+            if (ok) {
+                input_bytes += job.input_bytes;
+                output_bytes += written;
+                audio_seconds += (double)audio.total_samples / audio.sample_rate;
+                std::cout << "[" << done << "/" << jobs.size() << "] ✅ " << job.output.string() << " ("
+                          << written / 1024.0 / 1024.0 << " MB, " << job_seconds << "s)\n" << std::flush;
+            } else {
+                failures++;
+                std::cout << "[" << done << "/" << jobs.size() << "] ❌ " << job.input.string() << " failed\n" << std::flush;
+            }
+        }
+    };
+    
+    std::vector<std::thread> pool;
+    for (unsigned i = 0; i < workers; i++) {
+        pool.emplace_back(worker);
+    }
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    
+    double wall_seconds = seconds_since(wall_start);
+    
+    size_t converted = jobs.size() - failures - cache_hits;
+    std::cout << "\n📊 ═══ BATCH COMPLETE ═══ 📊\n";
+    std::cout << "✅ Converted: " << converted << "/" << jobs.size() << " files";
+    if (failures > 0) std::cout << " (❌ " << failures << " failed)";
+    std::cout << "\n";
+    if (cache_hits > 0) std::cout << "♻️  Reused from cache: " << cache_hits << " files\n";
+    std::cout << "⏱️  Wall time: " << wall_seconds << " s on " << workers << " workers\n";
+    std::cout << "📁 Files/s: " << converted / wall_seconds << "\n";
+    std::cout << "📥 Input: " << input_bytes / 1024.0 / 1024.0 << " MB (" << input_bytes / 1024.0 / 1024.0 / wall_seconds << " MB/s)\n";
+    std::cout << "💾 Output: " << output_bytes / 1024.0 / 1024.0 << " MB (" << output_bytes / 1024.0 / 1024.0 / wall_seconds << " MB/s)\n";
+    std::cout << "🎵 Audio: " << audio_seconds << " s → realtime factor " << audio_seconds / wall_seconds << "x 🚀\n";
+    
+    return failures > 0 ? 1 : 0;
+}
+
+// 📦 PACK MODE: every HMICAP/HMICAP7 under a directory (or listed in a file) into one .hmipack.
+// Tracks go in byte for byte - nothing is decoded or recompressed, packing is one sequential copy.
+// The pack is written next to its final name and renamed into place, so a reader never maps a
+// half-written index.
+struct PackJob {
+    fs::path input;
+    std::string name;  // Relative path without the extension (directory), or the file's stem (list)
+    PackEntry entry{};
+};
+
+int run_pack(const std::string& source, const std::string& pack_path, const ConvertSettings& settings) {
+    std::vector<PackJob> jobs;
+    std::error_code ec;
+    
+    if (fs::is_directory(source)) {
+        for (auto it = fs::recursive_directory_iterator(source, ec); !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+            std::string ext = it->path().extension().string();
+            std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+            if (!it->is_regular_file() || (ext != ".hmicap" && ext != ".hmicap7")) continue;
+            
+            PackJob job;
+            job.input = it->path();
+            job.name = it->path().lexically_relative(source).replace_extension().generic_string();
+            jobs.push_back(job);
+        }
+    } else {
+        std::ifstream list(source);
+        if (!list) {
+            std::cerr << "❌ Pack input is neither a directory nor a readable file list: " << source << "\n";
+            return 1;
+        }
+        
+        std::string line;
+        while (std::getline(list, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty() || line[0] == '#') continue;
+            
+            PackJob job;
+            job.input = line;
+            job.name = job.input.stem().string();
+            jobs.push_back(job);
+        }
+    }
+    if (ec) {
+        std::cerr << "❌ Failed to scan " << source << ": " << ec.message() << "\n";
+        return 1;
+    }
+    
+    // 🔍 Index order = name order; read each track's header for its entry
+    std::sort(jobs.begin(), jobs.end(), [](const PackJob& a, const PackJob& b) {
+        return a.name < b.name;
+    });
+    std::vector<PackJob> valid;
+    std::string name_table;
+    for (auto& job : jobs) {
+        if (!valid.empty() && valid.back().name == job.name) {
+            std::cerr << "⚠️  Skipping " << job.input.string() << " (track name clashes with "
+                      << valid.back().input.string() << ")\n";
+            continue;
+        }
+        
+        std::string ext = job.input.extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        const bool compressed = ext == ".hmicap7";
+        InputMapping file;
+        HMICAPHeader header;
+        if (!file.open(job.input.string()) || !read_track_header(file, compressed, header)) {
+            std::cerr << "⚠️  Skipping " << job.input.string() << " (missing, or not a valid "
+                      << (compressed ? "HMICAP7" : "HMICAP") << ")\n";
+            continue;
+        }
+        
+        job.entry.length = file.size;
+        job.entry.total_samples = header.total_samples;
+        job.entry.sample_rate = header.sample_rate;
+        job.entry.channels = header.channels;
+        job.entry.format = compressed ? PACK_TRACK_HMICAP7 : PACK_TRACK_HMICAP;
+        job.entry.header_flags = header.flags;
+        job.entry.name_offset = name_table.size();
+        job.entry.name_length = job.name.size();
+        name_table += job.name;
+        valid.push_back(job);
+    }
+    jobs.swap(valid);
+    
+    if (jobs.empty()) {
+        std::cerr << "❌ No HMICAP/HMICAP7 tracks found in " << source << "\n";
+        return 1;
+    }
+    
+    // 📐 Layout: index pages, then every track on its own PACK_ALIGN boundary
+    PackHeader header{};
+    std::memcpy(header.magic, "HMIPACK1", 8);
+    header.tracks = jobs.size();
+    header.index_bytes = jobs.size() * sizeof(PackEntry) + name_table.size();
+    header.data_offset = pack_align_up(sizeof(PackHeader) + header.index_bytes);
+    
+    std::vector<char> index(header.data_offset, 0);
+    uint64_t offset = header.data_offset;
+    for (size_t i = 0; i < jobs.size(); i++) {
+        jobs[i].entry.offset = offset;
+        offset = pack_align_up(offset + jobs[i].entry.length);
+        std::memcpy(index.data() + sizeof(PackHeader) + i * sizeof(PackEntry), &jobs[i].entry, sizeof(PackEntry));
+    }
+    std::memcpy(index.data() + sizeof(PackHeader) + jobs.size() * sizeof(PackEntry), name_table.data(), name_table.size());
+    header.pack_bytes = jobs.back().entry.offset + jobs.back().entry.length;
+    header.index_checksum = XXH3_64bits(index.data() + sizeof(PackHeader), header.index_bytes);
+    std::memcpy(index.data(), &header, sizeof(header));
+    
+    std::cout << "📦 Packing " << jobs.size() << " tracks into " << pack_path << " ("
+              << header.pack_bytes / 1024.0 / 1024.0 << " MB, " << header.data_offset / 1024 << " KiB index)...\n";
+    
+    auto start = PipelineClock::now();
+    const std::string partial = pack_path + ".partial";
+    AsyncWriter out;
+    if (!open_output(out, partial, settings, std::cout)) {
+        std::cerr << "❌ Failed to create " << partial << "\n";
+        return 1;
+    }
+    
+    bool ok = out.write(index.data(), index.size());
+    const std::vector<char> padding(PACK_ALIGN, 0);
+    for (size_t i = 0; ok && i < jobs.size(); i++) {
+        const PackEntry& entry = jobs[i].entry;
+        InputMapping file;
+        if (!file.open(jobs[i].input.string()) || file.size != entry.length) {
+            std::cerr << "❌ " << jobs[i].input.string() << " changed while packing\n";
+            ok = false;
+            break;
+        }
+        ok = out.write(file.data, file.size);
+        if (ok && i + 1 < jobs.size()) {
+            ok = out.write(padding.data(), jobs[i + 1].entry.offset - entry.offset - entry.length);
+        }
+    }
+    ok = out.finish() && ok;
+    if (ok) {
+        fs::rename(partial, pack_path, ec);
+        ok = !ec;
+    }
+    if (!ok) {
+        std::cerr << "❌ Failed to write " << pack_path << "\n";
+        fs::remove(partial, ec);
+        return 1;
+    }
+    
+    double seconds = seconds_since(start);
+    PackIndex pack;
+    pack.parse(index.data(), header.pack_bytes);
+    print_pack_index(pack);
+    std::cout << "✅ Packed " << jobs.size() << " tracks in " << seconds << " s ("
+              << header.pack_bytes / 1024.0 / 1024.0 / seconds << " MB/s) - play one with "
+              << pack_path << ":" << jobs.front().name << " 🚀\n";
+    return 0;
+}
+
+// 👀 WATCH-FOLDER DAEMON ═══════════════════════════════════════════════════
 
-// 🎧 AUDIO DATA STRUCTURE
-struct AudioData {
-    int sample_rate;
-    int channels;
-    int64_t total_samples;
-    std::vector<float> interleaved_data; // Already interleaved for MAXIMUM SPEED!!
+// Lower value = converted sooner
+enum WatchPriority {
+    PRIORITY_INTERACTIVE = 0, // Typed on stdin - somebody is waiting for it right now
+    PRIORITY_LIVE = 1,        // Just landed in a watched folder
+    PRIORITY_BACKFILL = 2     // Was already there at startup (or got rescanned after an event overflow)
 };
 
-// 🔥 HMICAP HEADER STRUCTURE (32 bytes total - cache line optimized fr fr)
-struct HMICAPHeader {
-    char magic[8];          // "HMICAP01"
-    uint32_t sample_rate;   // Hz
-    uint16_t channels;      // 1=mono, 2=stereo, etc
-    uint16_t reserved1;     // Future use
-    uint64_t total_samples; // Samples per channel
-    uint8_t reserved2[12];  // Future metadata
+const char* priority_name(int priority) {
+    static const char* names[] = {"interactive", "live", "backfill"};
+    return names[priority];
+}
+
+struct WatchJob {
+    std::string input;
+    fs::path output;
+    uintmax_t input_bytes = 0;
+    int priority = PRIORITY_BACKFILL;
+    uint64_t sequence = 0;
 };
 
-// 🎵 MP3 DECODER - STRAIGHT TO INTERLEAVED BABY!!
-bool load_mp3_audio(const std::string& path, AudioData& audio) {
-    std::cout << "🎵 Loading MP3 with mpg123...\n";
-    
-    int err;
-    mpg123_handle* mh = mpg123_new(nullptr, &err);
-    if (!mh) {
-        std::cerr << "❌ Failed to create mpg123 handle\n";
-        return false;
+// Interactive first, then fresh drops, then backfill - smallest files first inside each class
+struct WatchJobOrder {
+    bool operator()(const WatchJob& a, const WatchJob& b) const {
+        if (a.priority != b.priority) return a.priority < b.priority;
+        if (a.input_bytes != b.input_bytes) return a.input_bytes < b.input_bytes;
+        return a.sequence < b.sequence;
     }
+};
+
+// 📬 PRIORITIZED JOB QUEUE - one entry per input path; a file that changes mid-conversion runs again afterwards
+struct WatchQueue {
+    using JobSet = std::set<WatchJob, WatchJobOrder>;
     
-    mpg123_param(mh, MPG123_ADD_FLAGS, MPG123_FORCE_FLOAT, 0.);
+    JobSet jobs;
+    std::map<std::string, JobSet::iterator> queued;
+    std::set<std::string> running;
+    std::map<std::string, WatchJob> rerun;
+    uint64_t next_sequence = 0;
+    bool stopping = false;
+    std::mutex mutex;
+    std::condition_variable ready;
     
-    if (mpg123_open(mh, path.c_str()) != MPG123_OK) {
-        std::cerr << "❌ Failed to open MP3\n";
-        mpg123_delete(mh);
-        return false;
+    void push(const WatchJob& job) {
+        std::lock_guard<std::mutex> lock(mutex);
+        push_locked(job);
     }
     
-    long rate;
-    int channels, encoding;
-    mpg123_getformat(mh, &rate, &channels, &encoding);
-    
-    mpg123_format_none(mh);
-    mpg123_format(mh, rate, channels, MPG123_ENC_FLOAT_32);
+    // Blocks until a job is available; false once stop() was called
+    bool pop(WatchJob& job) {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [&] { return stopping || !jobs.empty(); });
+        if (stopping) return false;
+        
+        job = *jobs.begin();
+        queued.erase(job.input);
+        jobs.erase(jobs.begin());
+        running.insert(job.input);
+        return true;
+    }
     
-    audio.sample_rate = rate;
-    audio.channels = channels;
+    void finish(const std::string& input) {
+        std::lock_guard<std::mutex> lock(mutex);
+        running.erase(input);
+        
+        auto again = rerun.find(input);
+        if (again != rerun.end()) {
+            WatchJob job = again->second;
+            rerun.erase(again);
+            push_locked(job);
+        }
+    }
     
-    std::cout << "  ✅ " << rate << "Hz, " << channels << " channels\n";
+    void stop() {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        ready.notify_all();
+    }
     
-    // Read interleaved samples directly!!
-    size_t buffer_size = mpg123_outblock(mh);
-    std::vector<unsigned char> buffer(buffer_size);
-    size_t done;
-    int read_err;
+    size_t pending() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return jobs.size() + rerun.size();
+    }
     
-    while ((read_err = mpg123_read(mh, buffer.data(), buffer_size, &done)) == MPG123_OK || read_err == MPG123_DONE) {
-        if (done == 0) break;
+    void push_locked(WatchJob job) {
+        job.sequence = next_sequence++;
         
-        float* float_buffer = reinterpret_cast<float*>(buffer.data());
-        size_t num_floats = done / sizeof(float);
-        
-        for (size_t i = 0; i < num_floats; i++) {
-            float sample = float_buffer[i];
-            if (!std::isfinite(sample)) sample = 0.0f;
-            audio.interleaved_data.push_back(std::max(-1.0f, std::min(1.0f, sample)));
+        if (running.count(job.input)) {
+            auto again = rerun.find(job.input);
+            if (again != rerun.end()) job.priority = std::min(job.priority, again->second.priority);
+            rerun[job.input] = job;
+            return;
         }
         
-        if (read_err == MPG123_DONE) break;
+        // Already waiting: keep the better priority, refresh the size
+        auto existing = queued.find(job.input);
+        if (existing != queued.end()) {
+            job.priority = std::min(job.priority, existing->second->priority);
+            jobs.erase(existing->second);
+        }
+        queued[job.input] = jobs.insert(job).first;
+        ready.notify_one();
     }
+};
+
+std::atomic<bool> watch_stop_requested{false};
+
+void request_watch_stop(int) {
+    watch_stop_requested = true;
+}
+
+// 🎯 ONE WATCH JOB - the output mirrors the file's place under its watch root
+WatchJob make_watch_job(const fs::path& input, const fs::path& root, const fs::path& out_dir,
+                        const std::string& extension, int priority) {
+    WatchJob job;
+    job.input = input.string();
+    job.output = out_dir / input.lexically_relative(root).parent_path() / (input.stem().string() + extension);
+    job.priority = priority;
     
-    mpg123_close(mh);
-    mpg123_delete(mh);
-    
-    audio.total_samples = audio.interleaved_data.size() / channels;
-    
-    std::cout << "  📊 Loaded " << audio.total_samples << " samples per channel\n";
-    std::cout << "  ⏱️  Duration: " << (float)audio.total_samples / rate << " seconds\n";
+    std::error_code ec;
+    job.input_bytes = fs::file_size(input, ec);
+    return job;
+}
+
+bool output_up_to_date(const WatchJob& job) {
+    std::error_code ec;
+    auto output_time = fs::last_write_time(job.output, ec);
+    if (ec) return false;
+    auto input_time = fs::last_write_time(job.input, ec);
+    return !ec && output_time >= input_time;
+}
+
+// 🗂️ QUEUE EVERY AUDIO FILE UNDER A DIRECTORY (optionally skipping ones that are already converted)
+size_t queue_existing_files(WatchQueue& queue, const fs::path& dir, const fs::path& root, const fs::path& out_dir,
+                            const std::string& extension, int priority, bool skip_up_to_date) {
+    size_t count = 0;
+    std::error_code ec;
+    for (auto it = fs::recursive_directory_iterator(dir, ec); !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        if (!it->is_regular_file() || !is_audio_extension(it->path().extension().string())) continue;
+        
+        WatchJob job = make_watch_job(it->path(), root, out_dir, extension, priority);
+        if (skip_up_to_date && output_up_to_date(job)) continue;
+        queue.push(job);
+        count++;
+    }
+    return count;
+}
+
+// 📡 INOTIFY WATCHES on every directory under each root (inotify isn't recursive by itself)
+struct WatchTree {
+    int fd = -1;
+    std::map<int, std::pair<fs::path, fs::path>> dirs; // watch descriptor → (directory, watch root)
+};
+
+void add_watch_tree(WatchTree& tree, const fs::path& dir, const fs::path& root) {
+    int wd = inotify_add_watch(tree.fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR);
+    if (wd < 0) {
+        std::cerr << "⚠️  Can't watch " << dir.string() << ": " << std::strerror(errno) << "\n";
+        return;
+    }
+    tree.dirs[wd] = {dir, root};
     
-    return true;
+    std::error_code ec;
+    for (auto it = fs::directory_iterator(dir, ec); !ec && it != fs::directory_iterator(); it.increment(ec)) {
+        if (it->is_directory() && !it->is_symlink()) {
+            add_watch_tree(tree, it->path(), root);
+        }
+    }
 }
 
-// 🎼 LIBSNDFILE LOADER
-bool load_sndfile_audio(const std::string& path, AudioData& audio) {
-    std::cout << "🎼 Loading with libsndfile...\n";
+// 👀 WATCH MODE: convert whatever lands in the watched folders until Ctrl+C / SIGTERM
+int run_watch(const std::vector<std::string>& watch_dirs, const fs::path& out_dir, bool compress, unsigned workers,
+              const ConvertSettings& settings, ConversionCache* cache) {
+    const std::string extension = output_extension(compress, settings);
     
-    SF_INFO sfinfo;
-    SNDFILE* file = sf_open(path.c_str(), SFM_READ, &sfinfo);
+    WatchTree tree;
+    tree.fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (tree.fd < 0) {
+        std::cerr << "❌ inotify_init1 failed: " << std::strerror(errno) << "\n";
+        return 1;
+    }
     
-    if (!file) {
-        std::cerr << "❌ Failed to open audio file\n";
-        return false;
+    std::vector<fs::path> roots;
+    for (const auto& dir : watch_dirs) {
+        fs::path root = fs::path(dir).lexically_normal();
+        if (!root.has_filename() && root.has_parent_path()) root = root.parent_path(); // "music/" → "music"
+        if (!fs::is_directory(root)) {
+            std::cerr << "❌ Not a directory: " << dir << "\n";
+            close(tree.fd);
+            return 1;
+        }
+        roots.push_back(root);
+        add_watch_tree(tree, root, root);
     }
     
-    audio.sample_rate = sfinfo.samplerate;
-    audio.channels = sfinfo.channels;
-    audio.total_samples = sfinfo.frames;
+    std::cout << "👀 Watching " << roots.size() << " folder(s), " << tree.dirs.size() << " directories → "
+              << output_format_name(compress, settings) << " in " << out_dir.string() << " (" << workers << " workers)\n";
+    std::cout << "⌨️  Type a file path + ENTER to convert it ahead of everything else, Ctrl+C to stop\n\n";
+    
+    // Per-file chatter would interleave across workers - each one converts into its own null stream
+    // and reports through log()
+    std::mutex print_mutex;
+    auto log = [&](const std::string& line) {
+        std::lock_guard<std::mutex> lock(print_mutex);
+        std::cout << line << "\n" << std::flush;
+    };
     
-    std::cout << "  ✅ " << sfinfo.samplerate << "Hz, " << sfinfo.channels << " channels\n";
-    std::cout << "  📊 " << sfinfo.frames << " samples per channel\n";
-    std::cout << "  ⏱️  Duration: " << (float)sfinfo.frames / sfinfo.samplerate << " seconds\n";
+    // Watches are already up, so nothing that lands during the backfill scan gets lost
+    WatchQueue queue;
+    size_t backfill = 0;
+    for (const auto& root : roots) {
+        backfill += queue_existing_files(queue, root, root, out_dir, extension, PRIORITY_BACKFILL, true);
+    }
+    log("🗂️  Backfill: " + std::to_string(backfill) + " file(s) need converting");
+    
+    std::atomic<size_t> converted{0};
+    std::atomic<size_t> failures{0};
+    std::atomic<size_t> cache_hits{0};
+    auto uptime_start = PipelineClock::now();
     
-    audio.interleaved_data.resize(sfinfo.frames * sfinfo.channels);
-    sf_count_t read_count = sf_readf_float(file, audio.interleaved_data.data(), sfinfo.frames);
+    // Each worker keeps its mpg123 handle and zstd context for the daemon's whole life
+    auto worker = [&]() {
+        CodecContexts contexts;
+        contexts.mh = create_mp3_handle();
+        contexts.cctx = ZSTD_createCCtx();
+        std::ostream quiet(nullptr);
+        
+        WatchJob job;
+        while (queue.pop(job)) {
+            auto job_start = PipelineClock::now();
+            std::error_code ec;
+            fs::create_directories(job.output.parent_path().empty() ? fs::path(".") : job.output.parent_path(), ec);
+            
+            CacheEntry entry;
+            std::string cache_action;
+            if (cache && cache->reuse(job.input, job.output, output_format_name(compress, settings), settings, entry, cache_action)) {
+                cache_hits++;
+                log(std::string("[") + priority_name(job.priority) + "] ♻️  " + job.output.string() + " (" + cache_action + ")");
+                queue.finish(job.input);
+                continue;
+            }
+            
+            // Write next to the target and rename, so readers never see a half-written file
+            fs::path partial = job.output;
+            partial += ".part";
+            
+            AudioData audio;
+            bool ok = convert_file(job.input, partial.string(), compress, settings, audio, quiet, &contexts);
+            if (ok) {
+                fs::rename(partial, job.output, ec);
+                ok = !ec;
+            }
+            if (ok && cache) {
+                cache->record(entry);
+            }
+            if (!ok) {
+                fs::remove(partial, ec);
+            }
+            
+            std::ostringstream line;
+            line << "[" << priority_name(job.priority) << "] ";
+            if (ok) {
+                converted++;
+                line << "✅ " << job.output.string() << " (" << fs::file_size(job.output, ec) / 1024.0 / 1024.0
+                     << " MB, " << seconds_since(job_start) << "s)";
+            } else {
+                failures++;
+                line << "❌ " << job.input << " failed";
+            }
+            log(line.str());
+            
+            queue.finish(job.input);
+        }
+        
+        if (contexts.mh) mpg123_delete(contexts.mh);
+        ZSTD_freeCCtx(contexts.cctx);
+    };
     
-    if (read_count != sfinfo.frames) {
-        std::cout << "  ⚠️  Only read " << read_count << "/" << sfinfo.frames << " samples\n";
-        audio.total_samples = read_count;
-        audio.interleaved_data.resize(read_count * audio.channels);
+    std::vector<std::thread> pool;
+    for (unsigned i = 0; i < workers; i++) {
+        pool.emplace_back(worker);
     }
     
-    sf_close(file);
+    std::signal(SIGINT, request_watch_stop);
+    std::signal(SIGTERM, request_watch_stop);
     
-    // Sanitize samples
-    for (auto& sample : audio.interleaved_data) {
-        if (!std::isfinite(sample)) sample = 0.0f;
-        sample = std::max(-1.0f, std::min(1.0f, sample));
+    // 🔁 EVENT LOOP: inotify + stdin, woken up regularly to notice a stop request
+    alignas(inotify_event) char events[64 * 1024];
+    std::string typed;
+    bool stdin_open = true;
+    
+    while (!watch_stop_requested) {
+        pollfd fds[2] = {{tree.fd, POLLIN, 0}, {stdin_open ? STDIN_FILENO : -1, POLLIN, 0}};
+        if (poll(fds, 2, 500) < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "❌ poll failed: " << std::strerror(errno) << "\n";
+            break;
+        }
+        
+        if (fds[0].revents & POLLIN) {
+            ssize_t length;
+            while ((length = read(tree.fd, events, sizeof(events))) > 0) {
+                for (char* ptr = events; ptr < events + length; ) {
+                    const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+                    ptr += sizeof(inotify_event) + event->len;
+                    
+                    if (event->mask & IN_Q_OVERFLOW) {
+                        // Events were dropped - fall back to a rescan, the up-to-date check filters the rest
+                        log("⚠️  inotify queue overflowed, rescanning");
+                        for (const auto& root : roots) {
+                            queue_existing_files(queue, root, root, out_dir, extension, PRIORITY_BACKFILL, true);
+                        }
+                        continue;
+                    }
+                    if (event->mask & IN_IGNORED) {
+                        tree.dirs.erase(event->wd);
+                        continue;
+                    }
+                    
+                    auto dir = tree.dirs.find(event->wd);
+                    if (dir == tree.dirs.end() || event->len == 0) continue;
+                    fs::path path = dir->second.first / event->name;
+                    fs::path root = dir->second.second;
+                    
+                    if (event->mask & IN_ISDIR) {
+                        // New folder: watch it, then pick up anything copied in before the watch existed
+                        if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                            add_watch_tree(tree, path, root);
+                            queue_existing_files(queue, path, root, out_dir, extension, PRIORITY_LIVE, false);
+                        }
+                    } else if ((event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) &&
+                               is_audio_extension(path.extension().string())) {
+                        queue.push(make_watch_job(path, root, out_dir, extension, PRIORITY_LIVE));
+                        log("📥 [live] " + path.string());
+                    }
+                }
+            }
+        }
+        
+        if (fds[1].revents & (POLLIN | POLLHUP)) {
+            char chunk[4096];
+            ssize_t length = read(STDIN_FILENO, chunk, sizeof(chunk));
+            if (length <= 0) {
+                stdin_open = false; // Detached from a terminal - keep watching
+                continue;
+            }
+            typed.append(chunk, length);
+            
+            size_t newline;
+            while ((newline = typed.find('\n')) != std::string::npos) {
+                std::string line = typed.substr(0, newline);
+                typed.erase(0, newline + 1);
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                if (line.empty()) continue;
+                
+                fs::path path = line;
+                if (fs::is_directory(path)) {
+                    size_t count = queue_existing_files(queue, path, path, out_dir, extension, PRIORITY_INTERACTIVE, false);
+                    log("📥 [interactive] " + std::to_string(count) + " file(s) from " + line);
+                } else if (fs::is_regular_file(path)) {
+                    queue.push(make_watch_job(path, path.parent_path(), out_dir, extension, PRIORITY_INTERACTIVE));
+                    log("📥 [interactive] " + line);
+                } else {
+                    log("❌ Not found: " + line);
+                }
+            }
+        }
     }
     
-    return true;
+    // Workers finish what they're on; anything still queued is picked up by the next start's backfill
+    log("\n🛑 Stopping, waiting for running conversions...");
+    size_t left = queue.pending();
+    queue.stop();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    close(tree.fd);
+    
+    std::cout << "\n📊 ═══ WATCH STOPPED ═══ 📊\n";
+    std::cout << "✅ Converted: " << converted << " files";
+    if (failures > 0) std::cout << " (❌ " << failures << " failed)";
+    std::cout << "\n";
+    if (cache_hits > 0) std::cout << "♻️  Reused from cache: " << cache_hits << " files\n";
+    std::cout << "⏳ Left in queue: " << left << "\n";
+    std::cout << "⏱️  Uptime: " << seconds_since(uptime_start) << " s\n";
+    
+    return failures > 0 ? 1 : 0;
 }
 
-// 🚀 UNIVERSAL AUDIO LOADER
-bool load_audio(const std::string& path, AudioData& audio) {
-    std::string ext;
-    size_t dot_pos = path.find_last_of('.');
-    if (dot_pos != std::string::npos) {
-        ext = path.substr(dot_pos + 1);
-        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+// 📊 SHUFFLE BENCHMARK: HMICAP7 (zstd 19) ratio and decode speed with no / byte / bit shuffle
+bool bench_shuffle_modes(const AudioData& audio) {
+    using Clock = std::chrono::steady_clock;
+    const size_t count = audio.interleaved_data.size();
+    const size_t bytes = count * sizeof(float);
+    const size_t block_floats = PAYLOAD_BLOCK_FRAMES * audio.channels;
+    auto gbps = [&](double seconds) { return seconds > 0.0 ? bytes / seconds / 1e9 : 0.0; };
+    
+    std::cout << "\n📊 ═══ SHUFFLE BENCHMARK (zstd 19, " << PAYLOAD_BLOCK_FRAMES << "-frame blocks, "
+              << bytes / 1024.0 / 1024.0 << " MB of samples) ═══ 📊\n";
+    std::cout << std::setw(8) << "shuffle" << std::setw(11) << "MB" << std::setw(9) << "ratio"
+              << std::setw(12) << "compress s" << std::setw(11) << "zstd GB/s" << std::setw(13) << "unshuf GB/s"
+              << std::setw(13) << "decode GB/s" << "\n";
+    
+    bool all_exact = true;
+    for (uint32_t shuffle : {0u, HMICAP_FLAG_BYTE_SHUFFLE, HMICAP_FLAG_BIT_SHUFFLE}) {
+        std::vector<char> filtered(bytes);
+        std::vector<uint8_t> scratch;
+        for (size_t first = 0; first < count; first += block_floats) {
+            shuffle_samples(shuffle, reinterpret_cast<const char*>(audio.interleaved_data.data() + first),
+                            std::min(block_floats, count - first), sizeof(float), filtered.data() + first * sizeof(float),
+                            scratch);
+        }
+        
+        auto start = Clock::now();
+        std::vector<char> compressed(ZSTD_compressBound(bytes));
+        size_t compressed_size = ZSTD_compress(compressed.data(), compressed.size(), filtered.data(), bytes, 19);
+        double compress_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (ZSTD_isError(compressed_size)) {
+            std::cerr << "❌ Compression failed: " << ZSTD_getErrorName(compressed_size) << "\n";
+            return false;
+        }
+        
+        // Decode = decompress + unshuffle, best of 3 each
+        std::vector<char> decompressed(bytes);
+        std::vector<float> restored(count);
+        double zstd_seconds = 1e30, unshuffle_seconds = 1e30;
+        for (int run = 0; run < 3; run++) {
+            start = Clock::now();
+            ZSTD_decompress(decompressed.data(), bytes, compressed.data(), compressed_size);
+            zstd_seconds = std::min(zstd_seconds, std::chrono::duration<double>(Clock::now() - start).count());
+            
+            start = Clock::now();
+            for (size_t first = 0; first < count; first += block_floats) {
+                unshuffle_samples(shuffle, decompressed.data() + first * sizeof(float), std::min(block_floats, count - first),
+                                  sizeof(float), reinterpret_cast<char*>(restored.data() + first), scratch);
+            }
+            unshuffle_seconds = std::min(unshuffle_seconds, std::chrono::duration<double>(Clock::now() - start).count());
+        }
+        
+        bool exact = std::memcmp(restored.data(), audio.interleaved_data.data(), bytes) == 0;
+        all_exact = all_exact && exact;
+        
+        std::cout << std::setw(8) << shuffle_name(shuffle) << std::fixed << std::setprecision(2)
+                  << std::setw(11) << compressed_size / 1024.0 / 1024.0
+                  << std::setw(8) << (double)bytes / compressed_size << "x"
+                  << std::setw(12) << compress_seconds
+                  << std::setw(11) << gbps(zstd_seconds)
+                  << std::setw(13) << (shuffle ? gbps(unshuffle_seconds) : 0.0)
+                  << std::setw(13) << gbps(zstd_seconds + (shuffle ? unshuffle_seconds : 0.0))
+                  << (exact ? "" : "  ❌ MISMATCH") << "\n";
     }
+    std::cout << std::defaultfloat << std::setprecision(6);
+    
+    std::cout << (all_exact ? "✅ Every mode round-trips bit-exact\n" : "❌ Round trip mismatch\n");
+    return all_exact;
+}
+
+// 📊 LAYOUT BENCHMARK: interleaved vs planar HMICAP7 (zstd 19, current --shuffle) -
+// ratio, decode (decompress + unshuffle) and the interleave the player does on the way out
+bool bench_layouts(const AudioData& audio, uint32_t shuffle) {
+    using Clock = std::chrono::steady_clock;
+    const size_t sample_bytes = audio.interleaved_data.size() * sizeof(float);
+    auto gbps = [&](double seconds) { return seconds > 0.0 ? sample_bytes / seconds / 1e9 : 0.0; };
+    auto elapsed = [](Clock::time_point start) { return std::chrono::duration<double>(Clock::now() - start).count(); };
     
-    std::cout << "🔍 Detected format: ." << ext << "\n";
+    std::cout << "\n📊 ═══ LAYOUT BENCHMARK (zstd 19, shuffle " << shuffle_name(shuffle) << ", "
+              << PAYLOAD_BLOCK_FRAMES << "-frame blocks, " << sample_bytes / 1024.0 / 1024.0 << " MB of samples) ═══ 📊\n";
+    std::cout << std::setw(12) << "layout" << std::setw(11) << "MB" << std::setw(9) << "ratio"
+              << std::setw(12) << "compress s" << std::setw(13) << "decode GB/s" << std::setw(17) << "interleave GB/s" << "\n";
     
-    if (ext == "mp3") {
-        return load_mp3_audio(path, audio);
+    bool all_exact = true;
+    for (uint32_t planar : {0u, HMICAP_FLAG_PLANAR}) {
+        const uint32_t flags = shuffle | planar;
+        const size_t floats = payload_samples(audio.total_samples, audio.channels, PAYLOAD_BLOCK_FRAMES, flags);
+        
+        std::vector<char> payload(floats * sizeof(float));
+        BlockEncoder encoder(flags, SAMPLE_FLOAT32);
+        std::vector<char> block;
+        size_t position = 0;
+        for (int64_t first = 0; first < audio.total_samples; first += PAYLOAD_BLOCK_FRAMES) {
+            size_t frames = std::min<int64_t>(PAYLOAD_BLOCK_FRAMES, audio.total_samples - first);
+            encoder.encode(audio.interleaved_data.data() + first * audio.channels, frames, audio.channels, block);
+            std::memcpy(payload.data() + position, block.data(), block.size());
+            position += block.size();
+        }
+        
+        auto start = Clock::now();
+        std::vector<char> compressed(ZSTD_compressBound(payload.size()));
+        size_t compressed_size = ZSTD_compress(compressed.data(), compressed.size(), payload.data(), payload.size(), 19);
+        double compress_seconds = elapsed(start);
+        if (ZSTD_isError(compressed_size)) {
+            std::cerr << "❌ Compression failed: " << ZSTD_getErrorName(compressed_size) << "\n";
+            return false;
+        }
+        
+        // Best of 3: decompress + unshuffle into payload order, then payload → interleaved frames
+        std::vector<char> decompressed(payload.size());
+        std::vector<float> decoded(floats), restored(audio.interleaved_data.size());
+        std::vector<uint8_t> scratch;
+        const size_t block_floats = PAYLOAD_BLOCK_FRAMES * audio.channels;
+        double decode_seconds = 1e30, interleave_seconds = 1e30;
+        for (int run = 0; run < 3; run++) {
+            start = Clock::now();
+            ZSTD_decompress(decompressed.data(), decompressed.size(), compressed.data(), compressed_size);
+            for (size_t first = 0; first < floats; first += block_floats) {
+                unshuffle_samples(shuffle, decompressed.data() + first * sizeof(float), std::min(block_floats, floats - first),
+                                  sizeof(float), reinterpret_cast<char*>(decoded.data() + first), scratch);
+            }
+            decode_seconds = std::min(decode_seconds, elapsed(start));
+            
+            start = Clock::now();
+            if (!planar) {
+                std::memcpy(restored.data(), decoded.data(), sample_bytes);
+            } else {
+                for (int64_t first = 0; first < audio.total_samples; first += PAYLOAD_BLOCK_FRAMES) {
+                    size_t frames = std::min<int64_t>(PAYLOAD_BLOCK_FRAMES, audio.total_samples - first);
+                    interleave_planes(decoded.data() + first * audio.channels, planar_stride(frames), audio.channels,
+                                      frames, restored.data() + first * audio.channels);
+                }
+            }
+            interleave_seconds = std::min(interleave_seconds, elapsed(start));
+        }
+        
+        bool exact = restored == audio.interleaved_data;
+        all_exact = all_exact && exact;
+        
+        std::cout << std::setw(12) << (planar ? "planar" : "interleaved") << std::fixed << std::setprecision(2)
+                  << std::setw(11) << compressed_size / 1024.0 / 1024.0
+                  << std::setw(8) << (double)sample_bytes / compressed_size << "x"
+                  << std::setw(12) << compress_seconds
+                  << std::setw(13) << gbps(decode_seconds)
+                  << std::setw(17) << gbps(interleave_seconds)
+                  << (exact ? "" : "  ❌ MISMATCH") << "\n";
     }
+    std::cout << std::defaultfloat << std::setprecision(6);
     
-    return load_sndfile_audio(path, audio);
+    std::cout << (all_exact ? "✅ Both layouts round-trip bit-exact\n" : "❌ Round trip mismatch\n");
+    return all_exact;
 }
 
-// 💾 WRITE HMICAP FILE (UNCOMPRESSED BINARY - RAW SPEED!!)
-bool write_hmicap(const std::string& path, const AudioData& audio) {
-    std::cout << "\n💾 Writing HMICAP file...\n";
+// 📊 SAMPLE FORMAT BENCHMARK: f32 / s24 / s16 / f16 storage (zstd 19, current --shuffle) -
+// size on disk, pack/expand speed and how much of the signal survives
+bool bench_sample_formats(const AudioData& audio, uint32_t shuffle) {
+    using Clock = std::chrono::steady_clock;
+    const size_t count = audio.interleaved_data.size();
+    const size_t float_bytes = count * sizeof(float);
+    const size_t block_samples = PAYLOAD_BLOCK_FRAMES * audio.channels;
+    auto gbps = [&](double seconds) { return seconds > 0.0 ? float_bytes / seconds / 1e9 : 0.0; };
+    auto elapsed = [](Clock::time_point start) { return std::chrono::duration<double>(Clock::now() - start).count(); };
     
-    HMICAPHeader header;
-    std::memset(&header, 0, sizeof(header));
+    double signal = 0.0;
+    for (float sample : audio.interleaved_data) signal += (double)sample * sample;
+    size_t f32_compressed = 0;
     
-    std::memcpy(header.magic, "HMICAP01", 8);
-    header.sample_rate = audio.sample_rate;
-    header.channels = audio.channels;
-    header.total_samples = audio.total_samples;
+    std::cout << "\n📊 ═══ SAMPLE FORMAT BENCHMARK (zstd 19, shuffle " << shuffle_name(shuffle) << ", native "
+              << sample_format_name(audio.native_format) << ", " << float_bytes / 1024.0 / 1024.0 << " MB as f32) ═══ 📊\n";
+    std::cout << std::setw(8) << "format" << std::setw(10) << "raw MB" << std::setw(10) << "zstd MB"
+              << std::setw(9) << "vs f32" << std::setw(11) << "pack GB/s" << std::setw(13) << "expand GB/s"
+              << std::setw(10) << "SNR dB" << "\n";
     
-    std::ofstream file(path, std::ios::binary);
-    if (!file) {
-        std::cerr << "❌ Failed to create HMICAP file\n";
-        return false;
+    for (uint16_t format : {SAMPLE_FLOAT32, SAMPLE_INT24, SAMPLE_INT16, SAMPLE_FLOAT16}) {
+        const size_t width = sample_bytes(format);
+        std::vector<char> packed(count * width);
+        std::vector<float> restored(count);
+        
+        // Best of 3 each way (pack = what the converter pays, expand = what the player pays)
+        double pack_seconds = 1e30, expand_seconds = 1e30;
+        for (int run = 0; run < 3; run++) {
+            auto start = Clock::now();
+            pack_samples(format, audio.interleaved_data.data(), count, packed.data());
+            pack_seconds = std::min(pack_seconds, elapsed(start));
+            
+            start = Clock::now();
+            expand_samples(format, packed.data(), count, restored.data());
+            expand_seconds = std::min(expand_seconds, elapsed(start));
+        }
+        
+        std::vector<char> filtered(packed.size());
+        std::vector<uint8_t> scratch;
+        for (size_t first = 0; first < count; first += block_samples) {
+            shuffle_samples(shuffle, packed.data() + first * width, std::min(block_samples, count - first), width,
+                            filtered.data() + first * width, scratch);
+        }
+        std::vector<char> compressed(ZSTD_compressBound(filtered.size()));
+        size_t compressed_size = ZSTD_compress(compressed.data(), compressed.size(), filtered.data(), filtered.size(), 19);
+        if (ZSTD_isError(compressed_size)) {
+            std::cerr << "❌ Compression failed: " << ZSTD_getErrorName(compressed_size) << "\n";
+            return false;
+        }
+        if (format == SAMPLE_FLOAT32) f32_compressed = compressed_size; // First row = the baseline
+        
+        double noise = 0.0;
+        for (size_t i = 0; i < count; i++) {
+            double error = (double)restored[i] - audio.interleaved_data[i];
+            noise += error * error;
+        }
+        
+        std::cout << std::setw(8) << sample_format_name(format) << std::fixed << std::setprecision(2)
+                  << std::setw(10) << packed.size() / 1024.0 / 1024.0
+                  << std::setw(10) << compressed_size / 1024.0 / 1024.0
+                  << std::setw(8) << (double)f32_compressed / compressed_size << "x"
+                  << std::setw(11) << gbps(pack_seconds)
+                  << std::setw(13) << gbps(expand_seconds);
+        if (noise == 0.0) {
+            std::cout << std::setw(10) << "exact" << "\n";
+        } else {
+            std::cout << std::setw(10) << std::setprecision(1) << 10.0 * std::log10(signal / noise) << "\n";
+        }
     }
+    std::cout << std::defaultfloat << std::setprecision(6);
+    return true;
+}
+
+// 📊 XOR CODEC BENCHMARK: HMICAP7 (zstd 19) vs the XOR-delta codec on the input - size, encode
+// time and decode speed (best of 3, back to interleaved frames), on one core and on all of them
+bool bench_xor_codec(const AudioData& audio) {
+    using Clock = std::chrono::steady_clock;
+    const size_t bytes = audio.interleaved_data.size() * sizeof(float);
+    const int64_t blocks = block_count(audio.total_samples, PAYLOAD_BLOCK_FRAMES);
+    const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    auto gbps = [&](double seconds) { return seconds > 0.0 ? bytes / seconds / 1e9 : 0.0; };
+    auto elapsed = [](Clock::time_point start) { return std::chrono::duration<double>(Clock::now() - start).count(); };
+    
+    std::cout << "\n📊 ═══ XOR CODEC BENCHMARK (" << PAYLOAD_BLOCK_FRAMES << "-frame blocks, "
+              << bytes / 1024.0 / 1024.0 << " MB of samples) ═══ 📊\n";
+    std::cout << std::setw(10) << "codec" << std::setw(11) << "MB" << std::setw(9) << "ratio" << std::setw(11)
+              << "encode s" << std::setw(13) << "decode GB/s" << std::setw(16) << "x" + std::to_string(threads) + " GB/s"
+              << "\n";
     
-    // Write header
-    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    // zstd 19 over the raw payload, the way HMICAP7 stores it (one frame - decodes on one core)
+    auto start = Clock::now();
+    std::vector<char> compressed(ZSTD_compressBound(bytes));
+    size_t compressed_size =
+        ZSTD_compress(compressed.data(), compressed.size(), audio.interleaved_data.data(), bytes, 19);
+    double zstd_encode = elapsed(start);
+    if (ZSTD_isError(compressed_size)) {
+        std::cerr << "❌ Compression failed: " << ZSTD_getErrorName(compressed_size) << "\n";
+        return false;
+    }
+    std::vector<float> restored(audio.interleaved_data.size());
+    double zstd_decode = 1e30;
+    for (int run = 0; run < 3; run++) {
+        start = Clock::now();
+        ZSTD_decompress(restored.data(), bytes, compressed.data(), compressed_size);
+        zstd_decode = std::min(zstd_decode, elapsed(start));
+    }
+    bool zstd_exact = restored == audio.interleaved_data;
     
-    // Write interleaved sample data (ALREADY READY TO GO!!)
-    file.write(reinterpret_cast<const char*>(audio.interleaved_data.data()),
-               audio.interleaved_data.size() * sizeof(float));
+    // XOR: every block coded on its own, so decoding spreads over cores like the player's loader
+    start = Clock::now();
+    std::vector<std::vector<char>> coded(blocks);
+    BlockEncoder encoder(HMICAP_FLAG_XOR, SAMPLE_FLOAT32);
+    size_t coded_size = 0;
+    for (int64_t b = 0; b < blocks; b++) {
+        int64_t first = b * (int64_t)PAYLOAD_BLOCK_FRAMES;
+        size_t frames = std::min<int64_t>(PAYLOAD_BLOCK_FRAMES, audio.total_samples - first);
+        encoder.encode(audio.interleaved_data.data() + first * audio.channels, frames, audio.channels, coded[b]);
+        coded_size += coded[b].size();
+    }
+    coded_size += blocks * sizeof(uint64_t) + sizeof(XorFooter);
+    double xor_encode = elapsed(start);
     
-    file.close();
+    auto decode_all = [&](unsigned workers) {
+        std::fill(restored.begin(), restored.end(), 0.0f);
+        std::atomic<int64_t> next{0};
+        std::atomic<bool> ok{true};
+        auto worker = [&]() {
+            std::vector<float> planes(planar_stride(PAYLOAD_BLOCK_FRAMES) * audio.channels);
+            int64_t b;
+            while ((b = next++) < blocks) {
+                int64_t first = b * (int64_t)PAYLOAD_BLOCK_FRAMES;
+                size_t frames = std::min<int64_t>(PAYLOAD_BLOCK_FRAMES, audio.total_samples - first);
+                size_t stride = planar_stride(frames);
+                if (!xor_decode_block(coded[b].data(), coded[b].size(), frames, audio.channels, planes.data(), stride)) {
+                    ok = false;
+                }
+                interleave_planes(planes.data(), stride, audio.channels, frames, restored.data() + first * audio.channels);
+            }
+        };
+        auto begin = Clock::now();
+        std::vector<std::thread> pool;
+        for (unsigned i = 1; i < workers; i++) pool.emplace_back(worker);
+        worker();
+        for (auto& thread : pool) thread.join();
+        double seconds = elapsed(begin);
+        return ok && restored == audio.interleaved_data ? seconds : -1.0;
+    };
+    double xor_decode = 1e30, xor_parallel = 1e30;
+    bool xor_exact = true;
+    for (int run = 0; run < 3; run++) {
+        double one = decode_all(1), all = decode_all(threads);
+        xor_exact = xor_exact && one >= 0.0 && all >= 0.0;
+        xor_decode = std::min(xor_decode, one);
+        xor_parallel = std::min(xor_parallel, all);
+    }
     
-    size_t file_size = fs::file_size(path);
-    std::cout << "  ✅ HMICAP written: " << file_size / 1024.0 / 1024.0 << " MB\n";
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(10) << "zstd 19" << std::setw(11) << compressed_size / 1024.0 / 1024.0
+              << std::setw(8) << (double)bytes / compressed_size << "x" << std::setw(11) << zstd_encode
+              << std::setw(13) << gbps(zstd_decode) << std::setw(16) << "-"
+              << (zstd_exact ? "" : "  ❌ MISMATCH") << "\n";
+    std::cout << std::setw(10) << "xor" << std::setw(11) << coded_size / 1024.0 / 1024.0
+              << std::setw(8) << (double)bytes / coded_size << "x" << std::setw(11) << xor_encode
+              << std::setw(13) << gbps(xor_decode) << std::setw(16) << gbps(xor_parallel)
+              << (xor_exact ? "" : "  ❌ MISMATCH") << "\n";
+    std::cout << std::defaultfloat << std::setprecision(6);
     
-    return true;
+    std::cout << (zstd_exact && xor_exact ? "✅ Both codecs round-trip bit-exact\n" : "❌ Round trip mismatch\n");
+    return zstd_exact && xor_exact;
 }
 
-// 🌀 WRITE HMICAP7 FILE (ZSTD COMPRESSED - MAXIMUM COMPRESSION!!)
-bool write_hmicap7(const std::string& path, const AudioData& audio) {
-    std::cout << "\n🌀 Writing HMICAP7 file (compressed)...\n";
-    
-    // Build uncompressed HMICAP data in memory
-    std::vector<char> uncompressed_data;
-    uncompressed_data.resize(sizeof(HMICAPHeader) + audio.interleaved_data.size() * sizeof(float));
+// Flush a file to the device and drop it from the page cache (so the next read really hits the disk)
+void drop_cached(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+// 📊 I/O BENCHMARK: the input's HMICAP image written and read back through iostream (the old
+// path - one giant write/read) vs AsyncWriter/AsyncReader, buffered and O_DIRECT. Writes include
+// getting the bytes onto the device, cold reads start with the file evicted from the page cache
+// (O_DIRECT never reads from it, so its cold and warm should match). Best of 3 each.
+bool bench_io(const AudioData& audio) {
+    using Clock = std::chrono::steady_clock;
+    auto elapsed = [](Clock::time_point start) { return std::chrono::duration<double>(Clock::now() - start).count(); };
+    const std::string path = ".hmicap-bench-io.tmp"; // Current directory = where the outputs would go
     
     HMICAPHeader header;
     std::memset(&header, 0, sizeof(header));
@@ -202,96 +5990,582 @@ bool write_hmicap7(const std::string& path, const AudioData& audio) {
     header.sample_rate = audio.sample_rate;
     header.channels = audio.channels;
     header.total_samples = audio.total_samples;
+    const char* samples = reinterpret_cast<const char*>(audio.interleaved_data.data());
+    const size_t sample_size = audio.interleaved_data.size() * sizeof(float);
+    const size_t file_size = sizeof(header) + sample_size;
+    const double megabytes = file_size / 1024.0 / 1024.0;
+    // Page-aligned so the O_DIRECT reads can land in it
+    std::unique_ptr<char, decltype(&std::free)> readback(
+        static_cast<char*>(std::aligned_alloc(IO_ALIGN, io_align_up(file_size))), &std::free);
     
-    // Copy header
-    std::memcpy(uncompressed_data.data(), &header, sizeof(header));
+    auto write_iostream = [&]() {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(samples, sample_size);
+        file.close();
+        return bool(file);
+    };
+    auto write_async = [&](bool direct) {
+        AsyncWriter file;
+        return file.open(path, direct) && file.write(reinterpret_cast<const char*>(&header), sizeof(header)) &&
+               file.write(samples, sample_size) && file.finish();
+    };
+    auto read_iostream = [&]() {
+        std::ifstream file(path, std::ios::binary);
+        return bool(file.read(readback.get(), file_size));
+    };
+    auto read_async = [&](bool direct) {
+        AsyncReader file;
+        return file.open(path, direct) && file.read_at(readback.get(), file_size, 0);
+    };
     
-    // Copy sample data
-    std::memcpy(uncompressed_data.data() + sizeof(header),
-                audio.interleaved_data.data(),
-                audio.interleaved_data.size() * sizeof(float));
+    AsyncReader probe;
+    std::cout << "\n📊 ═══ I/O BENCHMARK (" << std::fixed << std::setprecision(1) << megabytes << " MB HMICAP, "
+              << IO_CHUNK_BYTES / 1024 << " KiB requests x " << IO_QUEUE_DEPTH << " in flight, ./" << path
+              << ") ═══ 📊\n";
+    std::cout << std::setw(14) << "path" << std::setw(12) << "write MB/s" << std::setw(16) << "cold read MB/s"
+              << std::setw(16) << "warm read MB/s" << "\n";
     
-    // Compress with Zstd level 19 (SHEEEESH)
-    size_t compressed_bound = ZSTD_compressBound(uncompressed_data.size());
-    std::vector<char> compressed_data(compressed_bound);
+    bool ok = true;
+    for (int engine = 0; engine < 3 && ok; engine++) {
+        const bool direct = engine == 2;
+        double write_seconds = 1e30, cold_seconds = 1e30, warm_seconds = 1e30;
+        for (int run = 0; run < 3 && ok; run++) {
+            auto start = Clock::now();
+            ok = engine ? write_async(direct) : write_iostream();
+            drop_cached(path); // Counts the flush to the device as part of the write
+            write_seconds = std::min(write_seconds, elapsed(start));
+            
+            start = Clock::now();
+            ok = ok && (engine ? read_async(direct) : read_iostream());
+            cold_seconds = std::min(cold_seconds, elapsed(start));
+            
+            start = Clock::now();
+            ok = ok && (engine ? read_async(direct) : read_iostream());
+            warm_seconds = std::min(warm_seconds, elapsed(start));
+            
+            ok = ok && std::memcmp(readback.get() + sizeof(header), samples, sample_size) == 0;
+            std::memset(readback.get(), 0, file_size);
+        }
+        if (!ok) break;
+        const char* name = engine ? probe.engine() : "iostream";
+        if (direct) name = probe.open(path, true) && probe.direct() ? "O_DIRECT" : "no O_DIRECT";
+        std::cout << std::setw(14) << name << std::setprecision(1)
+                  << std::setw(12) << megabytes / write_seconds << std::setw(16) << megabytes / cold_seconds
+                  << std::setw(16) << megabytes / warm_seconds << "\n";
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
     
-    std::cout << "  🔄 Compressing " << uncompressed_data.size() / 1024.0 / 1024.0 << " MB...\n";
+    std::error_code ec;
+    fs::remove(path, ec);
+    if (!ok) std::cerr << "❌ I/O benchmark failed (write error or read-back mismatch)\n";
+    return ok;
+}
+
+// 📊 PROFILE BENCHMARK: every --profile on the input as a single-frame HMICAP7 (current --shuffle,
+// --planar, --sample-format and checksums; no overview - that loads on its own). Size, compress
+// time and ms-to-ready: the file read back (cold = evicted from the page cache first, warm =
+// cached), decompressed, checksum-verified and unshuffled, which is what the player's
+// load_hmicap7 does before the first sample can play. Best of 3.
+bool bench_profiles(const AudioData& audio, const ConvertSettings& base) {
+    using Clock = std::chrono::steady_clock;
+    auto elapsed = [](Clock::time_point start) { return std::chrono::duration<double>(Clock::now() - start).count(); };
+    const std::string path = ".hmicap-bench-profile.tmp"; // Current directory = where the outputs would go
+    const uint16_t format = resolve_sample_format(base, audio);
+    const size_t width = sample_bytes(format);
+    const unsigned workers = std::max(1u, std::thread::hardware_concurrency());
     
-    size_t compressed_size = ZSTD_compress(compressed_data.data(), compressed_bound,
-                                           uncompressed_data.data(), uncompressed_data.size(), 19);
+    std::cout << "\n📊 ═══ PROFILE BENCHMARK (" << (double)audio.total_samples / audio.sample_rate << " s, shuffle "
+              << shuffle_name(base.shuffle) << ", ready = read + decompress + verify + unshuffle, best of 3, ./"
+              << path << ") ═══ 📊\n";
+    std::cout << std::setw(12) << "profile" << std::setw(10) << "MB" << std::setw(9) << "ratio"
+              << std::setw(12) << "compress s" << std::setw(12) << "decode ms" << std::setw(11) << "cold ms"
+              << std::setw(11) << "warm ms" << "\n";
     
-    if (ZSTD_isError(compressed_size)) {
-        std::cerr << "❌ Compression failed: " << ZSTD_getErrorName(compressed_size) << "\n";
-        return false;
+    ZSTD_CCtx* cctx = ZSTD_createCCtx();
+    std::vector<char> payload, block, compressed, readback, decoded, unshuffled;
+    std::vector<uint8_t> scratch;
+    bool ok = true;
+    for (const auto& profile : COMPRESSION_PROFILES) {
+        if (profile.lz4 && !HMICAP_HAVE_LZ4) {
+            std::cout << std::setw(12) << profile.name << "   (skipped - built without LZ4)\n";
+            continue;
+        }
+        ConvertSettings settings = base;
+        apply_profile(profile, workers, settings);
+        settings.overview = false;
+        const uint32_t flags = layout_flags(settings, true);
+        const uint32_t shuffle = flags & HMICAP_SHUFFLE_FLAGS;
+        const size_t offset = payload_offset(flags);
+        const size_t stored = payload_samples(audio.total_samples, audio.channels, PAYLOAD_BLOCK_FRAMES, flags) * width;
+        
+        // Header + samples + checksum table, the bytes write_hmicap7 streams through the compressor
+        HMICAPHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, "HMICAP01", 8);
+        header.sample_rate = audio.sample_rate;
+        header.channels = audio.channels;
+        header.sample_format = format;
+        header.total_samples = audio.total_samples;
+        header.flags = flags;
+        if (flags) header.block_frames = PAYLOAD_BLOCK_FRAMES;
+        payload.assign(offset, 0);
+        std::memcpy(payload.data(), &header, sizeof(header));
+        std::vector<uint64_t> checksums;
+        if (flags & HMICAP_FLAG_CHECKSUMS) checksums = payload_checksums(audio, payload, flags, format, PAYLOAD_BLOCK_FRAMES);
+        BlockEncoder encoder(flags, format);
+        for (int64_t first = 0; first < audio.total_samples; first += PAYLOAD_BLOCK_FRAMES) {
+            size_t frames = std::min<int64_t>(PAYLOAD_BLOCK_FRAMES, audio.total_samples - first);
+            encoder.encode(audio.interleaved_data.data() + first * audio.channels, frames, audio.channels, block);
+            payload.insert(payload.end(), block.begin(), block.end());
+        }
+        if (!checksums.empty()) {
+            std::vector<char> table = build_checksum_table(checksums);
+            payload.insert(payload.end(), table.begin(), table.end());
+        }
+        
+        auto start = Clock::now();
+        if (settings.lz4) {
+            ok = lz4_compress_frame(settings.zstd_level, payload.data(), payload.size(), compressed);
+        } else {
+            ZSTD_CCtx_reset(cctx, ZSTD_reset_session_and_parameters);
+            apply_compression(cctx, settings, settings.zstd_level, true);
+            compressed.resize(ZSTD_compressBound(payload.size()));
+            size_t written = ZSTD_compress2(cctx, compressed.data(), compressed.size(), payload.data(), payload.size());
+            ok = !ZSTD_isError(written);
+            compressed.resize(ok ? written : 0);
+        }
+        const double compress_seconds = elapsed(start);
+        {
+            std::ofstream file(path, std::ios::binary);
+            ok = ok && file.write(compressed.data(), compressed.size());
+        }
+        if (!ok) break;
+        
+        // Playable = decompressed (codec from the frame magic), blocks verified, planes unshuffled
+        auto make_ready = [&](const std::vector<char>& bytes) {
+            uint32_t magic = 0;
+            if (bytes.size() >= 4) std::memcpy(&magic, bytes.data(), 4);
+            if (magic == ZSTD_MAGICNUMBER) {
+                unsigned long long size = ZSTD_getFrameContentSize(bytes.data(), bytes.size());
+                if (size == ZSTD_CONTENTSIZE_ERROR || size == ZSTD_CONTENTSIZE_UNKNOWN) return false;
+                decoded.resize(size);
+                if (ZSTD_decompress(decoded.data(), size, bytes.data(), bytes.size()) != size) return false;
+            } else if (!lz4_decompress_frame(bytes.data(), bytes.size(), decoded)) {
+                return false;
+            }
+            if (decoded.size() < offset + stored) return false;
+            if (!checksums.empty()) {
+                const char* table = decoded.data() + offset + stored; // Little-endian xxh3-64 per entry
+                auto matches = [&](size_t entry, const char* data, size_t size) {
+                    uint64_t hash = XXH3_64bits(data, size);
+                    return std::memcmp(&hash, table + entry * sizeof(uint64_t), sizeof(hash)) == 0;
+                };
+                if (!matches(0, decoded.data(), offset)) return false;
+                size_t position = offset;
+                for (size_t entry = 1; entry < checksums.size(); entry++) {
+                    size_t size = block_bytes(audio.total_samples, audio.channels, width, PAYLOAD_BLOCK_FRAMES, flags, entry - 1);
+                    if (!matches(entry, decoded.data() + position, size)) return false;
+                    position += size;
+                }
+            }
+            if (shuffle) {
+                const size_t block_samples = PAYLOAD_BLOCK_FRAMES * audio.channels;
+                const size_t total = stored / width;
+                unshuffled.resize(stored);
+                for (size_t first = 0; first < total; first += block_samples) {
+                    unshuffle_samples(shuffle, decoded.data() + offset + first * width, std::min(block_samples, total - first),
+                                      width, unshuffled.data() + first * width, scratch);
+                }
+            }
+            return true;
+        };
+        
+        double decode_seconds = 1e30, cold_seconds = 1e30, warm_seconds = 1e30;
+        for (int run = 0; run < 3 && ok; run++) {
+            start = Clock::now();
+            ok = make_ready(compressed);
+            decode_seconds = std::min(decode_seconds, elapsed(start));
+            
+            for (bool cold : {true, false}) {
+                if (cold) drop_cached(path);
+                start = Clock::now();
+                AsyncReader file;
+                readback.resize(compressed.size());
+                ok = ok && file.open(path) && file.read_at(readback.data(), readback.size(), 0) && make_ready(readback);
+                (cold ? cold_seconds : warm_seconds) = std::min(cold ? cold_seconds : warm_seconds, elapsed(start));
+            }
+        }
+        ok = ok && std::memcmp(decoded.data(), payload.data(), payload.size()) == 0;
+        if (!ok) {
+            std::cerr << "❌ " << profile.name << " didn't load back bit-exact\n";
+            break;
+        }
+        
+        std::cout << std::setw(12) << profile.name << std::fixed << std::setprecision(2)
+                  << std::setw(10) << compressed.size() / 1024.0 / 1024.0
+                  << std::setw(8) << (double)payload.size() / compressed.size() << "x"
+                  << std::setw(12) << compress_seconds << std::setprecision(1)
+                  << std::setw(12) << decode_seconds * 1000.0 << std::setw(11) << cold_seconds * 1000.0
+                  << std::setw(11) << warm_seconds * 1000.0 << "\n";
     }
+    std::cout << std::defaultfloat << std::setprecision(6);
+    ZSTD_freeCCtx(cctx);
     
-    // Write compressed data
-    std::ofstream file(path, std::ios::binary);
-    if (!file) {
-        std::cerr << "❌ Failed to create HMICAP7 file\n";
+    std::error_code ec;
+    fs::remove(path, ec);
+    return ok;
+}
+
+// 📛 "HMICAP", "HMICAP7", "HMICA" or "HMICA7" (already upper case) - false for anything else
+bool parse_output_format(const std::string& format, ConvertSettings& settings) {
+    if (format != "HMICAP" && format != "HMICAP7" && format != "HMICA" && format != "HMICA7") return false;
+    settings.text = format.compare(0, 6, "HMICAP") != 0;
+    return true;
+}
+
+// Options that only some output formats have
+bool check_output_format(const std::string& format, const ConvertSettings& settings) {
+    if (settings.xor_codec && format != "HMICAP") {
+        std::cerr << "❌ --xor is an HMICAP codec (" << format << " is " << (settings.text ? "text" : "zstd") << ")\n";
+        return false;
+    }
+    if (settings.lz4 && format == "HMICA7") {
+        std::cerr << "❌ HMICA7 is zstd text (--profile lz4 is HMICAP7 only)\n";
         return false;
     }
+    return true;
+}
+
+// 📖 USAGE
+void print_usage(const char* argv0) {
+    std::cout << "Usage: " << argv0 << " [options] [input] [HMICAP|HMICAP7|HMICA|HMICA7]\n";
+    std::cout << "       " << argv0 << " --batch DIR|LIST [options] HMICAP|HMICAP7|HMICA|HMICA7\n";
+    std::cout << "       " << argv0 << " --watch DIR [--watch DIR...] [options] HMICAP|HMICAP7|HMICA|HMICA7\n";
+    std::cout << "       " << argv0 << " --pack FILE.hmipack DIR|LIST\n";
+    std::cout << "  Inputs: MP3/WAV/FLAC/OGG/AIFF, or .hmica/.hmica7/.hmicap/.hmicap7 to transcode between the four\n";
+    std::cout << "  (a packed track is FILE.hmipack:NAME; --batch FILE.hmipack converts every track of a pack)\n";
+    std::cout << "  (HMICA/HMICA7 are hmica/'s text formats: they take --start/--end and --profile, no layout options)\n";
+    std::cout << "  --start TIME   Convert from TIME (seconds or m:ss, default 0)\n";
+    std::cout << "  --end TIME     Convert up to TIME (default: end of track)\n";
+    std::cout << "  --sequential   Decode everything, then encode, then compress (no pipeline)\n";
+    std::cout << "  --seekable     HMICAP7 as independent 1 s zstd frames + seek table (play/seek from anywhere)\n";
+    std::cout << "  --block-seconds S  Seekable block length (implies --seekable)\n";
+    std::cout << "  --shuffle byte|bit  HMICAP7: store byte (or bit) planes together per block before zstd\n";
+    std::cout << "  --bench-shuffle     Compare none/byte/bit shuffle on the input: ratio and decode GB/s\n";
+    std::cout << "  --planar       Store each block channel by channel (aligned planes) instead of interleaved\n";
+    std::cout << "  --bench-layout      Compare interleaved vs planar HMICAP7 on the input (uses --shuffle)\n";
+    std::cout << "  --sample-format f32|s24|s16|f16|auto  On-disk sample format (default f32; auto = the source's own depth)\n";
+    std::cout << "  --bench-format      Compare f32/s24/s16/f16 storage on the input: size, speed, SNR (uses --shuffle)\n";
+    std::cout << "  --profile NAME HMICAP7 zstd profile (default max):\n";
+    for (const auto& profile : COMPRESSION_PROFILES) {
+        std::cout << "                   " << std::left << std::setw(12) << profile.name << std::right << profile.summary << "\n";
+    }
+    std::cout << "  --budget S     HMICAP7: strongest zstd level that compresses a minute of audio in S seconds\n";
+    std::cout << "                 (timed on a " << BUDGET_TRIAL_SECONDS << " s trial slice; keeps the profile's window/LDM/workers)\n";
+    std::cout << "  --no-checksums Don't store per-block xxh3 checksums (smaller file, no corruption detection)\n";
+    std::cout << "  --no-overview  Don't store the min/max/RMS overview pyramid (waveform without decoding)\n";
+    std::cout << "  --runs         HMICAP: cut constant runs (digital silence) out of the payload (needs this tree's player)\n";
+    std::cout << "  --page-align   HMICAP: payload on its own 4 KiB page for O_DIRECT reads (needs this tree's player)\n";
+    std::cout << "  --direct       Write outputs and hash sources with O_DIRECT (big batches don't flush the page cache)\n";
+    std::cout << "  --xor          HMICAP: XOR-delta code the float32 blocks (Gorilla-style, no zstd; decoded on load)\n";
+    std::cout << "  --bench-xor         Compare the XOR codec with HMICAP7 zstd 19 on the input: ratio and decode GB/s\n";
+    std::cout << "  --bench-io          Write/read the input's HMICAP image via iostream vs async I/O (in the current directory)\n";
+    std::cout << "  --bench-profiles    Every --profile on the input: size, compress time, ms-to-ready (in the current directory)\n";
+    std::cout << "  --batch PATH   Convert every audio file under a directory, or each path listed in a file\n";
+    std::cout << "  --watch DIR    Keep running and convert files as they appear in DIR (repeatable)\n";
+    std::cout << "  --pack FILE    Pack every .hmicap/.hmicap7 under DIR (or listed in LIST) into one indexed .hmipack\n";
+    std::cout << "  --jobs N       Batch/watch worker count (default: all cores)\n";
+    std::cout << "  --out DIR      Batch/watch output directory (default: current directory)\n";
+    std::cout << "  --cache FILE   Conversion cache manifest (default: .hmicap-cache in the output directory)\n";
+    std::cout << "  --no-cache     Always convert, even when source, format and settings are unchanged\n";
+    std::cout << "Missing input/format are asked for interactively.\n";
+}
+
+int main(int argc, char* argv[]) {
+    ConvertSettings settings;
+    std::string input_path;
+    std::string format;
+    bool sequential = false;
+    std::string batch_path;
+    std::string pack_path;
+    std::vector<std::string> watch_dirs;
+    std::string out_dir = ".";
+    std::string cache_path;
+    bool use_cache = true;
+    bool bench_shuffle = false;
+    bool bench_layout = false;
+    bool bench_format = false;
+    bool bench_io_paths = false;
+    bool bench_xor = false;
+    bool bench_compression = false;
+    unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+    const CompressionProfile* profile = find_compression_profile("max");
     
-    file.write(compressed_data.data(), compressed_size);
-    file.close();
+    // 🎛️ COMMAND LINE
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        
+        if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg == "--start" || arg == "--end") {
+            double& target = (arg == "--start") ? settings.start_seconds : settings.end_seconds;
+            if (i + 1 >= argc || !parse_time_arg(argv[++i], target)) {
+                std::cerr << "❌ " << arg << " needs a time like 42, 42.5 or 1:30\n";
+                return 1;
+            }
+        } else if (arg == "--sequential") {
+            sequential = true;
+        } else if (arg == "--seekable") {
+            if (settings.block_seconds <= 0.0) settings.block_seconds = 1.0;
+        } else if (arg == "--block-seconds") {
+            settings.block_seconds = i + 1 < argc ? std::atof(argv[++i]) : 0.0;
+            if (settings.block_seconds <= 0.0) {
+                std::cerr << "❌ --block-seconds needs a positive number of seconds\n";
+                return 1;
+            }
+        } else if (arg == "--shuffle") {
+            settings.shuffle = i + 1 < argc ? parse_shuffle_arg(argv[++i]) : 0;
+            if (!settings.shuffle) {
+                std::cerr << "❌ --shuffle needs byte or bit\n";
+                return 1;
+            }
+        } else if (arg == "--bench-shuffle") {
+            bench_shuffle = true;
+        } else if (arg == "--planar") {
+            settings.planar = true;
+        } else if (arg == "--bench-layout") {
+            bench_layout = true;
+        } else if (arg == "--sample-format") {
+            if (i + 1 >= argc || !parse_sample_format_arg(argv[++i], settings.sample_format)) {
+                std::cerr << "❌ --sample-format needs f32, s24, s16, f16 or auto\n";
+                return 1;
+            }
+        } else if (arg == "--bench-format") {
+            bench_format = true;
+        } else if (arg == "--bench-io") {
+            bench_io_paths = true;
+        } else if (arg == "--no-checksums") {
+            settings.checksums = false;
+        } else if (arg == "--no-overview") {
+            settings.overview = false;
+        } else if (arg == "--runs") {
+            settings.runs = true;
+        } else if (arg == "--page-align") {
+            settings.page_align = true;
+        } else if (arg == "--direct") {
+            settings.direct = true;
+        } else if (arg == "--xor") {
+            settings.xor_codec = true;
+        } else if (arg == "--bench-xor") {
+            bench_xor = true;
+        } else if (arg == "--bench-profiles") {
+            bench_compression = true;
+        } else if (arg == "--profile") {
+            profile = i + 1 < argc ? find_compression_profile(argv[++i]) : nullptr;
+            if (!profile) {
+                std::cerr << "❌ --profile needs one of:";
+                for (const auto& known : COMPRESSION_PROFILES) std::cerr << " " << known.name;
+                std::cerr << "\n";
+                return 1;
+            }
+        } else if (arg == "--budget") {
+            settings.zstd_budget = i + 1 < argc ? std::atof(argv[++i]) : 0.0;
+            if (settings.zstd_budget <= 0.0) {
+                std::cerr << "❌ --budget needs a positive number of seconds per audio minute\n";
+                return 1;
+            }
+        } else if (arg == "--batch" || arg == "--out" || arg == "--pack") {
+            if (i + 1 >= argc) {
+                std::cerr << "❌ " << arg << " needs a path\n";
+                return 1;
+            }
+            (arg == "--batch" ? batch_path : arg == "--out" ? out_dir : pack_path) = argv[++i];
+        } else if (arg == "--no-cache") {
+            use_cache = false;
+        } else if (arg == "--cache") {
+            if (i + 1 >= argc) {
+                std::cerr << "❌ --cache needs a path\n";
+                return 1;
+            }
+            cache_path = argv[++i];
+        } else if (arg == "--watch") {
+            if (i + 1 >= argc) {
+                std::cerr << "❌ --watch needs a directory\n";
+                return 1;
+            }
+            watch_dirs.push_back(argv[++i]);
+        } else if (arg == "--jobs") {
+            int count = i + 1 < argc ? std::atoi(argv[++i]) : 0;
+            if (count <= 0) {
+                std::cerr << "❌ --jobs needs a positive number\n";
+                return 1;
+            }
+            jobs = count;
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            print_usage(argv[0]);
+            return 1;
+        } else if (input_path.empty()) {
+            input_path = arg;
+        } else if (format.empty()) {
+            format = arg;
+        } else {
+            std::cerr << "❌ Too many arguments: " << arg << "\n";
+            return 1;
+        }
+    }
     
-    float ratio = (float)uncompressed_data.size() / compressed_size;
+    if (settings.end_seconds >= 0.0 && settings.end_seconds <= settings.start_seconds) {
+        std::cerr << "❌ --end must be after --start\n";
+        return 1;
+    }
     
-    std::cout << "  ✅ HMICAP7 written: " << compressed_size / 1024.0 / 1024.0 << " MB\n";
-    std::cout << "  📊 Compression ratio: " << ratio << "x 💯\n";
+    if (settings.xor_codec && (settings.planar || settings.sample_format != SAMPLE_FLOAT32)) {
+        std::cerr << "❌ --xor codes float32 samples channel by channel (drop --planar / --sample-format)\n";
+        return 1;
+    }
+    
+    if (!batch_path.empty() && !watch_dirs.empty()) {
+        std::cerr << "❌ --batch and --watch can't be combined\n";
+        return 1;
+    }
+    if (!pack_path.empty() && (!batch_path.empty() || !watch_dirs.empty() || input_path.empty() || !format.empty())) {
+        std::cerr << "❌ --pack takes one directory or list of tracks (convert them with --batch first)\n";
+        return 1;
+    }
+    
+    // zstd workers per file only when files aren't already converted in parallel
+    bool parallel_files = (!batch_path.empty() || !watch_dirs.empty()) && jobs > 1;
+    apply_profile(*profile, parallel_files ? 0 : std::max(1u, std::thread::hardware_concurrency()), settings);
+    
+    if (settings.lz4 && !HMICAP_HAVE_LZ4) {
+        std::cerr << "❌ This converter was built without LZ4 (rebuild with -DHMICAP_WITH_LZ4 -llz4)\n";
+        return 1;
+    }
+    if (settings.lz4 && (settings.zstd_budget > 0.0 || settings.block_seconds > 0.0)) {
+        std::cerr << "❌ --profile lz4 writes one LZ4 frame (--budget and --seekable are zstd only)\n";
+        return 1;
+    }
     
-    return true;
-}
-
-int main() {
     // Initialize mpg123
     mpg123_init();
     
     std::cout << "🔥🔥🔥 HMICAP CONVERTER - PRE-RENDERED AUDIO SUPREMACY 🔥🔥🔥\n";
-    std::cout << "💎 SUPPORTS: MP3, WAV, FLAC, OGG, AIFF → HMICAP/HMICAP7 💎\n";
+    std::cout << "💎 SUPPORTS: MP3, WAV, FLAC, OGG, AIFF, HMICA/HMICA7/HMICAP/HMICAP7 → HMICAP/HMICAP7/HMICA/HMICA7 💎\n";
     std::cout << "⚡ BINARY FORMAT = INSTANT LOADING (no parsing overhead fr fr) ⚡\n\n";
     
+    // 📦 Packing copies finished tracks - no decoding, no cache
+    if (!pack_path.empty()) {
+        int status = run_pack(input_path, pack_path, settings);
+        mpg123_exit();
+        return status;
+    }
+    
+    // ♻️ Cache manifest lives next to the outputs unless --cache says otherwise
+    ConversionCache cache;
+    if (use_cache) {
+        bool single_file = batch_path.empty() && watch_dirs.empty();
+        fs::path manifest = cache_path.empty() ? fs::path(single_file ? "." : out_dir) / ".hmicap-cache" : fs::path(cache_path);
+        std::error_code ec;
+        if (manifest.has_parent_path()) fs::create_directories(manifest.parent_path(), ec);
+        cache.load(manifest);
+    }
+    
+    // 📚 Batch and watch modes are fully non-interactive: the only positional argument is the format
+    if (!batch_path.empty() || !watch_dirs.empty()) {
+        if (format.empty()) format = input_path;
+        std::transform(format.begin(), format.end(), format.begin(), ::toupper);
+        
+        if (!parse_output_format(format, settings)) {
+            std::cerr << "❌ " << (watch_dirs.empty() ? "Batch" : "Watch") << " mode needs a format: HMICAP, HMICAP7, HMICA or HMICA7\n";
+            mpg123_exit();
+            return 1;
+        }
+        if (!check_output_format(format, settings)) {
+            mpg123_exit();
+            return 1;
+        }
+        
+        const bool compress = format.back() == '7';
+        int status = watch_dirs.empty()
+            ? run_batch(batch_path, out_dir, compress, jobs, settings, use_cache ? &cache : nullptr)
+            : run_watch(watch_dirs, out_dir, compress, jobs, settings, use_cache ? &cache : nullptr);
+        mpg123_exit();
+        return status;
+    }
+    
     // Get input file
-    std::string input_path;
-    std::cout << "Enter audio file path: ";
-    std::getline(std::cin, input_path);
+    if (input_path.empty()) {
+        std::cout << "Enter audio file path: ";
+        std::getline(std::cin, input_path);
+    }
     
-    if (!fs::exists(input_path)) {
+    std::string pack, track;
+    const bool packed = split_pack_path(input_path, pack, track);
+    if (!fs::exists(packed ? pack : input_path)) {
         std::cerr << "❌ File not found!\n";
         mpg123_exit();
         return 1;
     }
     
-    // Load audio
-    AudioData audio;
-    std::cout << "\n📂 Loading audio...\n";
+    if (bench_shuffle || bench_layout || bench_format || bench_io_paths || bench_xor || bench_compression) {
+        AudioData audio;
+        bool ok = load_audio(input_path, audio, settings, std::cout) &&
+                  (bench_shuffle       ? bench_shuffle_modes(audio)
+                   : bench_layout      ? bench_layouts(audio, settings.shuffle)
+                   : bench_format      ? bench_sample_formats(audio, settings.shuffle)
+                   : bench_xor         ? bench_xor_codec(audio)
+                   : bench_compression ? bench_profiles(audio, settings)
+                                       : bench_io(audio));
+        mpg123_exit();
+        return ok ? 0 : 1;
+    }
+    
+    // Get output format (up front - the pipeline needs to know where the blocks go)
+    if (format.empty()) {
+        std::cout << "\nChoose format (HMICAP / HMICAP7 / HMICA / HMICA7): ";
+        std::getline(std::cin, format);
+    }
+    std::transform(format.begin(), format.end(), format.begin(), ::toupper);
     
-    if (!load_audio(input_path, audio)) {
+    if (!parse_output_format(format, settings)) {
+        std::cerr << "❌ Invalid format!\n";
+        mpg123_exit();
+        return 1;
+    }
+    if (!check_output_format(format, settings)) {
         mpg123_exit();
         return 1;
     }
     
-    std::cout << "\n✅ Audio loaded successfully!! 💚\n";
+    bool compress = format.back() == '7';
+    std::string base_name = packed ? fs::path(track).filename().string() : fs::path(input_path).stem().string();
+    std::string output = base_name + output_extension(compress, settings);
+    std::error_code same_ec;
+    if (fs::equivalent(input_path, output, same_ec)) {
+        std::cerr << "❌ " << output << " would overwrite its own input (convert from another directory)\n";
+        mpg123_exit();
+        return 1;
+    }
     
-    // Get output format
-    std::string format;
-    std::cout << "\nChoose format (HMICAP / HMICAP7): ";
-    std::getline(std::cin, format);
-    std::transform(format.begin(), format.end(), format.begin(), ::toupper);
+    CacheEntry cache_entry;
+    std::string cache_action;
+    if (use_cache && cache.reuse(input_path, output, format, settings, cache_entry, cache_action)) {
+        std::cout << "\n♻️  Cache hit: " << output << " (" << cache_action << ") - skipped decode + compression 💨\n";
+        mpg123_exit();
+        return 0;
+    }
     
-    std::string base_name = fs::path(input_path).stem().string();
+    AudioData audio;
     bool success = false;
+    std::cout << "\n📂 Loading audio...\n";
     
-    if (format == "HMICAP") {
-        std::string output = base_name + ".hmicap";
-        success = write_hmicap(output, audio);
-    } else if (format == "HMICAP7") {
-        std::string output = base_name + ".hmicap7";
-        success = write_hmicap7(output, audio);
+    if (sequential) {
+        success = convert_file(input_path, output, compress, settings, audio, std::cout);
     } else {
-        std::cerr << "❌ Invalid format!\n";
-        mpg123_exit();
-        return 1;
+        success = convert_pipelined(input_path, output, compress, settings, audio, std::cout);
     }
     
     if (!success) {
@@ -299,6 +6573,10 @@ int main() {
         return 1;
     }
     
+    if (use_cache) {
+        cache.record(cache_entry);
+    }
+    
     // STATS FLEX 💪
     std::cout << "\n📊 ═══ CONVERSION COMPLETE ═══ 📊\n";
     std::cout << "🎵 Sample rate: " << audio.sample_rate << " Hz\n";
@@ -3,11 +3,32 @@
 #include <vector>
 #include <string>
 #include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <cerrno>
 #include <thread>
 #include <atomic>
 #include <chrono>
 #include <iomanip>
 #include <algorithm>
+#include <memory>
+#include <mutex>
+#include <deque>
+
+// 🗺️ MEMORY MAPPING
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// ⚡ ASYNC FILE I/O (io_uring when the kernel headers have it, pread/pwrite otherwise)
+#include <sys/syscall.h>
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define HMICAP_HAVE_IO_URING 1
+#else
+#define HMICAP_HAVE_IO_URING 0
+#endif
 
 // 🔊 AUDIO OUTPUT
 #include <portaudio.h>
@@ -15,131 +36,2502 @@
 // 🚀 ZSTD DECOMPRESSION
 #include <zstd.h>
 
-// 🎮 PLAYBACK STATE
-std::atomic<bool> is_playing{false};
-std::atomic<bool> should_stop{false};
-std::atomic<int64_t> current_sample{0};
+// ⚡ LZ4 FRAMES (optional fast-decode HMICAP7 codec: build with -DHMICAP_WITH_LZ4 and link -llz4)
+#if defined(HMICAP_WITH_LZ4)
+#include <lz4frame.h>
+#define HMICAP_HAVE_LZ4 1
+#else
+#define HMICAP_HAVE_LZ4 0
+#endif
+
+// 🔒 XXH3 BLOCK CHECKSUMS (header-only)
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
+// 🔀 SIMD UNSHUFFLE/INTERLEAVE/CONVERSION KERNELS (SSE2 is baseline on x86-64; scalar fallback elsewhere)
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+// 🎮 PLAYBACK STATE
+std::atomic<bool> is_playing{false};
+std::atomic<bool> should_stop{false};
+std::atomic<int64_t> current_sample{0};
+std::atomic<int64_t> seek_request{-1};     // Set by the UI, applied by the callback (-1 = none)
+std::atomic<int64_t> underrun_buffers{0};  // Callbacks that found their block not decoded yet
+
+// 🔥 HMICAP HEADER STRUCTURE (40 bytes on disk)
+struct HMICAPHeader {
+    char magic[8];          // "HMICAP01"
+    uint32_t sample_rate;   // Hz
+    uint16_t channels;      // 1=mono, 2=stereo
+    uint16_t sample_format; // SampleFormat (0 = float32, what every older file has)
+    uint64_t total_samples; // Samples per channel
+    uint32_t flags;         // HMICAP_FLAG_*
+    uint32_t block_frames;  // Seekable HMICAP7: frames per independent zstd frame; shuffled/planar: frames per block
+    uint8_t reserved2[8];
+};
+static_assert(sizeof(HMICAPHeader) == 40, "HMICAP header is 40 bytes on disk");
+
+const uint32_t HMICAP_FLAG_SEEKABLE = 1u << 0;
+const uint32_t HMICAP_FLAG_LZ4 = 1u << 1;       // HMICAP7 frames are LZ4, not zstd (see LZ4 FRAMES)
+const uint32_t HMICAP_FLAG_CHECKSUMS = 1u << 5; // xxh3 table after the payload (see BLOCK CHECKSUMS)
+const uint32_t HMICAP_FLAG_OVERVIEW = 1u << 6;  // min/max/RMS pyramid after that (see OVERVIEW PYRAMID)
+const uint32_t HMICAP_FLAG_RUNS = 1u << 7;      // HMICAP: constant runs cut out, run table at the end (see CONSTANT RUNS)
+const uint32_t HMICAP_FLAG_XOR = 1u << 8;       // HMICAP: XOR-delta coded float32 blocks, index at the end (see XOR FLOAT CODEC)
+const uint32_t HMICAP_FLAG_PAGE_ALIGNED = 1u << 9; // HMICAP: payload starts at PAGE_PAYLOAD_OFFSET (see PLANAR LAYOUT)
+
+// 🧮 SAMPLE FORMATS ═════════════════════════════════════════════════════════
+// header.sample_format says how each sample is stored; the player keeps them that way in
+// memory and expands to float right before PortAudio gets them. Integers are scaled by
+// 2^(bits-1) (libsndfile's convention), int24 is packed little-endian, float16 is IEEE half.
+enum SampleFormat : uint16_t {
+    SAMPLE_FLOAT32 = 0,
+    SAMPLE_INT16 = 1,
+    SAMPLE_INT24 = 2,
+    SAMPLE_FLOAT16 = 3,
+};
+
+bool known_sample_format(uint16_t format) {
+    return format <= SAMPLE_FLOAT16;
+}
+
+size_t sample_bytes(uint16_t format) {
+    switch (format) {
+        case SAMPLE_INT16: return 2;
+        case SAMPLE_INT24: return 3;
+        case SAMPLE_FLOAT16: return 2;
+        default: return 4;
+    }
+}
+
+const char* sample_format_name(uint16_t format) {
+    switch (format) {
+        case SAMPLE_FLOAT32: return "f32";
+        case SAMPLE_INT16: return "s16";
+        case SAMPLE_INT24: return "s24";
+        case SAMPLE_FLOAT16: return "f16";
+        default: return "unknown";
+    }
+}
+
+inline float half_to_float(uint16_t half) {
+    const uint32_t shifted_exp = 0x7C00u << 13;
+    uint32_t bits = (half & 0x7FFFu) << 13;
+    uint32_t exp = bits & shifted_exp;
+    bits += (127u - 15) << 23;
+    float value;
+    if (exp == shifted_exp) {
+        bits += (128u - 16) << 23; // Inf/NaN
+        std::memcpy(&value, &bits, 4);
+    } else if (exp == 0) {
+        bits += 1u << 23; // Subnormal: renormalize through the FPU
+        std::memcpy(&value, &bits, 4);
+        value -= 6.103515625e-05f; // 2^-14
+    } else {
+        std::memcpy(&value, &bits, 4);
+    }
+    uint32_t out;
+    std::memcpy(&out, &value, 4);
+    out |= (uint32_t)(half & 0x8000u) << 16;
+    std::memcpy(&value, &out, 4);
+    return value;
+}
+
+// 🧮 n SAMPLES of `format` → n FLOATS (what the player does per block)
+void expand_samples(uint16_t format, const char* src, size_t n, float* dst) {
+    size_t i = 0;
+    if (format == SAMPLE_INT16) {
+#if defined(__SSE2__)
+        // Sign-extend by unpacking into the high half and shifting back down
+        const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+        for (; i + 8 <= n; i += 8) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+            __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+            __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+            _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+            _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+        }
+#endif
+        for (; i < n; i++) {
+            int16_t value;
+            std::memcpy(&value, src + i * 2, 2);
+            dst[i] = value * (1.0f / 32768.0f);
+        }
+    } else if (format == SAMPLE_INT24) {
+#if defined(__SSSE3__)
+        // pshufb drops each 3-byte sample into the top of a 32-bit lane, srai sign-extends it
+        const __m128i spread = _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+        const __m128 scale = _mm_set1_ps(1.0f / 8388608.0f);
+        for (; i + 6 <= n; i += 4) { // 16-byte load, 12 bytes used
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+            __m128i lanes = _mm_srai_epi32(_mm_shuffle_epi8(v, spread), 8);
+            _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lanes), scale));
+        }
+#endif
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(src);
+        for (; i < n; i++) {
+            int32_t value = (int32_t)((uint32_t)bytes[i * 3] << 8 | (uint32_t)bytes[i * 3 + 1] << 16 |
+                                      (uint32_t)bytes[i * 3 + 2] << 24) >> 8;
+            dst[i] = value * (1.0f / 8388608.0f);
+        }
+    } else if (format == SAMPLE_FLOAT16) {
+#if defined(__F16C__)
+        for (; i + 8 <= n; i += 8) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+            _mm_storeu_ps(dst + i, _mm_cvtph_ps(v));
+            _mm_storeu_ps(dst + i + 4, _mm_cvtph_ps(_mm_srli_si128(v, 8)));
+        }
+#elif defined(__SSE2__)
+        // Move exponent+mantissa into float position and rescale by 2^112 (F. Giesen's half_to_float_SSE2)
+        const __m128i no_sign = _mm_set1_epi32(0x7FFF);
+        const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23));
+        const __m128i was_infnan = _mm_set1_epi32(0x7BFF);
+        const __m128i exp_infnan = _mm_set1_epi32(255 << 23);
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 8 <= n; i += 8) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+            __m128i halves[2] = {_mm_unpacklo_epi16(v, zero), _mm_unpackhi_epi16(v, zero)};
+            for (int h = 0; h < 2; h++) {
+                __m128i expmant = _mm_and_si128(halves[h], no_sign);
+                __m128i sign = _mm_slli_epi32(_mm_xor_si128(halves[h], expmant), 16);
+                __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(expmant, 13)), magic);
+                __m128i infnan = _mm_and_si128(_mm_cmpgt_epi32(expmant, was_infnan), exp_infnan);
+                _mm_storeu_ps(dst + i + 4 * h, _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(sign, infnan))));
+            }
+        }
+#endif
+        for (; i < n; i++) {
+            uint16_t value;
+            std::memcpy(&value, src + i * 2, 2);
+            dst[i] = half_to_float(value);
+        }
+    } else {
+        std::memcpy(dst, src, n * 4);
+    }
+}
+
+// 🎚️ PLANAR LAYOUT ══════════════════════════════════════════════════════════
+// Each block of header.block_frames frames stores channel 0's samples, then channel 1's, ...
+// Planes are zero padded to a multiple of PLANAR_ALIGN_FRAMES and the payload starts at
+// PLANAR_PAYLOAD_OFFSET, so every plane of a mapped file is 64-byte aligned. Only the last
+// block pads; the player interleaves on the way out to PortAudio.
+const uint32_t HMICAP_FLAG_PLANAR = 1u << 4;
+const size_t PLANAR_ALIGN_FRAMES = 16;
+const size_t PLANAR_PAYLOAD_OFFSET = 64;
+
+// HMICAP_FLAG_PAGE_ALIGNED: header zero padded to a whole page, so mapped samples are page-aligned
+// and --direct can read the payload with O_DIRECT
+const size_t PAGE_PAYLOAD_OFFSET = 4096;
+
+// Samples between two planes of a block holding `frames` frames
+inline size_t planar_stride(size_t frames) {
+    return (frames + PLANAR_ALIGN_FRAMES - 1) / PLANAR_ALIGN_FRAMES * PLANAR_ALIGN_FRAMES;
+}
+
+// Bytes before the first sample
+inline size_t payload_offset(uint32_t flags) {
+    if (flags & HMICAP_FLAG_PAGE_ALIGNED) return PAGE_PAYLOAD_OFFSET;
+    return (flags & HMICAP_FLAG_PLANAR) ? PLANAR_PAYLOAD_OFFSET : sizeof(HMICAPHeader);
+}
+
+// Samples in the whole payload (planar files pad the last block's planes)
+size_t payload_samples(int64_t total_frames, int channels, size_t block_frames, uint32_t flags) {
+    if (!(flags & HMICAP_FLAG_PLANAR) || block_frames == 0) return total_frames * channels;
+    size_t full_blocks = total_frames / block_frames;
+    size_t last_frames = total_frames - full_blocks * block_frames;
+    return (full_blocks * block_frames + planar_stride(last_frames)) * channels;
+}
+
+// 🎚️ PLANES → INTERLEAVED (count frames from planes stride floats apart)
+void interleave_planes(const float* planes, size_t stride, int channels, size_t count, float* out) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    if (channels == 2) {
+        for (; i + 4 <= count; i += 4) {
+            __m128 left = _mm_loadu_ps(planes + i);
+            __m128 right = _mm_loadu_ps(planes + stride + i);
+            _mm_storeu_ps(out + i * 2, _mm_unpacklo_ps(left, right));
+            _mm_storeu_ps(out + i * 2 + 4, _mm_unpackhi_ps(left, right));
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        for (int ch = 0; ch < channels; ch++) out[i * channels + ch] = planes[ch * stride + i];
+    }
+}
+
+// 🔀 BYTE/BIT-PLANE SHUFFLE (Blosc-style pre-filter) ═══════════════════════
+// Inside every block of header.block_frames frames, byte k of each w-byte sample is stored
+// together: the sign/exponent planes compress hard and the noisy low mantissa bytes stop
+// polluting them. The bit shuffle splits each byte plane again into its 8 bit planes.
+// Layout per block of n samples (w = sample_bytes(header.sample_format)):
+//   byte shuffle: plane[k][i] = byte k of sample i                        (w planes of n bytes)
+//   bit shuffle:  m = n & ~7; bit j of plane k, samples 0..m-1 packed LSB-first
+//                 into plane k*8+j (8w planes of m/8 bytes), then the n-m tail samples raw
+const uint32_t HMICAP_FLAG_BYTE_SHUFFLE = 1u << 2;
+const uint32_t HMICAP_FLAG_BIT_SHUFFLE = 1u << 3;
+const uint32_t HMICAP_SHUFFLE_FLAGS = HMICAP_FLAG_BYTE_SHUFFLE | HMICAP_FLAG_BIT_SHUFFLE;
+
+void byte_unshuffle4(const uint8_t* src, uint8_t* dst, size_t n) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    // Interleave planes 0+1 and 2+3 into byte pairs, then the pairs into whole samples
+    for (; i + 16 <= n; i += 16) {
+        __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + n + i));
+        __m128i p2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * n + i));
+        __m128i p3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * n + i));
+        __m128i lo01 = _mm_unpacklo_epi8(p0, p1), hi01 = _mm_unpackhi_epi8(p0, p1);
+        __m128i lo23 = _mm_unpacklo_epi8(p2, p3), hi23 = _mm_unpackhi_epi8(p2, p3);
+        __m128i* out = reinterpret_cast<__m128i*>(dst + i * 4);
+        _mm_storeu_si128(out, _mm_unpacklo_epi16(lo01, lo23));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo01, lo23));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi01, hi23));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi01, hi23));
+    }
+#endif
+    for (; i < n; i++) {
+        for (int k = 0; k < 4; k++) dst[i * 4 + k] = src[k * n + i];
+    }
+}
+
+// 8 bit planes `stride` bytes apart → m bytes
+void bit_untranspose_plane(const uint8_t* src, size_t stride, size_t m, uint8_t* dst) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    // 128 bytes per step: transpose the 8 planes × 16 bytes with unpacks so each register holds
+    // [plane0..7 byte t | plane0..7 byte t+1], then movemask pulls bit b out as output bytes 8t+b, 8t+8+b
+    for (; i + 128 <= m; i += 128) {
+        __m128i p[8];
+        for (int j = 0; j < 8; j++) p[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + j * stride + i / 8));
+        __m128i a[8], b[8], c[8];
+        for (int j = 0; j < 4; j++) {
+            a[2 * j] = _mm_unpacklo_epi8(p[2 * j], p[2 * j + 1]);     // bytes 0-7 of the plane pair
+            a[2 * j + 1] = _mm_unpackhi_epi8(p[2 * j], p[2 * j + 1]); // bytes 8-15
+        }
+        for (int h = 0; h < 2; h++) {
+            b[4 * h] = _mm_unpacklo_epi16(a[h], a[2 + h]);         // planes 0-3, bytes 8h+0..3
+            b[4 * h + 1] = _mm_unpackhi_epi16(a[h], a[2 + h]);     // planes 0-3, bytes 8h+4..7
+            b[4 * h + 2] = _mm_unpacklo_epi16(a[4 + h], a[6 + h]); // planes 4-7, bytes 8h+0..3
+            b[4 * h + 3] = _mm_unpackhi_epi16(a[4 + h], a[6 + h]); // planes 4-7, bytes 8h+4..7
+        }
+        for (int q = 0; q < 4; q++) {
+            int lo = (q / 2) * 4 + (q % 2);
+            c[2 * q] = _mm_unpacklo_epi32(b[lo], b[lo + 2]);     // bytes t, t+1 (t = 4q)
+            c[2 * q + 1] = _mm_unpackhi_epi32(b[lo], b[lo + 2]); // bytes t+2, t+3
+        }
+        for (int r = 0; r < 8; r++) {
+            uint8_t* out = dst + i + r * 16;
+            for (int bit = 0; bit < 8; bit++) {
+                int bits = _mm_movemask_epi8(_mm_sll_epi16(c[r], _mm_cvtsi32_si128(7 - bit)));
+                out[bit] = (uint8_t)bits;
+                out[bit + 8] = (uint8_t)(bits >> 8);
+            }
+        }
+    }
+    
+    // Then 16 at a time: 16 bits of each plane as [plane0..7 low bytes | plane0..7 high bytes]
+    const __m128i low_byte = _mm_set1_epi16(0xFF);
+    for (; i + 16 <= m; i += 16) {
+        uint16_t w[8];
+        for (int j = 0; j < 8; j++) std::memcpy(&w[j], src + j * stride + i / 8, 2);
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w));
+        v = _mm_packus_epi16(_mm_and_si128(v, low_byte), _mm_srli_epi16(v, 8));
+        for (int b = 0; b < 8; b++) {
+            int bits = _mm_movemask_epi8(_mm_sll_epi16(v, _mm_cvtsi32_si128(7 - b)));
+            dst[i + b] = (uint8_t)bits;
+            dst[i + b + 8] = (uint8_t)(bits >> 8);
+        }
+    }
+#endif
+    for (; i < m; i += 8) {
+        for (int b = 0; b < 8; b++) {
+            uint8_t value = 0;
+            for (int j = 0; j < 8; j++) value |= ((src[j * stride + i / 8] >> b) & 1) << j;
+            dst[i + b] = value;
+        }
+    }
+}
+
+void byte_unshuffle2(const uint8_t* src, uint8_t* dst, size_t n) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= n; i += 16) {
+        __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + n + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2), _mm_unpacklo_epi8(p0, p1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2 + 16), _mm_unpackhi_epi8(p0, p1));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i * 2] = src[i];
+        dst[i * 2 + 1] = src[n + i];
+    }
+}
+
+// width byte planes of n bytes → n samples of `width` bytes (2/4-byte samples have SIMD kernels)
+void byte_unshuffle(const uint8_t* src, uint8_t* dst, size_t n, size_t width) {
+    if (width == 4) return byte_unshuffle4(src, dst, n);
+    if (width == 2) return byte_unshuffle2(src, dst, n);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t k = 0; k < width; k++) dst[i * width + k] = src[k * n + i];
+    }
+}
+
+// scratch: n * width bytes of working space
+void bit_unshuffle(const uint8_t* src, uint8_t* dst, size_t n, size_t width, uint8_t* scratch) {
+    size_t m = n & ~(size_t)7;
+    for (size_t k = 0; k < width; k++) {
+        bit_untranspose_plane(src + k * m, m / 8, m, scratch + k * m);
+    }
+    byte_unshuffle(scratch, dst, m, width);
+    std::memcpy(dst + m * width, src + m * width, (n - m) * width);
+}
+
+// 🔀 UNDO THE CONVERTER'S SHUFFLE: n shuffled samples of `width` bytes from src back into dst
+void unshuffle_samples(uint32_t shuffle, const char* src, size_t n, size_t width, char* dst,
+                       std::vector<uint8_t>& scratch) {
+    const uint8_t* in = reinterpret_cast<const uint8_t*>(src);
+    uint8_t* out = reinterpret_cast<uint8_t*>(dst);
+    if (shuffle & HMICAP_FLAG_BIT_SHUFFLE) {
+        scratch.resize(n * width);
+        bit_unshuffle(in, out, n, width, scratch.data());
+    } else if (shuffle & HMICAP_FLAG_BYTE_SHUFFLE) {
+        byte_unshuffle(in, out, n, width);
+    } else {
+        std::memcpy(out, in, n * width);
+    }
+}
+
+// 🧮 count FRAMES from frame `first` of one payload block → interleaved floats. Compact planar
+// blocks expand a chunk of every plane, then interleave it.
+void expand_block_frames(const char* block, uint16_t format, bool planar, size_t stride, int channels,
+                         size_t first, size_t count, float* out) {
+    const size_t width = sample_bytes(format);
+    if (!planar) {
+        expand_samples(format, block + first * channels * width, count * channels, out);
+        return;
+    }
+    if (format == SAMPLE_FLOAT32) {
+        interleave_planes(reinterpret_cast<const float*>(block) + first, stride, channels, count, out);
+        return;
+    }
+    const size_t chunk = 1024;
+    thread_local std::vector<float> staging;
+    staging.resize(chunk * channels);
+    for (size_t done = 0; done < count; done += chunk) {
+        size_t n = std::min(chunk, count - done);
+        for (int ch = 0; ch < channels; ch++) {
+            expand_samples(format, block + (ch * stride + first + done) * width, n, staging.data() + ch * chunk);
+        }
+        interleave_planes(staging.data(), chunk, channels, n, out + done * channels);
+    }
+}
+
+// 🧬 XOR FLOAT CODEC ════════════════════════════════════════════════════════
+// HMICAP_FLAG_XOR: every block is stored channel after channel as XORs of neighbouring float32
+// samples, XOR_GROUP at a time sharing one bit width and trailing-zero count (u8 width, u8
+// trailing zeros, 2 * width bytes of packed values), plus XOR_SLACK_BYTES at the end. The block
+// index (u64 coded bytes per block) and an XorFooter end the file. The loader decodes all blocks
+// in parallel up front - fixed-width unpack, then a SIMD prefix-XOR per group.
+const size_t XOR_GROUP = 16;
+const size_t XOR_SLACK_BYTES = 8;
+
+struct XorFooter {
+    uint64_t checksum; // xxh3-64 of the block index
+    uint32_t blocks;
+    char magic[4];     // "HXOR"
+};
+static_assert(sizeof(XorFooter) == 16, "XOR footer is 16 bytes on disk");
+
+// 🧬 Decode one block into channel planes `stride` floats apart - false = corrupt
+bool xor_decode_block(const char* data, size_t size, size_t frames, int channels, float* planes, size_t stride) {
+    if (size < XOR_SLACK_BYTES) return false;
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+    const uint8_t* end = p + size - XOR_SLACK_BYTES;
+    for (int ch = 0; ch < channels; ch++) {
+        uint32_t* out = reinterpret_cast<uint32_t*>(planes + ch * stride);
+        uint32_t previous = 0;
+        for (size_t first = 0; first < frames; first += XOR_GROUP, out += XOR_GROUP) {
+            if (end - p < 2) return false;
+            const unsigned width = p[0], trail = p[1];
+            if (width + trail > 32 || (size_t)(end - p - 2) < 2 * width) return false;
+            p += 2;
+            
+            // Fixed-width unpack: value k sits at bit k * width of the group
+            uint32_t deltas[XOR_GROUP];
+            const uint64_t mask = (1ull << width) - 1;
+            for (size_t k = 0; k < XOR_GROUP; k++) {
+                const size_t bit = k * width;
+                uint64_t word;
+                std::memcpy(&word, p + bit / 8, sizeof(word));
+                deltas[k] = (uint32_t)((word >> (bit % 8)) & mask) << trail;
+            }
+            p += 2 * width;
+            
+            // Prefix XOR: sample k = previous ^ delta 0 ^ ... ^ delta k
+#if defined(__SSE2__)
+            __m128i carry = _mm_set1_epi32((int)previous);
+            for (size_t k = 0; k < XOR_GROUP; k += 4) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(deltas + k));
+                v = _mm_xor_si128(v, _mm_slli_si128(v, 4));
+                v = _mm_xor_si128(v, _mm_slli_si128(v, 8));
+                v = _mm_xor_si128(v, carry);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k), v);
+                carry = _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 3));
+            }
+            previous = out[XOR_GROUP - 1];
+#else
+            for (size_t k = 0; k < XOR_GROUP; k++) out[k] = previous ^= deltas[k];
+#endif
+        }
+    }
+    return true;
+}
+
+// 🧭 ZSTD SEEKABLE FORMAT footer/skippable-frame magics
+const uint32_t ZSTD_SEEKABLE_SKIPPABLE_MAGIC = 0x184D2A5E;
+const uint32_t ZSTD_SEEKABLE_FOOTER_MAGIC = 0x8F92EAB1;
+
+// 🗺️ READ-ONLY FILE MAPPING (unmapped together with its AudioData) - of a whole file, or of one
+// packed track, whose mapping starts `lead` bytes early on the page boundary below it
+struct MappedFile {
+    char* base = nullptr;
+    size_t length = 0;
+    size_t lead = 0;
+    
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() {
+        reset();
+    }
+    
+    void reset() {
+        if (base) munmap(base - lead, length + lead);
+        base = nullptr;
+        length = 0;
+        lead = 0;
+    }
+};
+
+// 🧭 ONE ZSTD FRAME OF A SEEKABLE HMICAP7 (frame 0 = header, 1 + b = sample block b, then any checksum table)
+struct SeekFrame {
+    uint64_t compressed_offset;
+    uint32_t compressed_size;
+    uint32_t decompressed_size;
+};
+
+// One decoded block. The decoder fills a scratch buffer and swaps it in under the mutex;
+// the callback only ever try_locks, so it never waits on the decoder.
+struct BlockSlot {
+    std::mutex mutex;
+    int64_t block = -1; // Which block `bytes` holds (-1 = nothing yet)
+    std::vector<char> bytes; // Unshuffled payload block, still in the file's sample format
+};
+
+// 🧭 ON-DEMAND BLOCK DECODING - only the blocks around the play head are ever decompressed
+struct SeekableStream {
+    static const int SLOTS = 4; // Play head block + 3 blocks of lookahead
+    
+    std::vector<SeekFrame> frames;
+    int64_t blocks = 0;   // Sample blocks (frames 1..blocks; a checksum table frame may follow)
+    int64_t block_frames = 0;
+    std::vector<uint64_t> checksums; // Block b's hash is checksums[b + 1] (empty = not verifying)
+    uint32_t shuffle = 0; // HMICAP_FLAG_*_SHUFFLE the blocks were stored with
+    bool planar = false;  // Blocks decode to padded channel planes (HMICAP_FLAG_PLANAR)
+    uint16_t sample_format = SAMPLE_FLOAT32;
+    BlockSlot slots[SLOTS];
+    std::atomic<bool> running{false};
+    
+    int64_t block_count() const {
+        return blocks;
+    }
+};
+
+// 📈 OVERVIEW PYRAMID ═══════════════════════════════════════════════════════
+// HMICAP_FLAG_OVERVIEW: per-channel min/max/RMS for every 256, 4096 and 65536 frames, after the
+// payload and any checksum table: OverviewHeader, one OverviewLevelInfo per level, then per
+// level, bucket and channel int16 min, int16 max (x 32768), uint16 rms (x 65535). HMICAP7 keeps
+// it in a zstd frame of its own - the last frame of a seekable file, or the frame an
+// OVERVIEW_LOCATOR skippable frame at the very end points back to - so it loads without
+// decompressing a single sample.
+const uint32_t OVERVIEW_LOCATOR_MAGIC = 0x184D2A5B;
+
+struct OverviewHeader {
+    char magic[8];     // "HMIOVW01"
+    uint32_t levels;
+    uint32_t channels;
+    uint64_t checksum; // xxh3-64 of everything after this header
+};
+
+struct OverviewLevelInfo {
+    uint32_t bucket_frames;
+    uint32_t reserved;
+    uint64_t buckets;
+};
+
+struct OverviewLevel {
+    int64_t bucket_frames = 0;
+    int64_t buckets = 0;
+    const char* entries = nullptr; // buckets x channels x (min, max, rms)
+};
+
+struct Overview {
+    std::vector<char> storage; // Section bytes (unless they live in the file mapping)
+    std::vector<OverviewLevel> levels; // Finest first
+    int channels = 0;
+    int64_t total_frames = 0;
+};
+
+// Min/max (-1..1) and RMS of a stretch of audio, all channels together
+struct OverviewStats {
+    float min = 0.0f;
+    float max = 0.0f;
+    float rms = 0.0f;
+};
+
+// 📈 Check the section in `data` against the header it belongs to - false = corrupt/mismatched
+bool parse_overview(Overview& overview, const char* data, size_t size, int channels, int64_t total_frames,
+                    bool verify) {
+    OverviewHeader header;
+    if (size < sizeof(header)) return false;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, "HMIOVW01", 8) != 0 || (int)header.channels != channels || header.levels == 0 ||
+        header.levels > (size - sizeof(header)) / sizeof(OverviewLevelInfo)) {
+        return false;
+    }
+    if (verify && XXH3_64bits(data + sizeof(header), size - sizeof(header)) != header.checksum) return false;
+    
+    const size_t entry_bytes = (size_t)channels * 3 * sizeof(int16_t);
+    size_t offset = sizeof(header) + header.levels * sizeof(OverviewLevelInfo);
+    overview.levels.clear();
+    for (uint32_t level = 0; level < header.levels; level++) {
+        OverviewLevelInfo info;
+        std::memcpy(&info, data + sizeof(header) + level * sizeof(info), sizeof(info));
+        if (info.bucket_frames == 0 || info.buckets != (uint64_t)(total_frames + info.bucket_frames - 1) / info.bucket_frames ||
+            info.buckets > (size - offset) / entry_bytes) {
+            return false;
+        }
+        overview.levels.push_back({info.bucket_frames, (int64_t)info.buckets, data + offset});
+        offset += info.buckets * entry_bytes;
+    }
+    overview.channels = channels;
+    overview.total_frames = total_frames;
+    return offset == size;
+}
+
+// 📈 Stats of frames [first, first + count) to bucket precision: the coarsest level that still
+// has a bucket per `count` frames, so any query touches at most a few dozen entries
+OverviewStats overview_range(const Overview& overview, int64_t first, int64_t count) {
+    const OverviewLevel* level = &overview.levels.front();
+    for (const auto& candidate : overview.levels) {
+        if (candidate.bucket_frames <= count) level = &candidate;
+    }
+    
+    int64_t begin = first / level->bucket_frames;
+    int64_t end = std::min(level->buckets, (first + count + level->bucket_frames - 1) / level->bucket_frames);
+    int32_t low = 32767, high = -32768;
+    double sum_squares = 0.0;
+    int64_t frames = 0;
+    for (int64_t b = begin; b < end; b++) {
+        const int64_t in_bucket = std::min(level->bucket_frames, overview.total_frames - b * level->bucket_frames);
+        const char* entry = level->entries + b * overview.channels * 3 * sizeof(int16_t);
+        for (int ch = 0; ch < overview.channels; ch++, entry += 3 * sizeof(int16_t)) {
+            int16_t values[2];
+            uint16_t rms;
+            std::memcpy(values, entry, sizeof(values));
+            std::memcpy(&rms, entry + sizeof(values), sizeof(rms));
+            low = std::min<int32_t>(low, values[0]);
+            high = std::max<int32_t>(high, values[1]);
+            sum_squares += (double)rms * rms * in_bucket;
+        }
+        frames += in_bucket * overview.channels;
+    }
+    
+    OverviewStats stats;
+    if (frames == 0) return stats;
+    stats.min = low / 32768.0f;
+    stats.max = high / 32768.0f;
+    stats.rms = std::sqrt(sum_squares / frames) / 65535.0f;
+    return stats;
+}
+
+// 📈 Loudest `window` frames (RMS over all channels): a sliding sum over the coarsest level
+// with 16+ buckets per window
+int64_t overview_loudest(const Overview& overview, int64_t window, float& rms) {
+    const OverviewLevel* level = &overview.levels.front();
+    for (const auto& candidate : overview.levels) {
+        if (candidate.bucket_frames * 16 <= window) level = &candidate;
+    }
+    
+    // Energy per bucket (sum of squares over its frames and channels, in rms units)
+    std::vector<double> energy(level->buckets);
+    for (int64_t b = 0; b < level->buckets; b++) {
+        const int64_t in_bucket = std::min(level->bucket_frames, overview.total_frames - b * level->bucket_frames);
+        const char* entry = level->entries + b * overview.channels * 3 * sizeof(int16_t);
+        for (int ch = 0; ch < overview.channels; ch++, entry += 3 * sizeof(int16_t)) {
+            uint16_t value;
+            std::memcpy(&value, entry + 2 * sizeof(int16_t), sizeof(value));
+            energy[b] += (double)value * value * in_bucket;
+        }
+    }
+    
+    const int64_t span = std::max<int64_t>(1, std::min(level->buckets, window / level->bucket_frames));
+    double sum = 0.0, best = -1.0;
+    int64_t best_start = 0;
+    for (int64_t b = 0; b < level->buckets; b++) {
+        sum += energy[b];
+        if (b >= span) sum -= energy[b - span];
+        if (b + 1 >= span && sum > best) {
+            best = sum;
+            best_start = b + 1 - span;
+        }
+    }
+    int64_t frames = std::min(overview.total_frames - best_start * level->bucket_frames, span * level->bucket_frames);
+    rms = frames > 0 ? std::sqrt(best / (frames * overview.channels)) / 65535.0f : 0.0f;
+    return best_start * level->bucket_frames;
+}
+
+// ⏸️ CONSTANT RUNS ══════════════════════════════════════════════════════════
+// HMICAP_FLAG_RUNS: stretches of bit-identical frames (digital silence, DC) were cut out of the
+// payload, which holds only the "stored" frames. The run table at the end of the file has per run
+// u64 first frame, u64 frames and one float32 per channel, then a RunFooter. The callback fills
+// runs in from the table and never touches the disk for them.
+struct RunFooter {
+    uint64_t stored_frames;
+    uint64_t checksum; // xxh3-64 of the run entries
+    uint32_t runs;
+    char magic[4];     // "HRUN"
+};
+static_assert(sizeof(RunFooter) == 24, "run footer is 24 bytes on disk");
+
+struct SampleRun {
+    int64_t first;
+    int64_t frames;
+    int64_t skipped;          // Frames cut out before this run (first - skipped = where it sits in the payload)
+    std::vector<float> value; // One sample per channel
+};
+
+size_t run_entry_bytes(int channels) {
+    return 2 * sizeof(uint64_t) + channels * sizeof(float);
+}
+
+// Parse the run entries (already read) - runs must be in order, not overlap, stay inside the track
+// and account for every frame the payload doesn't hold
+bool parse_run_table(std::vector<SampleRun>& runs, const char* data, const RunFooter& footer, int channels,
+                     int64_t total_frames, bool verify) {
+    const size_t entry = run_entry_bytes(channels);
+    if (verify && XXH3_64bits(data, footer.runs * entry) != footer.checksum) {
+        std::cerr << "❌ Run table checksum mismatch - the file is corrupt (--no-verify plays it anyway)\n";
+        return false;
+    }
+    runs.resize(footer.runs);
+    int64_t end = 0, skipped = 0;
+    for (uint32_t i = 0; i < footer.runs; i++) {
+        const char* p = data + i * entry;
+        uint64_t first, frames;
+        std::memcpy(&first, p, sizeof(first));
+        std::memcpy(&frames, p + sizeof(first), sizeof(frames));
+        if (first < (uint64_t)end || frames == 0 || first > (uint64_t)total_frames || frames > total_frames - first) {
+            std::cerr << "❌ Run table is corrupt (run " << i << " out of order or past the end)\n";
+            return false;
+        }
+        runs[i].first = first;
+        runs[i].frames = frames;
+        runs[i].skipped = skipped;
+        runs[i].value.resize(channels);
+        std::memcpy(runs[i].value.data(), p + 2 * sizeof(uint64_t), channels * sizeof(float));
+        end = first + frames;
+        skipped += frames;
+    }
+    if ((uint64_t)skipped + footer.stored_frames != (uint64_t)total_frames) {
+        std::cerr << "❌ Run table is corrupt (" << skipped << " run frames + " << footer.stored_frames
+                  << " stored != " << total_frames << ")\n";
+        return false;
+    }
+    return true;
+}
+
+// First run that ends after `frame` (runs.size() if none)
+size_t run_at(const std::vector<SampleRun>& runs, int64_t frame) {
+    return std::upper_bound(runs.begin(), runs.end(), frame,
+                            [](int64_t f, const SampleRun& run) { return f < run.first + run.frames; }) -
+           runs.begin();
+}
+
+// 🎧 AUDIO DATA - PRE-RENDERED AND READY TO BLAST!!
+struct AudioData {
+    int sample_rate;
+    int channels;
+    int64_t total_samples;
+    int64_t stored_frames = 0;           // Frames actually in `samples` (HMICAP_FLAG_RUNS cuts runs out of the payload)
+    std::vector<SampleRun> runs;         // HMICAP_FLAG_RUNS: constant stretches, synthesized as they play
+    std::vector<char> sample_data;       // Payload bytes, ready to go!! (HMICAP7 / --no-mmap)
+    std::unique_ptr<char, decltype(&std::free)> direct_data{nullptr, &std::free}; // --direct: page-aligned payload O_DIRECT read into
+    const char* samples = nullptr;       // What the callback plays: sample_data, direct_data or straight from the mapping
+    uint16_t sample_format = SAMPLE_FLOAT32; // How `samples` is stored (expanded to float on the way out)
+    bool planar = false;                 // samples holds planar blocks of block_frames frames (HMICAP_FLAG_PLANAR)
+    int64_t block_frames = 0;
+    MappedFile mapping;                  // HMICAP: the samples themselves, seekable HMICAP7: the compressed frames
+    std::unique_ptr<SeekableStream> stream; // Seekable HMICAP7 - samples == nullptr, blocks decoded on demand
+    std::vector<uint64_t> checksums;     // Header hash, then one per block of `samples` (empty = not verifying)
+    std::unique_ptr<std::atomic<bool>[]> corrupt; // Blocks that failed verification - they play as silence
+    bool verify_while_playing = false;   // HMICAP: blocks still to be checked, in the background
+    Overview overview;                   // HMICAP_FLAG_OVERVIEW section (--overview loads only this)
+};
+
+// 🎚️ COPY count STORED FRAMES starting at `first` out of audio.samples into interleaved `out`
+void copy_frames(const AudioData& audio, int64_t first, int64_t count, float* out) {
+    if (!audio.planar) {
+        expand_samples(audio.sample_format, audio.samples + first * audio.channels * sample_bytes(audio.sample_format),
+                       count * audio.channels, out);
+        return;
+    }
+    const size_t frame_bytes = audio.channels * sample_bytes(audio.sample_format);
+    while (count > 0) {
+        int64_t block = first / audio.block_frames;
+        int64_t block_start = block * audio.block_frames;
+        int64_t frames_in_block = std::min(audio.block_frames, audio.stored_frames - block_start);
+        int64_t offset = first - block_start;
+        int64_t n = std::min(count, frames_in_block - offset);
+        expand_block_frames(audio.samples + block_start * frame_bytes, audio.sample_format, true,
+                            planar_stride(frames_in_block), audio.channels, offset, n, out);
+        out += n * audio.channels;
+        first += n;
+        count -= n;
+    }
+}
+
+// 🔒 BLOCK CHECKSUMS ════════════════════════════════════════════════════════
+// HMICAP_FLAG_CHECKSUMS: a table of little-endian xxh3-64 hashes follows the payload. Entry 0
+// covers the header (all payload_offset bytes), entry 1 + b covers block b exactly as stored.
+// Blocks are checked as stored, before unshuffling/expanding - xxh3 runs at memory speed, so a
+// mapped file is verified in the background while it plays and a bad block turns into silence.
+
+int64_t block_count(int64_t total_frames, size_t block_frames) {
+    return (total_frames + block_frames - 1) / block_frames;
+}
+
+// Bytes block b takes up in the payload (planar: only the last block pads its planes)
+size_t block_bytes(int64_t total_frames, int channels, size_t width, size_t block_frames, bool planar, int64_t block) {
+    size_t frames = std::min<int64_t>(block_frames, total_frames - block * (int64_t)block_frames);
+    if (planar) frames = planar_stride(frames);
+    return frames * channels * width;
+}
+
+size_t checksum_table_bytes(int64_t total_frames, size_t block_frames, uint32_t flags) {
+    return (flags & HMICAP_FLAG_CHECKSUMS) ? (block_count(total_frames, block_frames) + 1) * sizeof(uint64_t) : 0;
+}
+
+std::vector<uint64_t> parse_checksum_table(const char* table, size_t size) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(table);
+    std::vector<uint64_t> hashes(size / sizeof(uint64_t));
+    for (size_t i = 0; i < hashes.size(); i++) {
+        for (int k = 0; k < 8; k++) hashes[i] |= (uint64_t)bytes[i * 8 + k] << (8 * k);
+    }
+    return hashes;
+}
+
+// 🔒 CHECK EVERY BLOCK OF audio.samples against audio.checksums - workers grab blocks in play
+// order starting from `first_block` (so the play head's surroundings go first); failures are
+// flagged in audio.corrupt. `stop` (optional) abandons the walk early.
+int64_t verify_blocks(AudioData& audio, int64_t first_block, unsigned threads, const std::atomic<bool>* stop = nullptr) {
+    const size_t width = sample_bytes(audio.sample_format);
+    const int64_t blocks = block_count(audio.stored_frames, audio.block_frames);
+    const size_t full_block_bytes = audio.block_frames * audio.channels * width;
+    std::atomic<int64_t> next{0};
+    std::atomic<int64_t> bad{0};
+    
+    auto worker = [&]() {
+        int64_t i;
+        while ((!stop || !*stop) && (i = next++) < blocks) {
+            int64_t block = (first_block + i) % blocks;
+            const char* data = audio.samples + block * full_block_bytes;
+            size_t size = block_bytes(audio.stored_frames, audio.channels, width, audio.block_frames, audio.planar, block);
+            if (XXH3_64bits(data, size) != audio.checksums[block + 1]) {
+                audio.corrupt[block] = true;
+                bad++;
+                std::cerr << "\n⚠️  Block " << block << " failed its checksum - playing silence\n";
+            }
+        }
+    };
+    
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; i++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    return bad;
+}
+
+// 🔒 Take the checksum table (already read) and check the header against it - false = corrupt header
+bool accept_checksums(AudioData& audio, const char* head, size_t head_size, const char* table, size_t table_size) {
+    audio.checksums = parse_checksum_table(table, table_size);
+    if (XXH3_64bits(head, head_size) != audio.checksums[0]) {
+        std::cerr << "❌ Header checksum mismatch - the file is corrupt (--no-verify plays it anyway)\n";
+        return false;
+    }
+    audio.corrupt = std::make_unique<std::atomic<bool>[]>(audio.checksums.size() - 1);
+    return true;
+}
+
+// 🔒 Silence whatever part of [first, first + count) lies in blocks that failed verification
+void mute_corrupt_frames(const AudioData& audio, int64_t first, int64_t count, float* out) {
+    for (int64_t done = 0; done < count;) {
+        int64_t block = (first + done) / audio.block_frames;
+        int64_t n = std::min(count - done, (block + 1) * audio.block_frames - (first + done));
+        if (audio.corrupt[block]) std::memset(out + done * audio.channels, 0, n * audio.channels * sizeof(float));
+        done += n;
+    }
+}
+
+// ⏸️ RENDER count FRAMES of the track from `first` into interleaved `out`: runs come out of the run
+// table, everything else out of the payload (muted where a block failed its checksum)
+void render_frames(const AudioData& audio, int64_t first, int64_t count, float* out) {
+    size_t r = run_at(audio.runs, first);
+    while (count > 0) {
+        int64_t n;
+        if (r < audio.runs.size() && first >= audio.runs[r].first) {
+            const SampleRun& run = audio.runs[r++];
+            n = std::min(count, run.first + run.frames - first);
+            for (int64_t i = 0; i < n; i++) {
+                std::memcpy(out + i * audio.channels, run.value.data(), audio.channels * sizeof(float));
+            }
+        } else {
+            const int64_t skipped = r < audio.runs.size() ? audio.runs[r].skipped : audio.total_samples - audio.stored_frames;
+            n = r < audio.runs.size() ? std::min(count, audio.runs[r].first - first) : count;
+            copy_frames(audio, first - skipped, n, out);
+            if (audio.corrupt) mute_corrupt_frames(audio, first - skipped, n, out);
+        }
+        out += n * audio.channels;
+        first += n;
+        count -= n;
+    }
+}
+
+// Where frame `frame` of the track lives in the payload (a run maps to the stored frame after it)
+int64_t stored_frame(const AudioData& audio, int64_t frame) {
+    size_t r = run_at(audio.runs, frame);
+    if (r == audio.runs.size()) return frame - (audio.total_samples - audio.stored_frames);
+    return std::min(frame, audio.runs[r].first) - audio.runs[r].skipped;
+}
+
+void print_verify_result(int64_t blocks, int64_t bad, size_t bytes, double seconds) {
+    if (bad == 0) {
+        std::cout << "  🔒 " << blocks << " block checksums OK (" << bytes / 1024.0 / 1024.0 << " MB in "
+                  << seconds * 1000.0 << " ms, " << bytes / seconds / 1e9 << " GB/s)\n";
+    } else {
+        std::cout << "  ⚠️  " << bad << " of " << blocks << " blocks failed their checksum\n";
+    }
+}
+
+// 📈 WAVEFORM + LOUDNESS FROM THE OVERVIEW ALONE (what --overview prints - no sample is read)
+void print_overview(const AudioData& audio, int columns, double window_seconds) {
+    const Overview& overview = audio.overview;
+    auto db = [](float level) { return level > 0.0f ? 20.0 * std::log10(level) : -INFINITY; };
+    static const char* bars[] = {" ", "▁", "▂", "▃", "▄", "▅", "▆", "▇", "█"};
+    
+    std::cout << "\n📈 Overview: " << overview.levels.size() << " levels (";
+    for (size_t level = 0; level < overview.levels.size(); level++) {
+        std::cout << (level ? "/" : "") << overview.levels[level].bucket_frames;
+    }
+    std::cout << "-frame buckets)\n";
+    
+    auto query_start = std::chrono::steady_clock::now();
+    std::vector<OverviewStats> column_stats(columns);
+    for (int c = 0; c < columns; c++) {
+        int64_t first = audio.total_samples * c / columns;
+        int64_t last = audio.total_samples * (c + 1) / columns;
+        column_stats[c] = overview_range(overview, first, std::max<int64_t>(1, last - first));
+    }
+    double waveform_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - query_start).count();
+    
+    std::string peak_line, rms_line;
+    for (const auto& stats : column_stats) {
+        float peak = std::max(-stats.min, stats.max);
+        peak_line += bars[std::min(8, (int)std::ceil(std::min(1.0f, peak) * 8.0f))];
+        rms_line += bars[std::min(8, (int)std::ceil(std::min(1.0f, stats.rms) * 8.0f))];
+    }
+    std::cout << "  peak │" << peak_line << "│\n";
+    std::cout << "  rms  │" << rms_line << "│\n";
+    std::cout << "        0s" << std::string(std::max(0, columns - 10), ' ') << std::fixed << std::setprecision(1)
+              << (double)audio.total_samples / audio.sample_rate << "s\n";
+    
+    OverviewStats whole = overview_range(overview, 0, audio.total_samples);
+    std::cout << "  🔊 Whole track: peak " << db(std::max(-whole.min, whole.max)) << " dBFS, RMS " << db(whole.rms)
+              << " dBFS\n";
+    
+    query_start = std::chrono::steady_clock::now();
+    float loudest_rms = 0.0f;
+    int64_t window = std::max<int64_t>(1, std::min<int64_t>(audio.total_samples, window_seconds * audio.sample_rate));
+    int64_t loudest = overview_loudest(overview, window, loudest_rms);
+    double loudest_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - query_start).count();
+    std::cout << "  🔥 Loudest " << (double)window / audio.sample_rate << " s: " << (double)loudest / audio.sample_rate
+              << "s - " << (double)(loudest + window) / audio.sample_rate << "s (RMS " << db(loudest_rms) << " dBFS)\n";
+    std::cout << "  ⏱️  " << columns << "-column waveform in " << waveform_us << " µs, loudest window in "
+              << loudest_us << " µs\n";
+    std::cout << std::defaultfloat << std::setprecision(6);
+}
+
+// ⚙️ PLAYER OPTIONS
+struct PlayerSettings {
+    bool use_mmap = true;
+    bool direct = false;            // Read with O_DIRECT (no page cache) instead of mapping
+    double readahead_seconds = 5.0; // How far ahead of the play head mapped pages get prefetched (0 = off)
+    double start_seconds = 0.0;     // Where playback starts
+    bool preload = false;           // Seekable HMICAP7: decode everything up front instead of on demand
+    bool bench = false;             // Benchmark full HMICAP7 decode at 1..threads threads, then exit
+    bool bench_io = false;          // Benchmark iostream vs async loading of the file, then exit
+    bool verify = true;             // Check per-block checksums when the file has them
+    bool overview = false;          // Print the waveform/loudness overview (read on its own), then exit
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+};
+
+// ⏱️ PARSE "90", "90.5" or "1:30.5" INTO SECONDS
+bool parse_time_arg(const std::string& text, double& seconds) {
+    size_t colon = text.find(':');
+    char* end = nullptr;
+    
+    if (colon == std::string::npos) {
+        seconds = std::strtod(text.c_str(), &end);
+        return end && *end == '\0' && seconds >= 0.0;
+    }
+    
+    long minutes = std::strtol(text.substr(0, colon).c_str(), &end, 10);
+    if (!end || *end != '\0' || minutes < 0) return false;
+    
+    std::string rest = text.substr(colon + 1);
+    double secs = std::strtod(rest.c_str(), &end);
+    if (!end || *end != '\0' || secs < 0.0 || secs >= 60.0) return false;
+    
+    seconds = minutes * 60.0 + secs;
+    return true;
+}
+
+// 📦 TRACK PACKS ═══════════════════════════════════════════════════════════
+// A .hmipack holds many HMICAP/HMICAP7 tracks back to back, each the unchanged file image on its
+// own PACK_ALIGN boundary (page-aligned payloads and O_DIRECT reads still line up inside it).
+// The index fills the first pages: header, fixed-size entries sorted by name, then the names.
+// The player maps the pack, finds "library.hmipack:NAME" with one binary search and then maps
+// (or reads) just that track's byte range - the loaders never know it isn't a file of its own.
+const size_t PACK_ALIGN = 4096;
+const char* PACK_EXTENSION = ".hmipack";
+
+struct PackHeader {
+    char magic[8];           // "HMIPACK1"
+    uint32_t flags;          // None defined yet (readers refuse unknown ones)
+    uint32_t tracks;
+    uint64_t index_bytes;    // Entries + name table, right after this header
+    uint64_t index_checksum; // xxh3 of those index_bytes
+    uint64_t data_offset;    // First track (PACK_ALIGN-aligned: the index pages end here)
+    uint64_t pack_bytes;     // Whole file - a shorter one was cut off
+    uint8_t reserved[16];
+};
+static_assert(sizeof(PackHeader) == 64, "pack header is 64 bytes on disk");
+
+const uint16_t PACK_TRACK_HMICAP = 0;
+const uint16_t PACK_TRACK_HMICAP7 = 1;
+
+struct PackEntry {
+    uint64_t offset;        // Track image in the pack (PACK_ALIGN-aligned)
+    uint64_t length;        // Track image bytes
+    uint64_t total_samples; // Per channel
+    uint32_t sample_rate;
+    uint16_t channels;
+    uint16_t format;        // PACK_TRACK_HMICAP / PACK_TRACK_HMICAP7
+    uint32_t header_flags;  // The track's own header.flags (seekable, LZ4, ...)
+    uint32_t name_offset;   // Into the name table (names aren't NUL-terminated)
+    uint32_t name_length;
+    uint32_t reserved;
+};
+static_assert(sizeof(PackEntry) == 48, "pack entry is 48 bytes on disk");
+
+// "library.hmipack:Artist/Song" → "library.hmipack" + "Artist/Song" (false for any other path)
+bool split_pack_path(const std::string& path, std::string& pack, std::string& track) {
+    std::string lower = path;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    size_t at = lower.find(std::string(PACK_EXTENSION) + ":");
+    if (at == std::string::npos) return false;
+    pack = path.substr(0, at + std::strlen(PACK_EXTENSION));
+    track = path.substr(at + std::strlen(PACK_EXTENSION) + 1);
+    return true;
+}
+
+// 🔍 THE INDEX OF A MAPPED PACK, read in place (entries sit 8-aligned right after the header)
+struct PackIndex {
+    const PackHeader* header = nullptr;
+    const PackEntry* entries = nullptr;
+    const char* names = nullptr;
+    
+    // False (after saying why) unless the header, checksum and every entry add up
+    bool parse(const char* data, size_t size) {
+        header = reinterpret_cast<const PackHeader*>(data);
+        const char* problem = nullptr;
+        if (size < sizeof(PackHeader) || std::memcmp(header->magic, "HMIPACK1", 8) != 0) {
+            problem = "bad magic number";
+        } else if (header->flags != 0) {
+            problem = "written by a newer converter";
+        } else if (header->pack_bytes != size) {
+            problem = "truncated";
+        } else if (header->index_bytes > size - sizeof(PackHeader) ||
+                   (uint64_t)header->tracks * sizeof(PackEntry) > header->index_bytes ||
+                   header->data_offset < sizeof(PackHeader) + header->index_bytes || header->data_offset > size) {
+            problem = "index out of bounds";
+        } else if (XXH3_64bits(data + sizeof(PackHeader), header->index_bytes) != header->index_checksum) {
+            problem = "index checksum mismatch";
+        }
+        entries = reinterpret_cast<const PackEntry*>(data + sizeof(PackHeader));
+        names = reinterpret_cast<const char*>(entries + (problem ? 0 : header->tracks));
+        const uint64_t name_bytes = problem ? 0 : header->index_bytes - header->tracks * sizeof(PackEntry);
+        for (uint32_t i = 0; !problem && i < header->tracks; i++) {
+            const PackEntry& entry = entries[i];
+            if (entry.offset % PACK_ALIGN || entry.offset < header->data_offset || entry.length > size - entry.offset ||
+                entry.format > PACK_TRACK_HMICAP7 || entry.name_offset > name_bytes ||
+                entry.name_length > name_bytes - entry.name_offset || (i > 0 && !less(entries[i - 1], entry))) {
+                problem = "bad track entry";
+            }
+        }
+        if (problem) {
+            std::cerr << "❌ Invalid pack (" << problem << ")\n";
+            return false;
+        }
+        return true;
+    }
+    
+    std::string name(const PackEntry& entry) const {
+        return std::string(names + entry.name_offset, entry.name_length);
+    }
+    
+    // Byte order, shorter first on a tie - the order std::string sorts the names in when packing
+    bool less(const PackEntry& entry, const char* name, size_t length) const {
+        int order = std::memcmp(names + entry.name_offset, name, std::min<size_t>(entry.name_length, length));
+        return order < 0 || (order == 0 && entry.name_length < length);
+    }
+    
+    bool less(const PackEntry& a, const PackEntry& b) const {
+        return less(a, names + b.name_offset, b.name_length);
+    }
+    
+    const PackEntry* find(const std::string& track) const {
+        const PackEntry* end = entries + header->tracks;
+        const PackEntry* entry = std::lower_bound(entries, end, track, [this](const PackEntry& e, const std::string& name) {
+            return less(e, name.data(), name.size());
+        });
+        return entry != end && entry->name_length == track.size() &&
+                       std::memcmp(names + entry->name_offset, track.data(), track.size()) == 0
+                   ? entry
+                   : nullptr;
+    }
+};
+
+// 📋 One line per track: name, format, rate, channels, length, size
+void print_pack_index(const PackIndex& pack) {
+    for (uint32_t i = 0; i < pack.header->tracks; i++) {
+        const PackEntry& entry = pack.entries[i];
+        std::cout << "  🎵 " << std::left << std::setw(40) << pack.name(entry) << std::right
+                  << std::setw(8) << (entry.format == PACK_TRACK_HMICAP7 ? "HMICAP7" : "HMICAP")
+                  << std::setw(7) << entry.sample_rate << " Hz " << entry.channels << " ch "
+                  << std::setw(8) << std::fixed << std::setprecision(1)
+                  << (double)entry.total_samples / std::max<uint32_t>(1, entry.sample_rate) << " s "
+                  << std::setw(8) << entry.length / 1024.0 / 1024.0 << " MB\n" << std::defaultfloat << std::setprecision(6);
+    }
+}
+
+// 📦 MAP A PACK AND CHECK ITS INDEX - only the index pages get touched here
+bool open_pack(const std::string& path, MappedFile& mapping, PackIndex& pack) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0 || info.st_size == 0) {
+        std::cerr << "❌ Failed to open pack: " << std::strerror(errno) << "\n";
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    void* base = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "❌ Failed to map pack: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    mapping.base = static_cast<char*>(base);
+    mapping.length = info.st_size;
+    return pack.parse(mapping.base, mapping.length);
+}
+
+// ⚡ ASYNC FILE I/O ════════════════════════════════════════════════════════
+// io_uring through the raw kernel ABI (no liburing needed): up to IO_QUEUE_DEPTH aligned
+// IO_CHUNK_BYTES requests stay in flight while the caller decodes/compresses the chunk before.
+// Kernels or sandboxes without io_uring get the same interface on plain pread/pwrite.
+// --direct opens files with O_DIRECT as well: the page cache is bypassed, which needs the
+// buffer, the file offset and the length all in whole IO_ALIGN units.
+const size_t IO_CHUNK_BYTES = 1 << 20;
+const unsigned IO_QUEUE_DEPTH = 4;
+const size_t IO_ALIGN = 4096;
+
+inline size_t io_align_up(size_t length) {
+    return (length + IO_ALIGN - 1) / IO_ALIGN * IO_ALIGN;
+}
+
+inline bool io_aligned(const void* buffer, uint64_t offset) {
+    return reinterpret_cast<uintptr_t>(buffer) % IO_ALIGN == 0 && offset % IO_ALIGN == 0;
+}
+
+// Full pread/pwrite of `length` bytes (stops early only at EOF) - bytes done, or -errno
+int64_t io_full(bool write, int fd, char* buffer, size_t length, uint64_t offset) {
+    size_t done = 0;
+    while (done < length) {
+        ssize_t n = write ? pwrite(fd, buffer + done, length - done, offset + done)
+                          : pread(fd, buffer + done, length - done, offset + done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) return -errno;
+        if (n == 0) break;
+        done += n;
+    }
+    return done;
+}
+
+struct IoCompletion {
+    uint64_t tag;
+    int64_t result; // Bytes transferred or -errno
+};
+
+// 🔁 ONE SUBMISSION/COMPLETION RING (or the synchronous stand-in)
+class IoRing {
+public:
+    explicit IoRing(unsigned depth) {
+#if HMICAP_HAVE_IO_URING
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ring_fd = (int)syscall(__NR_io_uring_setup, depth, &params);
+        if (ring_fd < 0) return;
+        
+        sq_bytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_bytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single_map = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_map) sq_bytes = cq_bytes = std::max(sq_bytes, cq_bytes);
+        sqe_bytes = params.sq_entries * sizeof(io_uring_sqe);
+        
+        sq_map = mmap(nullptr, sq_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+        cq_map = single_map ? sq_map
+                            : mmap(nullptr, cq_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+        void* sqe_map = mmap(nullptr, sqe_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+        if (sq_map == MAP_FAILED || cq_map == MAP_FAILED || sqe_map == MAP_FAILED) {
+            if (sqe_map != MAP_FAILED) munmap(sqe_map, sqe_bytes);
+            sqes = nullptr;
+            teardown();
+            return;
+        }
+        
+        char* sq = static_cast<char*>(sq_map);
+        char* cq = static_cast<char*>(cq_map);
+        sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        sqes = static_cast<io_uring_sqe*>(sqe_map);
+#else
+        (void)depth;
+#endif
+    }
+    
+    ~IoRing() { teardown(); }
+    IoRing(const IoRing&) = delete;
+    IoRing& operator=(const IoRing&) = delete;
+    
+    bool uring() const { return ring_fd >= 0; }
+    
+    // Queue one read/write (never more than `depth` outstanding); the fallback does it right away
+    void submit(bool write, int fd, char* buffer, size_t length, uint64_t offset, uint64_t tag) {
+#if HMICAP_HAVE_IO_URING
+        if (uring()) {
+            unsigned tail = *sq_tail;
+            unsigned index = tail & sq_mask;
+            io_uring_sqe& sqe = sqes[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = write ? IORING_OP_WRITE : IORING_OP_READ;
+            sqe.fd = fd;
+            sqe.addr = reinterpret_cast<uint64_t>(buffer);
+            sqe.len = length;
+            sqe.off = offset;
+            sqe.user_data = tag;
+            sq_array[index] = index;
+            __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+            
+            bool queued = true;
+            while (syscall(__NR_io_uring_enter, ring_fd, 1, 0, 0, nullptr, 0) < 0) {
+                if (errno == EINTR || errno == EAGAIN) continue;
+                // Never taken by the kernel - do it here so the caller still gets its completion
+                __atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+                queued = false;
+                break;
+            }
+            if (queued) return;
+        }
+#endif
+        finished.push_back({tag, io_full(write, fd, buffer, length, offset)});
+    }
+    
+    // Next completion, in whatever order the device finished them
+    IoCompletion wait() {
+        if (!finished.empty()) {
+            IoCompletion completion = finished.front();
+            finished.pop_front();
+            return completion;
+        }
+#if HMICAP_HAVE_IO_URING
+        while (uring()) {
+            unsigned head = *cq_head;
+            if (head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+                const io_uring_cqe& cqe = cqes[head & cq_mask];
+                IoCompletion completion = {cqe.user_data, cqe.res};
+                __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+                return completion;
+            }
+            if (syscall(__NR_io_uring_enter, ring_fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR) {
+                return {~0ull, -errno};
+            }
+        }
+#endif
+        return {~0ull, -EINVAL}; // Nothing outstanding
+    }
+    
+private:
+    void teardown() {
+#if HMICAP_HAVE_IO_URING
+        if (sqes) munmap(sqes, sqe_bytes);
+        if (cq_map != MAP_FAILED && cq_map != sq_map) munmap(cq_map, cq_bytes);
+        if (sq_map != MAP_FAILED) munmap(sq_map, sq_bytes);
+        sqes = nullptr;
+        sq_map = cq_map = MAP_FAILED;
+#endif
+        if (ring_fd >= 0) close(ring_fd);
+        ring_fd = -1;
+    }
+    
+    int ring_fd = -1;
+    std::deque<IoCompletion> finished; // Done synchronously, not handed out yet
+#if HMICAP_HAVE_IO_URING
+    void* sq_map = MAP_FAILED;
+    void* cq_map = MAP_FAILED;
+    size_t sq_bytes = 0, cq_bytes = 0, sqe_bytes = 0;
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_array = nullptr;
+    unsigned sq_mask = 0;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned cq_mask = 0;
+    io_uring_cqe* cqes = nullptr;
+    io_uring_sqe* sqes = nullptr;
+#endif
+};
+
+// One aligned chunk buffer and the request it is part of
+struct IoSlot {
+    char* buffer = nullptr;
+    uint64_t offset = 0;
+    size_t length = 0;
+    int64_t result = 0;
+    bool busy = false; // Submitted, completion not seen yet
+};
+
+const char* io_engine_name(const IoRing& ring) {
+    return ring.uring() ? "io_uring" : "pread/pwrite";
+}
+
+// 📖 ASYNC READER: streams a file front to back with the next reads already in flight, or
+// reads a range straight into the caller's buffer IO_QUEUE_DEPTH chunks at a time. Opened
+// `direct`, aligned reads go through a second O_DIRECT descriptor; anything unaligned (small
+// metadata reads, a range's last partial page, EOF stragglers) still takes the cached one.
+// Opened on a packed track, offsets and size() are the track's (it starts on a PACK_ALIGN page).
+class AsyncReader {
+public:
+    AsyncReader() : ring(IO_QUEUE_DEPTH), slots(IO_QUEUE_DEPTH) {}
+    ~AsyncReader() { close_file(); }
+    AsyncReader(const AsyncReader&) = delete;
+    AsyncReader& operator=(const AsyncReader&) = delete;
+    
+    bool open(const std::string& path, bool direct = false, const PackEntry* packed = nullptr) {
+        close_file();
+        fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat info;
+        if (fd < 0 || fstat(fd, &info) != 0 || (packed && packed->offset + packed->length > (uint64_t)info.st_size)) {
+            close_file();
+            return false;
+        }
+        base_offset = packed ? packed->offset : 0;
+        file_size = packed ? packed->length : info.st_size;
+        posix_fadvise(fd, base_offset, file_size, POSIX_FADV_SEQUENTIAL);
+        // Filesystems without O_DIRECT refuse it (EINVAL) - then everything stays cached, see direct()
+        if (direct) direct_fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT);
+        return true;
+    }
+    
+    uint64_t size() const { return file_size; }
+    bool direct() const { return direct_fd >= 0; }
+    const char* engine() const { return io_engine_name(ring); }
+    
+    // Stream [offset, size()) in order: each next() hands out one chunk (valid until the
+    // following call) and puts the slot it had back to work further ahead
+    void start(uint64_t offset = 0) {
+        drain();
+        next_offset = offset;
+        head = 0;
+        current = -1;
+        for (size_t i = 0; i < slots.size(); i++) {
+            if (!slots[i].buffer) slots[i].buffer = static_cast<char*>(std::aligned_alloc(IO_ALIGN, IO_CHUNK_BYTES));
+            queue_slot(i);
+        }
+    }
+    
+    bool next(const char*& data, size_t& length) {
+        if (current >= 0) queue_slot(current);
+        current = -1;
+        
+        IoSlot& slot = slots[head];
+        if (!slot.busy) return false; // Past the end
+        while (slot.busy && !failed) reap();
+        if (failed) return false;
+        
+        data = slot.buffer;
+        length = slot.result;
+        current = head;
+        head = (head + 1) % slots.size();
+        return length > 0;
+    }
+    
+    // Read [offset, offset + length) into `out` (must exist in the file) with several requests in flight
+    bool read_at(char* out, size_t length, uint64_t offset) {
+        drain();
+        if (offset + length > file_size) return false;
+        
+        // O_DIRECT takes the whole pages; the partial one at the end comes from the cached descriptor
+        offset += base_offset;
+        const bool bypass = direct_fd >= 0 && io_aligned(out, offset);
+        const size_t tail = bypass ? length % IO_ALIGN : 0;
+        const int read_fd = bypass ? direct_fd : fd;
+        length -= tail;
+        
+        std::vector<IoSlot> ranges((length + IO_CHUNK_BYTES - 1) / IO_CHUNK_BYTES);
+        size_t submitted = 0, completed = 0;
+        // Keep going until everything submitted has landed - the kernel must be done with `out` when we return
+        while (completed < submitted || (submitted < ranges.size() && !failed)) {
+            while (!failed && submitted < ranges.size() && submitted - completed < IO_QUEUE_DEPTH) {
+                IoSlot& range = ranges[submitted];
+                range.buffer = out + submitted * IO_CHUNK_BYTES;
+                range.offset = offset + submitted * IO_CHUNK_BYTES;
+                range.length = std::min(IO_CHUNK_BYTES, length - submitted * IO_CHUNK_BYTES);
+                ring.submit(false, read_fd, range.buffer, range.length, range.offset, submitted);
+                submitted++;
+            }
+            IoCompletion completion = ring.wait();
+            if (completion.tag >= ranges.size()) {
+                failed = true; // The ring itself broke
+                break;
+            }
+            IoSlot& range = ranges[completion.tag];
+            finish_read(range, completion.result);
+            if (range.result != (int64_t)range.length) failed = true;
+            completed++;
+        }
+        if (tail && !failed && io_full(false, fd, out + length, tail, offset + length) != (int64_t)tail) failed = true;
+        return !failed;
+    }
+    
+    bool ok() const { return !failed; }
+    
+private:
+    void queue_slot(size_t index) {
+        IoSlot& slot = slots[index];
+        if (next_offset >= file_size) return;
+        slot.offset = base_offset + next_offset;
+        slot.length = std::min<uint64_t>(IO_CHUNK_BYTES, file_size - next_offset);
+        slot.busy = true;
+        next_offset += slot.length;
+        // O_DIRECT reads the whole pages, finish_read picks up the partial one at the end of the file
+        const size_t pages = slot.length / IO_ALIGN * IO_ALIGN;
+        if (direct_fd >= 0 && slot.offset % IO_ALIGN == 0 && pages > 0) {
+            ring.submit(false, direct_fd, slot.buffer, pages, slot.offset, index);
+        } else {
+            ring.submit(false, fd, slot.buffer, slot.length, slot.offset, index);
+        }
+    }
+    
+    // A short read that isn't EOF just means "not all of it yet" - finish it synchronously
+    // (through the cached descriptor, the rest needn't be aligned)
+    void finish_read(IoSlot& slot, int64_t result) {
+        if (result >= 0 && (size_t)result < slot.length) {
+            int64_t rest = io_full(false, fd, slot.buffer + result, slot.length - result, slot.offset + result);
+            result = rest < 0 ? rest : result + rest;
+        }
+        slot.result = result;
+    }
+    
+    void reap() {
+        IoCompletion completion = ring.wait();
+        if (completion.tag >= slots.size()) {
+            lose_ring();
+            return;
+        }
+        IoSlot& slot = slots[completion.tag];
+        slot.busy = false;
+        finish_read(slot, completion.result);
+        if (slot.result != (int64_t)slot.length) failed = true;
+    }
+    
+    // The ring itself broke: nothing more will complete
+    void lose_ring() {
+        for (IoSlot& slot : slots) slot.busy = false;
+        failed = true;
+    }
+    
+    void drain() {
+        for (IoSlot& slot : slots) {
+            while (slot.busy) reap();
+        }
+        failed = false;
+    }
+    
+    void close_file() {
+        drain();
+        for (IoSlot& slot : slots) {
+            std::free(slot.buffer);
+            slot.buffer = nullptr;
+        }
+        if (fd >= 0) close(fd);
+        if (direct_fd >= 0) close(direct_fd);
+        fd = direct_fd = -1;
+    }
+    
+    IoRing ring;
+    std::vector<IoSlot> slots;
+    int fd = -1;
+    int direct_fd = -1; // O_DIRECT twin of fd (opened `direct` and supported), else -1
+    uint64_t base_offset = 0; // Where the packed track starts in the file (0 = a file of its own)
+    uint64_t file_size = 0;
+    uint64_t next_offset = 0;
+    size_t head = 0;  // Slot holding the next chunk in file order
+    int current = -1; // Slot handed out by the last next()
+    bool failed = false;
+};
+
+// 🗺️ MAP HMICAP FILE - the callback reads samples straight out of the page cache, nothing is copied
+// and every process playing the same file shares the same physical pages. A packed track maps
+// just its own pages of the pack.
+bool map_file(const std::string& path, MappedFile& mapping, const PackEntry* packed = nullptr) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "❌ Failed to open file: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    
+    struct stat info;
+    const uint64_t offset = packed ? packed->offset : 0;
+    const uint64_t length = packed ? packed->length : 0;
+    if (fstat(fd, &info) != 0 || offset + length > (uint64_t)info.st_size ||
+        (packed ? length : (uint64_t)info.st_size) < sizeof(HMICAPHeader)) {
+        std::cerr << "❌ File too small to be HMICAP\n";
+        close(fd);
+        return false;
+    }
+    
+    // PACK_ALIGN is a page on 4 KiB-page systems; bigger pages map from the boundary below
+    const size_t lead = offset % sysconf(_SC_PAGESIZE);
+    const size_t size = packed ? length : info.st_size;
+    void* base = mmap(nullptr, size + lead, PROT_READ, MAP_SHARED, fd, offset - lead);
+    close(fd); // The mapping keeps the file alive
+    if (base == MAP_FAILED) {
+        std::cerr << "⚠️  mmap failed (" << std::strerror(errno) << "), falling back to a full read\n";
+        return false;
+    }
+    
+    mapping.base = static_cast<char*>(base) + lead;
+    mapping.length = size;
+    mapping.lead = lead;
+    
+    // Playback walks the file front to back: aggressive kernel readahead, drop pages behind us early
+    madvise(base, size + lead, MADV_SEQUENTIAL);
+    return true;
+}
+
+// 🧮 Check header.sample_format and say what the callback will be expanding
+bool accept_sample_format(uint16_t format) {
+    if (!known_sample_format(format)) {
+        std::cerr << "❌ Unsupported sample format " << format << " (newer converter?)\n";
+        return false;
+    }
+    if (format != SAMPLE_FLOAT32) {
+        std::cout << "  🧮 Samples: " << sample_format_name(format) << " (" << sample_bytes(format)
+                  << " bytes each, expanded to float as they play)\n";
+    }
+    return true;
+}
+
+// 📈 Take an overview section (already read) for --overview - false = missing or corrupt
+bool accept_overview(AudioData& audio, const char* data, size_t size, bool verify) {
+    if (!parse_overview(audio.overview, data, size, audio.channels, audio.total_samples, verify)) {
+        std::cerr << "❌ Overview section is missing or corrupt\n";
+        return false;
+    }
+    std::cout << "  📈 Overview loaded: " << size / 1024.0 << " KB, not a single sample read 🚀\n";
+    return true;
+}
+
+bool require_overview(uint32_t flags) {
+    if (flags & HMICAP_FLAG_OVERVIEW) return true;
+    std::cerr << "❌ This file has no overview (convert it again without --no-overview)\n";
+    return false;
+}
+
+// 🧬 DECODE EVERY XOR-CODED BLOCK of `coded` (block b spans starts[b]..starts[b + 1]) into
+// audio.sample_data - blocks are independent, so workers grab the next one. A block that fails
+// its checksum (when verifying) or doesn't decode stays silent.
+void decode_xor_blocks(AudioData& audio, const char* coded, const std::vector<uint64_t>& starts, unsigned threads) {
+    const int64_t blocks = starts.size() - 1;
+    auto start = std::chrono::steady_clock::now();
+    audio.sample_data.assign(audio.total_samples * audio.channels * sizeof(float), 0);
+    float* samples = reinterpret_cast<float*>(audio.sample_data.data());
+    std::atomic<int64_t> next{0};
+    std::atomic<int64_t> bad{0};
+    
+    auto worker = [&]() {
+        std::vector<float> planes(planar_stride(audio.block_frames) * audio.channels);
+        int64_t block;
+        while ((block = next++) < blocks) {
+            const char* data = coded + starts[block];
+            const size_t size = starts[block + 1] - starts[block];
+            const int64_t first = block * audio.block_frames;
+            const size_t frames = std::min(audio.block_frames, audio.total_samples - first);
+            const size_t stride = planar_stride(frames);
+            bool ok = audio.checksums.empty() || XXH3_64bits(data, size) == audio.checksums[block + 1];
+            if (ok && xor_decode_block(data, size, frames, audio.channels, planes.data(), stride)) {
+                interleave_planes(planes.data(), stride, audio.channels, frames, samples + first * audio.channels);
+            } else {
+                bad++;
+                std::cerr << "⚠️  Block " << block << (ok ? " doesn't decode" : " failed its checksum")
+                          << " - playing silence\n";
+            }
+        }
+    };
+    
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; i++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "  🧬 Decoded " << blocks << " XOR blocks (" << starts.back() / 1024.0 / 1024.0 << " MB → "
+              << audio.sample_data.size() / 1024.0 / 1024.0 << " MB) in " << seconds * 1000.0 << " ms ("
+              << audio.sample_data.size() / seconds / 1e9 << " GB/s, " << threads << " threads)\n";
+    if (!audio.checksums.empty() && bad == 0) {
+        std::cout << "  🔒 " << blocks << " block checksums OK\n";
+    }
+    audio.samples = audio.sample_data.data();
+}
+
+// 📂 LOAD HMICAP FILE (INSTANT LOADING - NO PARSING!!) - `packed` = a track of the pack at `path`
+bool load_hmicap(const std::string& path, AudioData& audio, const PlayerSettings& settings,
+                 const PackEntry* packed = nullptr) {
+    std::cout << "📂 Loading HMICAP file...\n";
+    
+    HMICAPHeader header;
+    bool mapped = settings.use_mmap && !settings.direct && map_file(path, audio.mapping, packed);
+    AsyncReader file;
+    
+    if (mapped) {
+        std::memcpy(&header, audio.mapping.base, sizeof(header));
+    } else {
+        if (!file.open(path, settings.direct, packed)) {
+            std::cerr << "❌ Failed to open file\n";
+            return false;
+        }
+        
+        // Read header
+        if (!file.read_at(reinterpret_cast<char*>(&header), sizeof(header), 0)) {
+            std::cerr << "❌ File too small to be HMICAP\n";
+            return false;
+        }
+    }
+    
+    // Verify magic number
+    if (std::memcmp(header.magic, "HMICAP01", 8) != 0) {
+        std::cerr << "❌ Invalid HMICAP file (bad magic number)\n";
+        return false;
+    }
+    
+    audio.sample_rate = header.sample_rate;
+    audio.channels = header.channels;
+    audio.total_samples = header.total_samples;
+    audio.stored_frames = header.total_samples;
+    audio.sample_format = header.sample_format;
+    audio.planar = header.flags & HMICAP_FLAG_PLANAR;
+    audio.block_frames = header.block_frames;
+    if (audio.planar && (header.block_frames == 0 || header.block_frames % PLANAR_ALIGN_FRAMES)) {
+        std::cerr << "❌ Planar HMICAP with a bad block size (" << header.block_frames << ")\n";
+        return false;
+    }
+    if ((header.flags & HMICAP_FLAG_CHECKSUMS) && header.block_frames == 0) {
+        std::cerr << "❌ Checksummed HMICAP without a block size\n";
+        return false;
+    }
+    const bool xor_coded = header.flags & HMICAP_FLAG_XOR;
+    if (xor_coded && (header.block_frames == 0 || audio.sample_format != SAMPLE_FLOAT32 || audio.planar ||
+                      (header.flags & HMICAP_FLAG_RUNS))) {
+        std::cerr << "❌ XOR-coded HMICAP with a bad layout\n";
+        return false;
+    }
+    
+    std::cout << "  ✅ Valid HMICAP header detected! 💚\n";
+    std::cout << "  🎵 Sample rate: " << audio.sample_rate << " Hz\n";
+    std::cout << "  🎧 Channels: " << audio.channels << "\n";
+    std::cout << "  📊 Total samples: " << audio.total_samples << " per channel\n";
+    std::cout << "  ⏱️  Duration: " << (float)audio.total_samples / audio.sample_rate << " seconds\n";
+    if (!accept_sample_format(audio.sample_format)) {
+        return false;
+    }
+    
+    const size_t offset = payload_offset(header.flags);
+    const size_t file_size = mapped ? audio.mapping.length : file.size();
+    size_t content_end = file_size; // Where the run table or XOR block index starts
+    
+    // ⏸️ Run table: footer at the very end, entries right before it
+    if (header.flags & HMICAP_FLAG_RUNS) {
+        RunFooter footer;
+        const size_t entry = run_entry_bytes(audio.channels);
+        bool ok = file_size >= offset + sizeof(footer);
+        if (ok && mapped) {
+            std::memcpy(&footer, audio.mapping.base + file_size - sizeof(footer), sizeof(footer));
+        } else if (ok) {
+            ok = file.read_at(reinterpret_cast<char*>(&footer), sizeof(footer), file_size - sizeof(footer));
+        }
+        if (!ok || std::memcmp(footer.magic, "HRUN", 4) != 0 || footer.stored_frames > (uint64_t)audio.total_samples ||
+            (uint64_t)footer.runs * entry > file_size - offset - sizeof(footer)) {
+            std::cerr << "❌ Run table is missing or corrupt\n";
+            return false;
+        }
+        content_end = file_size - sizeof(footer) - footer.runs * entry;
+        std::vector<char> entries(mapped ? 0 : footer.runs * entry);
+        if (!entries.empty() && !file.read_at(entries.data(), entries.size(), content_end)) {
+            std::cerr << "❌ Failed to read the run table\n";
+            return false;
+        }
+        if (!parse_run_table(audio.runs, mapped ? audio.mapping.base + content_end : entries.data(), footer,
+                             audio.channels, audio.total_samples, settings.verify)) {
+            return false;
+        }
+        audio.stored_frames = footer.stored_frames;
+        std::cout << "  ⏸️  " << footer.runs << " constant runs ("
+                  << (double)(audio.total_samples - audio.stored_frames) / audio.sample_rate
+                  << " s) synthesized on playback, " << audio.stored_frames << " frames stored\n";
+    }
+    
+    // 🧬 XOR block index: footer at the very end, one coded size per block right before it
+    std::vector<uint64_t> xor_starts; // Where each coded block starts in the payload, then where it ends
+    if (xor_coded) {
+        XorFooter footer;
+        const int64_t blocks = block_count(audio.total_samples, header.block_frames);
+        bool ok = file_size >= offset + sizeof(footer);
+        if (ok && mapped) {
+            std::memcpy(&footer, audio.mapping.base + file_size - sizeof(footer), sizeof(footer));
+        } else if (ok) {
+            ok = file.read_at(reinterpret_cast<char*>(&footer), sizeof(footer), file_size - sizeof(footer));
+        }
+        if (!ok || std::memcmp(footer.magic, "HXOR", 4) != 0 || footer.blocks != blocks ||
+            blocks * sizeof(uint64_t) > file_size - offset - sizeof(footer)) {
+            std::cerr << "❌ XOR block index is missing or corrupt\n";
+            return false;
+        }
+        content_end = file_size - sizeof(footer) - blocks * sizeof(uint64_t);
+        std::vector<uint64_t> sizes(blocks);
+        if (mapped) {
+            std::memcpy(sizes.data(), audio.mapping.base + content_end, blocks * sizeof(uint64_t));
+        } else if (blocks && !file.read_at(reinterpret_cast<char*>(sizes.data()), blocks * sizeof(uint64_t), content_end)) {
+            std::cerr << "❌ Failed to read the XOR block index\n";
+            return false;
+        }
+        if (settings.verify && XXH3_64bits(sizes.data(), blocks * sizeof(uint64_t)) != footer.checksum) {
+            std::cerr << "❌ XOR block index checksum mismatch - the file is corrupt (--no-verify plays it anyway)\n";
+            return false;
+        }
+        xor_starts.assign(1, 0);
+        for (uint64_t size : sizes) {
+            if (size > content_end - offset - xor_starts.back()) {
+                std::cerr << "❌ XOR block index points past the end of the file\n";
+                return false;
+            }
+            xor_starts.push_back(xor_starts.back() + size);
+        }
+    }
+    
+    size_t payload_bytes = xor_coded ? xor_starts.back()
+                                     : payload_samples(audio.stored_frames, audio.channels, header.block_frames,
+                                                       header.flags) * sample_bytes(audio.sample_format);
+    if (audio.planar) {
+        std::cout << "  🎚️  Planar blocks of " << audio.block_frames << " frames (interleaved on the way out)\n";
+    }
+    
+    // 📈 --overview: just the section after the payload and checksum table
+    if (settings.overview) {
+        const size_t section = offset + payload_bytes +
+                               checksum_table_bytes(audio.stored_frames, header.block_frames, header.flags);
+        if (!require_overview(header.flags)) return false;
+        if (content_end < section) {
+            std::cerr << "❌ File is truncated (overview missing)\n";
+            return false;
+        }
+        if (mapped) return accept_overview(audio, audio.mapping.base + section, content_end - section, settings.verify);
+        audio.overview.storage.resize(content_end - section);
+        if (!file.read_at(audio.overview.storage.data(), audio.overview.storage.size(), section)) {
+            std::cerr << "❌ Failed to read the overview\n";
+            return false;
+        }
+        return accept_overview(audio, audio.overview.storage.data(), audio.overview.storage.size(), settings.verify);
+    }
+    
+    const size_t table_bytes =
+        settings.verify ? checksum_table_bytes(audio.stored_frames, header.block_frames, header.flags) : 0;
+    if (table_bytes) {
+        std::cout << "  🔒 " << table_bytes / sizeof(uint64_t) - 1 << " block checksums ("
+                  << (xor_coded ? "checked as the blocks decode" : "checked in the background while it plays") << ")\n";
+    }
+    
+    if (mapped) {
+        // A short file would SIGBUS in the callback - check before handing out the pointer
+        if (content_end < offset + payload_bytes + table_bytes) {
+            std::cerr << "❌ File is truncated (" << audio.mapping.length << " bytes, header says "
+                      << offset + payload_bytes + table_bytes << ")\n";
+            return false;
+        }
+        
+        audio.samples = audio.mapping.base + offset;
+        if (table_bytes && !accept_checksums(audio, audio.mapping.base, offset, audio.samples + payload_bytes, table_bytes)) {
+            return false;
+        }
+        if (xor_coded) {
+            decode_xor_blocks(audio, audio.samples, xor_starts, settings.threads);
+            audio.mapping.reset(); // Everything plays from the decoded samples now
+            std::cout << "  ✅ HMICAP decoded INSTANTLY (every core on it fr fr) 🚀\n";
+            return true;
+        }
+        audio.verify_while_playing = table_bytes > 0;
+        
+        // Fault in the first stretch now so the first callbacks never wait on the disk
+        size_t warmup = std::min(audio.mapping.length,
+                                 offset + (size_t)(settings.readahead_seconds * audio.sample_rate) * audio.channels *
+                                              sample_bytes(audio.sample_format));
+        madvise(audio.mapping.base, warmup, MADV_WILLNEED);
+        
+        std::cout << "  🗺️  Mapped " << payload_bytes / 1024.0 / 1024.0 << " MB of audio data (zero-copy, shared page cache)\n";
+        std::cout << "  ✅ HMICAP mapped INSTANTLY (no parsing, no copying fr fr) 🚀\n";
+        return true;
+    }
+    
+    // Read sample data (INSTANT - just raw binary reads, several in flight!!) - with --direct
+    // straight from the device into a page-aligned buffer, leaving the page cache alone
+    const bool direct = file.direct() && offset % IO_ALIGN == 0;
+    if (settings.direct && !direct) {
+        std::cout << "  ⚠️  " << (file.direct() ? "Payload isn't page-aligned (convert again without --no-page-align)"
+                                                : "No O_DIRECT on this filesystem")
+                  << " - reading through the page cache\n";
+    }
+    char* payload;
+    if (direct) {
+        audio.direct_data.reset(static_cast<char*>(std::aligned_alloc(IO_ALIGN, io_align_up(payload_bytes))));
+        payload = audio.direct_data.get();
+    } else {
+        audio.sample_data.resize(payload_bytes);
+        payload = audio.sample_data.data();
+    }
+    
+    std::cout << "  📊 Reading " << payload_bytes / 1024.0 / 1024.0 << " MB of audio data (" << file.engine()
+              << (direct ? " + O_DIRECT" : "") << ", " << IO_QUEUE_DEPTH << " x " << IO_CHUNK_BYTES / 1024
+              << " KiB in flight)...\n";
+    
+    if (!file.read_at(payload, payload_bytes, offset)) {
+        std::cerr << "❌ Failed to read audio data\n";
+        return false;
+    }
+    
+    audio.samples = payload;
+    if (table_bytes) {
+        std::vector<char> head(offset), table(table_bytes);
+        if (!file.read_at(head.data(), offset, 0) || !file.read_at(table.data(), table_bytes, offset + payload_bytes)) {
+            std::cerr << "❌ File is truncated (checksum table missing)\n";
+            return false;
+        }
+        if (!accept_checksums(audio, head.data(), offset, table.data(), table_bytes)) {
+            return false;
+        }
+        audio.verify_while_playing = !xor_coded;
+    }
+    if (xor_coded) {
+        std::vector<char> coded;
+        coded.swap(audio.sample_data);
+        decode_xor_blocks(audio, direct ? payload : coded.data(), xor_starts, settings.threads);
+        audio.direct_data.reset();
+    }
+    
+    std::cout << "  ✅ HMICAP loaded INSTANTLY (no parsing needed fr fr) 🚀\n";
+    
+    return true;
+}
+
+uint32_t get_le32(const char* data) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+// 🧭 FIND THE SEEK TABLE (skippable frame + footer at the very end of the file)
+bool read_seek_table(const MappedFile& file, std::vector<SeekFrame>& frames) {
+    if (file.length < 17) return false;
+    
+    const char* footer = file.base + file.length - 9;
+    if (get_le32(footer + 5) != ZSTD_SEEKABLE_FOOTER_MAGIC) return false;
+    
+    uint32_t count = get_le32(footer);
+    size_t entry_size = (footer[4] & 0x80) ? 12 : 8; // Optional per-frame checksum
+    size_t table_size = (size_t)count * entry_size + 9;
+    if (table_size + 8 > file.length) return false;
+    
+    const char* table = file.base + file.length - 8 - table_size;
+    if (get_le32(table) != ZSTD_SEEKABLE_SKIPPABLE_MAGIC || get_le32(table + 4) != table_size) return false;
+    
+    uint64_t offset = 0;
+    frames.clear();
+    for (uint32_t i = 0; i < count; i++) {
+        const char* entry = table + 8 + i * entry_size;
+        frames.push_back({offset, get_le32(entry), get_le32(entry + 4)});
+        offset += frames.back().compressed_size;
+    }
+    
+    // The frames must tile the file exactly up to the seek table
+    return offset == file.length - 8 - table_size;
+}
+
+// 🧭 DECOMPRESS ONE SAMPLE BLOCK straight into `out` (room for decompressed_size bytes)
+// 🔒 A block that decompresses fine but fails its checksum plays as silence
+void check_block(const SeekableStream& stream, int64_t block, const char* stored, size_t size, char* out) {
+    if (stream.checksums.empty() || XXH3_64bits(stored, size) == stream.checksums[block + 1]) return;
+    std::cerr << "\n⚠️  Block " << block << " failed its checksum - playing silence\n";
+    std::memset(out, 0, size);
+}
+
+bool decode_block(const SeekableStream& stream, const MappedFile& file, ZSTD_DCtx* dctx, int64_t block, char* out) {
+    const SeekFrame& frame = stream.frames[block + 1];
+    if (!stream.shuffle) {
+        size_t got = ZSTD_decompressDCtx(dctx, out, frame.decompressed_size,
+                                         file.base + frame.compressed_offset, frame.compressed_size);
+        if (ZSTD_isError(got) || got != frame.decompressed_size) return false;
+        check_block(stream, block, out, got, out);
+        return true;
+    }
+    
+    // Shuffled: decompress into this thread's staging buffer, then unshuffle into place
+    thread_local std::vector<char> staging;
+    thread_local std::vector<uint8_t> scratch;
+    staging.resize(frame.decompressed_size);
+    size_t got = ZSTD_decompressDCtx(dctx, staging.data(), frame.decompressed_size,
+                                     file.base + frame.compressed_offset, frame.compressed_size);
+    if (ZSTD_isError(got) || got != frame.decompressed_size) return false;
+    const size_t width = sample_bytes(stream.sample_format);
+    unshuffle_samples(stream.shuffle, staging.data(), got / width, width, out, scratch);
+    check_block(stream, block, staging.data(), got, out);
+    return true;
+}
 
-// 🔥 HMICAP HEADER STRUCTURE
-struct HMICAPHeader {
-    char magic[8];          // "HMICAP01"
-    uint32_t sample_rate;   // Hz
-    uint16_t channels;      // 1=mono, 2=stereo
-    uint16_t reserved1;
-    uint64_t total_samples; // Samples per channel
-    uint8_t reserved2[12];
-};
+bool decode_block(const SeekableStream& stream, const MappedFile& file, ZSTD_DCtx* dctx, int64_t block,
+                  std::vector<char>& out) {
+    out.resize(stream.frames[block + 1].decompressed_size);
+    return decode_block(stream, file, dctx, block, out.data());
+}
 
-// 🎧 AUDIO DATA - PRE-RENDERED AND READY TO BLAST!!
-struct AudioData {
-    int sample_rate;
-    int channels;
-    int64_t total_samples;
-    std::vector<float> interleaved_data; // ALREADY interleaved = zero overhead!!
-};
+// 🧵 PARALLEL FULL DECODE - blocks are independent, so each worker (own ZSTD_DCtx) grabs the next
+// block and decompresses it directly into its final place in `dest`
+bool decode_all_blocks(const AudioData& audio, char* dest, unsigned threads) {
+    const SeekableStream& stream = *audio.stream;
+    std::atomic<int64_t> next_block{0};
+    std::atomic<bool> failed{false};
+    
+    auto worker = [&]() {
+        ZSTD_DCtx* dctx = ZSTD_createDCtx();
+        int64_t block;
+        while (!failed && (block = next_block++) < stream.block_count()) {
+            // Planar: full blocks never pad
+            char* out = dest + block * stream.block_frames * audio.channels * sample_bytes(stream.sample_format);
+            if (!decode_block(stream, audio.mapping, dctx, block, out)) {
+                std::cerr << "❌ Block " << block << " is corrupt\n";
+                failed = true;
+            }
+        }
+        ZSTD_freeDCtx(dctx);
+    };
+    
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; i++) {
+        pool.emplace_back(worker);
+    }
+    worker(); // The calling thread pulls its weight too
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    
+    return !failed;
+}
 
-// 📂 LOAD HMICAP FILE (INSTANT LOADING - NO PARSING!!)
-bool load_hmicap(const std::string& path, AudioData& audio) {
-    std::cout << "📂 Loading HMICAP file...\n";
+// 📥 PRELOAD A SEEKABLE HMICAP7 - whole file decoded up front, then played like a plain HMICAP
+bool preload_seekable(AudioData& audio, unsigned threads) {
+    auto start = std::chrono::steady_clock::now();
+    const SeekableStream& stream = *audio.stream;
+    audio.sample_data.resize(payload_samples(audio.total_samples, audio.channels, stream.block_frames,
+                                             stream.planar ? HMICAP_FLAG_PLANAR : 0) *
+                             sample_bytes(stream.sample_format));
     
-    std::ifstream file(path, std::ios::binary);
-    if (!file) {
-        std::cerr << "❌ Failed to open file\n";
+    if (!decode_all_blocks(audio, audio.sample_data.data(), threads)) {
         return false;
     }
     
-    // Read header
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "  🧵 Preloaded " << audio.sample_data.size() / 1024.0 / 1024.0 << " MB on "
+              << threads << " threads in " << ms << " ms\n";
+    
+    audio.samples = audio.sample_data.data();
+    audio.sample_format = stream.sample_format;
+    audio.planar = stream.planar;
+    audio.block_frames = stream.block_frames;
+    audio.stream.reset();
+    audio.mapping.reset();
+    return true;
+}
+
+// 📊 LOAD BENCHMARK: full decode at 1..N threads (best of 3), plus time to the first block
+void bench_load(const AudioData& audio, unsigned max_threads) {
+    const SeekableStream& stream = *audio.stream;
+    std::vector<char> dest(payload_samples(audio.total_samples, audio.channels, stream.block_frames,
+                                          stream.planar ? HMICAP_FLAG_PLANAR : 0) *
+                           sample_bytes(stream.sample_format));
+    const double megabytes = dest.size() / 1024.0 / 1024.0;
+    
+    ZSTD_DCtx* dctx = ZSTD_createDCtx();
+    std::vector<char> block;
+    auto first_start = std::chrono::steady_clock::now();
+    decode_block(stream, audio.mapping, dctx, 0, block);
+    double first_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - first_start).count();
+    ZSTD_freeDCtx(dctx);
+    
+    std::cout << "\n📊 ═══ HMICAP7 LOAD BENCHMARK ═══ 📊\n";
+    std::cout << "🎵 " << megabytes << " MB decoded, " << stream.block_count() << " blocks, "
+              << std::thread::hardware_concurrency() << " hardware threads\n";
+    std::cout << "⚡ On-demand first block: " << first_ms << " ms\n\n";
+    std::cout << std::setw(8) << "threads" << std::setw(12) << "ms" << std::setw(12) << "MB/s" << std::setw(10) << "speedup" << "\n";
+    
+    std::vector<unsigned> counts;
+    for (unsigned threads = 1; threads < max_threads; threads *= 2) counts.push_back(threads);
+    counts.push_back(max_threads);
+    
+    double single_ms = 0.0;
+    for (unsigned threads : counts) {
+        double best_ms = 1e30;
+        for (int run = 0; run < 3; run++) {
+            auto start = std::chrono::steady_clock::now();
+            if (!decode_all_blocks(audio, dest.data(), threads)) return;
+            best_ms = std::min(best_ms, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        if (threads == 1) single_ms = best_ms;
+        
+        std::cout << std::setw(8) << threads << std::setw(12) << std::fixed << std::setprecision(2) << best_ms
+                  << std::setw(12) << std::setprecision(1) << megabytes / (best_ms / 1000.0)
+                  << std::setw(9) << std::setprecision(2) << single_ms / best_ms << "x\n";
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+}
+
+// 🧭 OPEN SEEKABLE HMICAP7 - decodes the header frame only, nothing else up front
+bool load_hmicap7_seekable(AudioData& audio, const std::vector<SeekFrame>& frames, const PlayerSettings& settings) {
+    // Frame 0 is the header, zero padded up to the payload offset for planar files
     HMICAPHeader header;
-    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    char head[PLANAR_PAYLOAD_OFFSET];
+    size_t got = frames.empty() || frames[0].decompressed_size > sizeof(head)
+        ? 0
+        : ZSTD_decompress(head, sizeof(head), audio.mapping.base, frames[0].compressed_size);
+    if (!ZSTD_isError(got) && got >= sizeof(header)) std::memcpy(&header, head, sizeof(header));
     
-    // Verify magic number
-    if (std::memcmp(header.magic, "HMICAP01", 8) != 0) {
-        std::cerr << "❌ Invalid HMICAP file (bad magic number)\n";
+    if (ZSTD_isError(got) || got < sizeof(header) || std::memcmp(header.magic, "HMICAP01", 8) != 0 ||
+        got != payload_offset(header.flags) || !known_sample_format(header.sample_format) ||
+        !(header.flags & HMICAP_FLAG_SEEKABLE) || (header.flags & HMICAP_FLAG_RUNS) || header.block_frames == 0 ||
+        header.channels == 0 || ((header.flags & HMICAP_FLAG_PLANAR) && header.block_frames % PLANAR_ALIGN_FRAMES)) {
+        std::cerr << "❌ Seek table found, but the first frame is not a seekable HMICAP header\n";
         return false;
     }
     
     audio.sample_rate = header.sample_rate;
     audio.channels = header.channels;
     audio.total_samples = header.total_samples;
+    audio.stored_frames = header.total_samples;
     
-    std::cout << "  ✅ Valid HMICAP header detected! 💚\n";
+    // Every block must decompress to exactly its share of the samples
+    const size_t frame_bytes = audio.channels * sample_bytes(header.sample_format);
+    int64_t blocks = block_count(audio.total_samples, header.block_frames);
+    const bool has_checksums = header.flags & HMICAP_FLAG_CHECKSUMS;
+    const bool has_overview = header.flags & HMICAP_FLAG_OVERVIEW;
+    if ((int64_t)frames.size() != blocks + 1 + has_checksums + has_overview) {
+        std::cerr << "❌ Seek table has " << frames.size() - 1 - has_checksums - has_overview << " blocks, header needs "
+                  << blocks << "\n";
+        return false;
+    }
+    const bool planar = header.flags & HMICAP_FLAG_PLANAR;
+    for (int64_t b = 0; b < blocks; b++) {
+        int64_t frames_in_block = std::min<int64_t>(header.block_frames, audio.total_samples - b * header.block_frames);
+        if (planar) frames_in_block = planar_stride(frames_in_block);
+        if (frames[b + 1].decompressed_size != frames_in_block * frame_bytes) {
+            std::cerr << "❌ Seek table entry " << b << " has the wrong size\n";
+            return false;
+        }
+    }
+    
+    // 📈 --overview: the last frame, nothing else
+    if (settings.overview) {
+        std::cout << "  ✅ Valid HMICAP header! 💚\n";
+        std::cout << "  ⏱️  Duration: " << (float)audio.total_samples / audio.sample_rate << " seconds\n";
+        if (!require_overview(header.flags)) return false;
+        const SeekFrame& overview_frame = frames.back();
+        audio.overview.storage.resize(overview_frame.decompressed_size);
+        size_t size = ZSTD_decompress(audio.overview.storage.data(), audio.overview.storage.size(),
+                                      audio.mapping.base + overview_frame.compressed_offset, overview_frame.compressed_size);
+        if (ZSTD_isError(size) || size != audio.overview.storage.size()) {
+            std::cerr << "❌ Overview frame is corrupt\n";
+            return false;
+        }
+        return accept_overview(audio, audio.overview.storage.data(), size, settings.verify);
+    }
+    
+    // 🔒 The checksum table is the frame after the last block
+    std::vector<uint64_t> checksums;
+    if (has_checksums && settings.verify) {
+        const SeekFrame& table_frame = frames[blocks + 1];
+        std::vector<char> table(checksum_table_bytes(audio.total_samples, header.block_frames, header.flags));
+        size_t table_size = table_frame.decompressed_size != table.size()
+            ? 0
+            : ZSTD_decompress(table.data(), table.size(), audio.mapping.base + table_frame.compressed_offset,
+                              table_frame.compressed_size);
+        if (ZSTD_isError(table_size) || table_size != table.size()) {
+            std::cerr << "❌ Checksum table frame is corrupt\n";
+            return false;
+        }
+        checksums = parse_checksum_table(table.data(), table.size());
+        if (XXH3_64bits(head, got) != checksums[0]) {
+            std::cerr << "❌ Header checksum mismatch - the file is corrupt (--no-verify plays it anyway)\n";
+            return false;
+        }
+    }
+    
+    audio.stream = std::make_unique<SeekableStream>();
+    audio.stream->frames = frames;
+    audio.stream->blocks = blocks;
+    audio.stream->checksums = std::move(checksums);
+    audio.stream->block_frames = header.block_frames;
+    audio.stream->shuffle = header.flags & HMICAP_SHUFFLE_FLAGS;
+    audio.stream->planar = planar;
+    audio.stream->sample_format = header.sample_format;
+    for (auto& slot : audio.stream->slots) {
+        slot.bytes.reserve(planar_stride(header.block_frames) * frame_bytes);
+    }
+    
+    std::cout << "  ✅ Valid HMICAP header! 💚\n";
     std::cout << "  🎵 Sample rate: " << audio.sample_rate << " Hz\n";
     std::cout << "  🎧 Channels: " << audio.channels << "\n";
     std::cout << "  📊 Total samples: " << audio.total_samples << " per channel\n";
     std::cout << "  ⏱️  Duration: " << (float)audio.total_samples / audio.sample_rate << " seconds\n";
+    std::cout << "  🧭 Seekable: " << blocks << " blocks of " << (double)header.block_frames / audio.sample_rate
+              << " s - decoded on demand, nothing decompressed up front 🚀\n";
+    accept_sample_format(header.sample_format);
+    if (audio.stream->shuffle) {
+        std::cout << "  🔀 " << ((audio.stream->shuffle & HMICAP_FLAG_BIT_SHUFFLE) ? "Bit" : "Byte")
+                  << "-shuffled blocks (unshuffled as they decode)\n";
+    }
+    if (planar) {
+        std::cout << "  🎚️  Planar blocks (interleaved on the way out)\n";
+    }
+    if (!audio.stream->checksums.empty()) {
+        std::cout << "  🔒 Block checksums (each block checked as it decodes)\n";
+    }
+    return true;
+}
+
+// ⚡ LZ4 FRAMES ══════════════════════════════════════════════════════════════
+// The converter's fast-decode "lz4" profile writes single-frame HMICAP7 as LZ4 frames (header +
+// payload frame, then the overview frame and its locator) and sets HMICAP_FLAG_LZ4. The loaders
+// go by the frame magic, so a file opens the same whichever codec it uses; the flag is only
+// cross-checked. Builds without HMICAP_HAVE_LZ4 say how to get a player that reads them.
+const uint32_t LZ4_FRAME_MAGIC = 0x184D2204;
+
+bool is_lz4_frame(const char* data, size_t size) {
+    return size >= 4 && get_le32(data) == LZ4_FRAME_MAGIC;
+}
+
+#if HMICAP_HAVE_LZ4
+// ⚡ Decompress an LZ4 frame arriving in pieces: next(chunk, length) hands over the following
+// piece (false = no more). Fills `out` up to its size; with `whole`, the frame must end there.
+template <typename Next>
+bool lz4_decompress_stream(const char* chunk, size_t length, Next&& next, std::vector<char>& out, bool whole) {
+    LZ4F_dctx* dctx = nullptr;
+    LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION);
+    size_t produced = 0, remaining = 1;
+    bool ok = true;
+    do {
+        size_t consumed = 0;
+        while (ok && remaining != 0 && consumed < length && (whole || produced < out.size())) {
+            size_t dst = out.size() - produced, src = length - consumed;
+            remaining = LZ4F_decompress(dctx, out.data() + produced, &dst, chunk + consumed, &src, nullptr);
+            if (LZ4F_isError(remaining)) {
+                std::cerr << "❌ Decompression error: " << LZ4F_getErrorName(remaining) << "\n";
+                ok = false;
+            } else if (dst == 0 && src == 0) {
+                std::cerr << "❌ Decompression error: more data than the frame header says\n";
+                ok = false;
+            }
+            produced += ok ? dst : 0;
+            consumed += ok ? src : 0;
+        }
+    } while (ok && remaining != 0 && (whole || produced < out.size()) && next(chunk, length));
+    LZ4F_freeDecompressionContext(dctx);
     
-    // Read interleaved sample data (INSTANT - just raw binary read!!)
-    size_t total_floats = audio.total_samples * audio.channels;
-    audio.interleaved_data.resize(total_floats);
+    if (ok && whole && remaining != 0) {
+        std::cerr << "❌ Compressed file is truncated\n";
+        ok = false;
+    }
+    out.resize(produced);
+    return ok;
+}
+
+// Content size from the frame header (0 = missing or not an LZ4 frame)
+uint64_t lz4_content_size(const char* data, size_t size) {
+    LZ4F_dctx* dctx = nullptr;
+    LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION);
+    LZ4F_frameInfo_t info;
+    size_t consumed = size;
+    size_t result = LZ4F_getFrameInfo(dctx, &info, data, &consumed);
+    LZ4F_freeDecompressionContext(dctx);
+    return LZ4F_isError(result) ? 0 : info.contentSize;
+}
+#else
+template <typename Next>
+bool lz4_decompress_stream(const char*, size_t, Next&&, std::vector<char>&, bool) {
+    std::cerr << "❌ This HMICAP7 is LZ4-compressed - rebuild the player with -DHMICAP_WITH_LZ4 -llz4\n";
+    return false;
+}
+
+uint64_t lz4_content_size(const char*, size_t) { return 1; } // Let the stream report the missing codec
+#endif
+
+// ⚡ A whole LZ4 frame in memory → out (`limit` caps what the header may claim)
+bool lz4_decompress_frame(const char* data, size_t size, std::vector<char>& out, uint64_t limit) {
+    uint64_t content_size = lz4_content_size(data, size);
+    if (content_size == 0 || content_size > limit) return false;
+    out.resize(content_size);
+    return lz4_decompress_stream(data, size, [](const char*&, size_t&) { return false; }, out, true);
+}
+
+// 🌀 DECOMPRESS A SINGLE-FRAME HMICAP7 while it's being read: zstd (or LZ4) works on each chunk as
+// it lands and the next IO_QUEUE_DEPTH chunks are already on their way. `lz4` says which it was.
+bool decompress_file(AsyncReader& file, std::vector<char>& out, bool* lz4 = nullptr) {
+    file.start();
+    const char* chunk = nullptr;
+    size_t length = 0;
+    if (!file.next(chunk, length)) {
+        std::cerr << "❌ Failed to read compressed file\n";
+        return false;
+    }
     
-    std::cout << "  📊 Reading " << total_floats * sizeof(float) / 1024.0 / 1024.0 << " MB of audio data...\n";
+    if (lz4) *lz4 = is_lz4_frame(chunk, length);
+    if (is_lz4_frame(chunk, length)) {
+        uint64_t content_size = lz4_content_size(chunk, length);
+        if (content_size == 0) {
+            std::cerr << "❌ LZ4 frame without a content size\n";
+            return false;
+        }
+        out.resize(content_size);
+        return lz4_decompress_stream(chunk, length, [&](const char*& c, size_t& l) { return file.next(c, l); }, out, true);
+    }
     
-    file.read(reinterpret_cast<char*>(audio.interleaved_data.data()),
-              total_floats * sizeof(float));
+    // Get decompressed size (the frame header is in the first chunk)
+    unsigned long long decompressed_size = ZSTD_getFrameContentSize(chunk, length);
     
-    if (!file) {
-        std::cerr << "❌ Failed to read audio data\n";
+    if (decompressed_size == ZSTD_CONTENTSIZE_ERROR) {
+        std::cerr << "❌ Not a valid Zstd file\n";
         return false;
     }
     
-    file.close();
+    if (decompressed_size == ZSTD_CONTENTSIZE_UNKNOWN) {
+        std::cerr << "❌ Decompressed size unknown\n";
+        return false;
+    }
     
-    std::cout << "  ✅ HMICAP loaded INSTANTLY (no parsing needed fr fr) 🚀\n";
+    out.resize(decompressed_size);
+    ZSTD_DCtx* dctx = ZSTD_createDCtx();
+    ZSTD_outBuffer output = {out.data(), out.size(), 0};
+    size_t remaining = 1;
+    bool ok = true;
+    do {
+        ZSTD_inBuffer input = {chunk, length, 0};
+        while (ok && remaining != 0 && input.pos < input.size) {
+            size_t consumed = input.pos, produced = output.pos;
+            remaining = ZSTD_decompressStream(dctx, &output, &input);
+            if (ZSTD_isError(remaining)) {
+                std::cerr << "❌ Decompression error: " << ZSTD_getErrorName(remaining) << "\n";
+                ok = false;
+            } else if (input.pos == consumed && output.pos == produced) {
+                std::cerr << "❌ Decompression error: more data than the frame header says\n";
+                ok = false;
+            }
+        }
+    } while (ok && remaining != 0 && file.next(chunk, length));
+    ZSTD_freeDCtx(dctx);
     
-    return true;
+    if (ok && remaining != 0) {
+        std::cerr << (file.ok() ? "❌ Compressed file is truncated\n" : "❌ Failed to read compressed file\n");
+        ok = false;
+    }
+    out.resize(output.pos);
+    return ok;
 }
 
-// 🌀 LOAD HMICAP7 FILE (COMPRESSED)
-bool load_hmicap7(const std::string& path, AudioData& audio) {
-    std::cout << "📂 Loading HMICAP7 file (compressed)...\n";
+// Drop a file from the page cache so the next read really hits the disk
+void drop_cached(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+// 📊 I/O BENCHMARK: load the file the old way (one giant iostream read, then ZSTD_decompress - or
+// the LZ4 frame - for HMICAP7) vs the async reader (chunked reads in flight, HMICAP7 decompressed while the rest is
+// still being read), buffered and O_DIRECT. Cold = file evicted from the page cache first (O_DIRECT
+// never reads from it, so its cold and warm should match). Best of 3. A packed track is timed on
+// its own bytes (the whole pack gets evicted).
+bool bench_io(const std::string& path, bool compressed, const PackEntry* packed = nullptr) {
+    using Clock = std::chrono::steady_clock;
+    auto elapsed = [](Clock::time_point start) { return std::chrono::duration<double>(Clock::now() - start).count(); };
     
-    std::ifstream file(path, std::ios::binary | std::ios::ate);
-    if (!file) {
+    AsyncReader probe;
+    if (!probe.open(path, false, packed)) {
         std::cerr << "❌ Failed to open file\n";
         return false;
     }
+    const size_t file_size = probe.size();
+    const double megabytes = file_size / 1024.0 / 1024.0;
+    std::vector<char> raw(file_size), iostream_out, async_out;
+    std::unique_ptr<char, decltype(&std::free)> aligned( // Where O_DIRECT reads of a plain HMICAP land
+        static_cast<char*>(std::aligned_alloc(IO_ALIGN, io_align_up(file_size))), &std::free);
     
-    std::streamsize compressed_size = file.tellg();
-    file.seekg(0, std::ios::beg);
+    auto load_iostream = [&]() {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.seekg(packed ? packed->offset : 0) || !file.read(raw.data(), file_size)) return false;
+        if (!compressed) return true;
+        if (is_lz4_frame(raw.data(), file_size)) return lz4_decompress_frame(raw.data(), file_size, iostream_out, UINT64_MAX);
+        unsigned long long size = ZSTD_getFrameContentSize(raw.data(), file_size);
+        size_t frame = ZSTD_findFrameCompressedSize(raw.data(), file_size); // The overview frame may follow
+        if (size == ZSTD_CONTENTSIZE_ERROR || size == ZSTD_CONTENTSIZE_UNKNOWN || ZSTD_isError(frame)) return false;
+        iostream_out.resize(size);
+        return ZSTD_decompress(iostream_out.data(), size, raw.data(), frame) == size;
+    };
+    auto load_async = [&](bool direct) {
+        AsyncReader file;
+        if (!file.open(path, direct, packed)) return false;
+        return compressed ? decompress_file(file, async_out) : file.read_at(direct ? aligned.get() : raw.data(), file_size, 0);
+    };
     
-    std::vector<char> compressed_data(compressed_size);
-    if (!file.read(compressed_data.data(), compressed_size)) {
-        std::cerr << "❌ Failed to read compressed file\n";
-        return false;
-    }
-    file.close();
+    std::cout << "\n📊 ═══ I/O BENCHMARK (" << std::fixed << std::setprecision(1) << megabytes << " MB "
+              << (compressed ? "HMICAP7, read + decompress" : "HMICAP") << ", " << IO_CHUNK_BYTES / 1024
+              << " KiB requests x " << IO_QUEUE_DEPTH << " in flight) ═══ 📊\n";
+    std::cout << std::setw(14) << "path" << std::setw(11) << "cold ms" << std::setw(11) << "MB/s"
+              << std::setw(11) << "warm ms" << std::setw(11) << "MB/s" << "\n";
     
-    std::cout << "  📦 Compressed size: " << compressed_size / 1024.0 / 1024.0 << " MB\n";
+    for (int engine = 0; engine < 3; engine++) {
+        const bool direct = engine == 2;
+        double cold_seconds = 1e30, warm_seconds = 1e30;
+        for (int run = 0; run < 3; run++) {
+            drop_cached(path);
+            auto start = Clock::now();
+            if (!(engine ? load_async(direct) : load_iostream())) {
+                std::cerr << "❌ Load failed\n";
+                return false;
+            }
+            cold_seconds = std::min(cold_seconds, elapsed(start));
+            
+            start = Clock::now();
+            engine ? load_async(direct) : load_iostream();
+            warm_seconds = std::min(warm_seconds, elapsed(start));
+        }
+        const char* name = engine ? probe.engine() : "iostream";
+        if (direct) name = probe.open(path, true, packed) && probe.direct() ? "O_DIRECT" : "no O_DIRECT";
+        std::cout << std::setw(14) << name << std::setprecision(2)
+                  << std::setw(11) << cold_seconds * 1000.0 << std::setprecision(1) << std::setw(11) << megabytes / cold_seconds
+                  << std::setprecision(2) << std::setw(11) << warm_seconds * 1000.0 << std::setprecision(1)
+                  << std::setw(11) << megabytes / warm_seconds << "\n";
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
     
-    // Get decompressed size
-    unsigned long long decompressed_size = ZSTD_getFrameContentSize(compressed_data.data(),
-                                                                     compressed_size);
+    if (compressed && iostream_out != async_out) {
+        std::cerr << "❌ Streamed decompression doesn't match the one-shot path\n";
+        return false;
+    }
+    if (!compressed && std::memcmp(aligned.get(), raw.data(), file_size) != 0) {
+        std::cerr << "❌ O_DIRECT read doesn't match the buffered one\n";
+        return false;
+    }
+    return true;
+}
+
+// 📈 SINGLE-FRAME HMICAP7 --overview: the header comes out of the first zstd block, the section out
+// of the frame the OVERVIEW_LOCATOR at the end points to - the samples in between are never read
+bool load_hmicap7_overview(AsyncReader& file, AudioData& audio, bool verify) {
+    char locator[16];
+    if (file.size() < 2 * sizeof(locator) || !file.read_at(locator, sizeof(locator), file.size() - sizeof(locator)) ||
+        get_le32(locator) != OVERVIEW_LOCATOR_MAGIC || get_le32(locator + 4) != 8 ||
+        std::memcmp(locator + 12, "HOVW", 4) != 0 || get_le32(locator + 8) > file.size() - sizeof(locator)) {
+        std::cerr << "❌ This file has no overview (convert it again without --no-overview)\n";
+        return false;
+    }
     
-    if (decompressed_size == ZSTD_CONTENTSIZE_ERROR) {
-        std::cerr << "❌ Not a valid Zstd file\n";
+    // Header: stream-decompress just its 40 bytes
+    HMICAPHeader header;
+    std::vector<char> chunk(ZSTD_DStreamInSize());
+    char magic[4];
+    const bool lz4 = file.read_at(magic, sizeof(magic), 0) && is_lz4_frame(magic, sizeof(magic));
+    size_t header_bytes = 0;
+    if (lz4) {
+        uint64_t offset = 0;
+        auto next = [&](const char*& data, size_t& length) {
+            if (offset >= file.size()) return false;
+            length = std::min<uint64_t>(chunk.size(), file.size() - offset);
+            data = chunk.data();
+            offset += length;
+            return file.read_at(chunk.data(), length, offset - length);
+        };
+        std::vector<char> head(sizeof(header));
+        const char* data = nullptr;
+        size_t length = 0;
+        if (next(data, length) && lz4_decompress_stream(data, length, next, head, false)) {
+            header_bytes = head.size();
+            std::memcpy(&header, head.data(), header_bytes);
+        }
+    } else {
+        ZSTD_DCtx* dctx = ZSTD_createDCtx();
+        ZSTD_outBuffer output = {&header, sizeof(header), 0};
+        bool ok = true;
+        for (uint64_t offset = 0; ok && output.pos < output.size && offset < file.size(); offset += chunk.size()) {
+            size_t length = std::min<uint64_t>(chunk.size(), file.size() - offset);
+            ok = file.read_at(chunk.data(), length, offset);
+            ZSTD_inBuffer input = {chunk.data(), length, 0};
+            while (ok && output.pos < output.size && input.pos < input.size) {
+                ok = !ZSTD_isError(ZSTD_decompressStream(dctx, &output, &input));
+            }
+        }
+        ZSTD_freeDCtx(dctx);
+        header_bytes = output.pos;
+    }
+    if (header_bytes < sizeof(header) || std::memcmp(header.magic, "HMICAP01", 8) != 0) {
+        std::cerr << "❌ Invalid HMICAP data in compressed file\n";
         return false;
     }
+    audio.sample_rate = header.sample_rate;
+    audio.channels = header.channels;
+    audio.total_samples = header.total_samples;
+    audio.stored_frames = header.total_samples;
+    std::cout << "  ✅ Valid HMICAP header! 💚\n";
+    std::cout << "  ⏱️  Duration: " << (float)audio.total_samples / audio.sample_rate << " seconds\n";
+    if (!require_overview(header.flags)) return false;
     
-    if (decompressed_size == ZSTD_CONTENTSIZE_UNKNOWN) {
-        std::cerr << "❌ Decompressed size unknown\n";
+    const uint32_t frame_size = get_le32(locator + 8);
+    std::vector<char> frame(frame_size);
+    if (!file.read_at(frame.data(), frame_size, file.size() - sizeof(locator) - frame_size)) {
+        std::cerr << "❌ Failed to read the overview\n";
+        return false;
+    }
+    // Even one-frame buckets couldn't take more than 6 bytes per sample
+    const uint64_t limit = 4096 + (uint64_t)audio.total_samples * audio.channels * 6;
+    if (lz4) {
+        if (!lz4_decompress_frame(frame.data(), frame.size(), audio.overview.storage, limit)) {
+            std::cerr << "❌ Overview frame is corrupt\n";
+            return false;
+        }
+        return accept_overview(audio, audio.overview.storage.data(), audio.overview.storage.size(), verify);
+    }
+    unsigned long long size = ZSTD_getFrameContentSize(frame.data(), frame.size());
+    if (size == ZSTD_CONTENTSIZE_ERROR || size == ZSTD_CONTENTSIZE_UNKNOWN || size > limit) {
+        std::cerr << "❌ Overview frame is corrupt\n";
+        return false;
+    }
+    audio.overview.storage.resize(size);
+    size_t got = ZSTD_decompress(audio.overview.storage.data(), size, frame.data(), frame.size());
+    if (ZSTD_isError(got) || got != size) {
+        std::cerr << "❌ Overview frame is corrupt\n";
         return false;
     }
+    return accept_overview(audio, audio.overview.storage.data(), size, verify);
+}
+
+// 🌀 LOAD HMICAP7 FILE (COMPRESSED)
+bool load_hmicap7(const std::string& path, AudioData& audio, const PlayerSettings& settings,
+                  const PackEntry* packed = nullptr) {
+    std::cout << "📂 Loading HMICAP7 file (compressed)...\n";
+    
+    // 🧭 Seekable files stay compressed in a mapping and stream block by block
+    std::vector<SeekFrame> frames;
+    if (map_file(path, audio.mapping, packed)) {
+        if (read_seek_table(audio.mapping, frames)) {
+            return load_hmicap7_seekable(audio, frames, settings);
+        }
+        audio.mapping.reset();
+    }
     
-    std::cout << "  🌀 Decompressing " << decompressed_size / 1024.0 / 1024.0 << " MB...\n";
+    AsyncReader file;
+    if (!file.open(path, settings.direct, packed)) {
+        std::cerr << "❌ Failed to open file\n";
+        return false;
+    }
+    if (settings.direct && !file.direct()) {
+        std::cout << "  ⚠️  No O_DIRECT on this filesystem - reading through the page cache\n";
+    }
     
-    std::vector<char> decompressed_data(decompressed_size);
-    size_t actual_size = ZSTD_decompress(decompressed_data.data(), decompressed_size,
-                                         compressed_data.data(), compressed_size);
+    std::cout << "  📦 Compressed size: " << file.size() / 1024.0 / 1024.0 << " MB\n";
+    if (settings.overview) {
+        return load_hmicap7_overview(file, audio, settings.verify);
+    }
+    std::cout << "  🌀 Decompressing as it streams in (" << file.engine() << (file.direct() ? " + O_DIRECT" : "") << ", "
+              << IO_QUEUE_DEPTH << " x " << IO_CHUNK_BYTES / 1024 << " KiB reads in flight)...\n";
     
-    if (ZSTD_isError(actual_size)) {
-        std::cerr << "❌ Decompression error: " << ZSTD_getErrorName(actual_size) << "\n";
+    std::vector<char> decompressed_data;
+    bool lz4 = false;
+    if (!decompress_file(file, decompressed_data, &lz4)) {
         return false;
     }
+    const size_t actual_size = decompressed_data.size();
     
-    std::cout << "  ✅ Decompressed successfully! 💚\n";
+    std::cout << "  ✅ Decompressed successfully" << (lz4 ? " (LZ4 frame)" : "") << "! 💚\n";
     
     // Parse header
     HMICAPHeader header;
+    if (actual_size < sizeof(header)) {
+        std::cerr << "❌ Decompressed data too small for a header\n";
+        return false;
+    }
     std::memcpy(&header, decompressed_data.data(), sizeof(header));
     
     if (std::memcmp(header.magic, "HMICAP01", 8) != 0) {
@@ -150,20 +2542,84 @@ bool load_hmicap7(const std::string& path, AudioData& audio) {
     audio.sample_rate = header.sample_rate;
     audio.channels = header.channels;
     audio.total_samples = header.total_samples;
+    audio.stored_frames = header.total_samples;
+    audio.sample_format = header.sample_format;
+    audio.planar = header.flags & HMICAP_FLAG_PLANAR;
+    audio.block_frames = header.block_frames;
     
     std::cout << "  ✅ Valid HMICAP header! 💚\n";
     std::cout << "  🎵 Sample rate: " << audio.sample_rate << " Hz\n";
     std::cout << "  🎧 Channels: " << audio.channels << "\n";
     std::cout << "  📊 Total samples: " << audio.total_samples << " per channel\n";
     std::cout << "  ⏱️  Duration: " << (float)audio.total_samples / audio.sample_rate << " seconds\n";
+    if (!accept_sample_format(audio.sample_format)) {
+        return false;
+    }
+    
+    uint32_t shuffle = header.flags & HMICAP_SHUFFLE_FLAGS;
+    if ((shuffle || audio.planar) && header.block_frames == 0) {
+        std::cerr << "❌ Shuffled/planar HMICAP7 without a block size\n";
+        return false;
+    }
+    if (audio.planar && header.block_frames % PLANAR_ALIGN_FRAMES) {
+        std::cerr << "❌ Planar HMICAP7 with a bad block size (" << header.block_frames << ")\n";
+        return false;
+    }
+    if ((header.flags & HMICAP_FLAG_CHECKSUMS) && header.block_frames == 0) {
+        std::cerr << "❌ Checksummed HMICAP7 without a block size\n";
+        return false;
+    }
+    if (header.flags & HMICAP_FLAG_RUNS) {
+        std::cerr << "❌ Constant runs in an HMICAP7 (only plain HMICAP cuts them out)\n";
+        return false;
+    }
+    if (bool(header.flags & HMICAP_FLAG_LZ4) != lz4) {
+        std::cerr << "❌ Header says " << (lz4 ? "zstd" : "LZ4") << " but the file is " << (lz4 ? "LZ4" : "zstd") << "\n";
+        return false;
+    }
     
-    // Copy sample data
-    size_t total_floats = audio.total_samples * audio.channels;
-    audio.interleaved_data.resize(total_floats);
+    const size_t width = sample_bytes(audio.sample_format);
+    size_t total_samples = payload_samples(audio.total_samples, audio.channels, header.block_frames, header.flags);
+    const size_t offset = payload_offset(header.flags);
+    const size_t table_bytes =
+        settings.verify ? checksum_table_bytes(audio.total_samples, header.block_frames, header.flags) : 0;
+    if (actual_size < offset + total_samples * width + table_bytes) {
+        std::cerr << "❌ Truncated sample data\n";
+        return false;
+    }
+    const char* payload = decompressed_data.data() + offset;
+    
+    // 🔒 Check the blocks as stored (still shuffled), all threads - it's in memory already
+    if (table_bytes) {
+        if (!accept_checksums(audio, decompressed_data.data(), offset, payload + total_samples * width, table_bytes)) {
+            return false;
+        }
+        auto verify_start = std::chrono::steady_clock::now();
+        audio.samples = payload;
+        int64_t bad = verify_blocks(audio, 0, settings.threads);
+        print_verify_result(audio.checksums.size() - 1, bad, total_samples * width,
+                            std::chrono::duration<double>(std::chrono::steady_clock::now() - verify_start).count());
+    }
+    if (audio.planar) {
+        std::cout << "  🎚️  Planar blocks of " << audio.block_frames << " frames (interleaved on the way out)\n";
+    }
     
-    std::memcpy(audio.interleaved_data.data(),
-                decompressed_data.data() + sizeof(header),
-                total_floats * sizeof(float));
+    if (shuffle) {
+        // 🔀 Undo the byte/bit-plane shuffle block by block
+        std::cout << "  🔀 Unshuffling " << ((shuffle & HMICAP_FLAG_BIT_SHUFFLE) ? "bit" : "byte") << " planes...\n";
+        const size_t block_samples = (size_t)header.block_frames * audio.channels;
+        std::vector<uint8_t> scratch;
+        audio.sample_data.resize(total_samples * width);
+        for (size_t first = 0; first < total_samples; first += block_samples) {
+            unshuffle_samples(shuffle, payload + first * width, std::min(block_samples, total_samples - first), width,
+                              audio.sample_data.data() + first * width, scratch);
+        }
+        audio.samples = audio.sample_data.data();
+    } else {
+        // Play straight out of the decompression buffer (no copy)
+        audio.sample_data = std::move(decompressed_data);
+        audio.samples = audio.sample_data.data() + offset;
+    }
     
     std::cout << "  ✅ HMICAP7 loaded and ready to play! 🚀\n";
     
@@ -179,30 +2635,134 @@ static int audio_callback(const void* inputBuffer, void* outputBuffer,
     AudioData* audio = (AudioData*)userData;
     float* out = (float*)outputBuffer;
     
-    for (unsigned long i = 0; i < framesPerBuffer; i++) {
-        if (current_sample >= audio->total_samples || should_stop) {
-            // Fill with silence
-            for (int ch = 0; ch < audio->channels; ch++) {
-                *out++ = 0.0f;
+    int64_t target = seek_request.exchange(-1);
+    if (target >= 0) current_sample = target;
+    
+    // Direct copy from the sample buffer (MAXIMUM SPEED!!), runs straight from the run table,
+    // silence past the end or when stopping
+    int64_t position = current_sample;
+    int64_t count = should_stop ? 0 : std::max<int64_t>(0, std::min<int64_t>(framesPerBuffer, audio->total_samples - position));
+    if (count > 0) render_frames(*audio, position, count, out);
+    std::memset(out + count * audio->channels, 0, (framesPerBuffer - count) * audio->channels * sizeof(float));
+    
+    current_sample = position + count;
+    return position + count >= audio->total_samples ? paComplete : paContinue;
+}
+
+// 🧭 SEEKABLE CALLBACK - copies out of the decoded block slots; a block that isn't ready yet
+// plays silence and holds the play head instead of skipping audio
+static int seekable_callback(const void*, void* outputBuffer,
+                             unsigned long framesPerBuffer,
+                             const PaStreamCallbackTimeInfo*,
+                             PaStreamCallbackFlags,
+                             void* userData) {
+    AudioData* audio = (AudioData*)userData;
+    SeekableStream& stream = *audio->stream;
+    float* out = (float*)outputBuffer;
+    
+    int64_t target = seek_request.exchange(-1);
+    if (target >= 0) current_sample = target;
+    
+    int64_t position = current_sample;
+    unsigned long done = 0;
+    
+    while (done < framesPerBuffer && position < audio->total_samples && !should_stop) {
+        int64_t block = position / stream.block_frames;
+        BlockSlot& slot = stream.slots[block % SeekableStream::SLOTS];
+        
+        if (!slot.mutex.try_lock()) break;
+        if (slot.block != block) {
+            slot.mutex.unlock();
+            break;
+        }
+        
+        int64_t offset = position - block * stream.block_frames;
+        int64_t frames_in_block = std::min(stream.block_frames, audio->total_samples - block * stream.block_frames);
+        int64_t count = std::min<int64_t>(framesPerBuffer - done, frames_in_block - offset);
+        expand_block_frames(slot.bytes.data(), stream.sample_format, stream.planar, planar_stride(frames_in_block),
+                            audio->channels, offset, count, out + done * audio->channels);
+        slot.mutex.unlock();
+        
+        done += count;
+        position += count;
+    }
+    
+    if (done < framesPerBuffer) {
+        std::memset(out + done * audio->channels, 0, (framesPerBuffer - done) * audio->channels * sizeof(float));
+        if (position < audio->total_samples && !should_stop) underrun_buffers++;
+    }
+    
+    current_sample = position;
+    return position >= audio->total_samples ? paComplete : paContinue;
+}
+
+// 🧭 BLOCK DECODER THREAD - keeps the play head's block and the next few decompressed
+void run_block_decoder(AudioData& audio) {
+    SeekableStream& stream = *audio.stream;
+    ZSTD_DCtx* dctx = ZSTD_createDCtx();
+    std::vector<char> scratch;
+    scratch.reserve(planar_stride(stream.block_frames) * audio.channels * sample_bytes(stream.sample_format));
+    
+    while (stream.running) {
+        int64_t head = current_sample / stream.block_frames;
+        int64_t pending = seek_request;
+        if (pending >= 0) head = pending / stream.block_frames; // Get a head start on a seek
+        
+        bool decoded_any = false;
+        for (int64_t block = head; block < std::min(stream.block_count(), head + SeekableStream::SLOTS); block++) {
+            BlockSlot& slot = stream.slots[block % SeekableStream::SLOTS];
+            {
+                std::lock_guard<std::mutex> lock(slot.mutex);
+                if (slot.block == block) continue;
             }
-            if (current_sample >= audio->total_samples) {
-                return paComplete;
+            
+            if (!decode_block(stream, audio.mapping, dctx, block, scratch)) {
+                std::cerr << "\n❌ Block " << block << " is corrupt, stopping\n";
+                should_stop = true;
+                stream.running = false;
+                break;
             }
-        } else {
-            // Direct copy from interleaved buffer (MAXIMUM SPEED!!)
-            int64_t base_idx = current_sample * audio->channels;
-            for (int ch = 0; ch < audio->channels; ch++) {
-                *out++ = audio->interleaved_data[base_idx + ch];
+            
+            {
+                std::lock_guard<std::mutex> lock(slot.mutex);
+                slot.bytes.swap(scratch);
+                slot.block = block;
             }
-            current_sample++;
+            decoded_any = true;
+            
+            // A seek moved the play head - start over from there
+            if (current_sample / stream.block_frames != head || seek_request >= 0) break;
+        }
+        
+        if (!decoded_any) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
         }
     }
     
-    return paContinue;
+    ZSTD_freeDCtx(dctx);
+}
+
+bool block_ready(SeekableStream& stream, int64_t sample) {
+    int64_t block = sample / stream.block_frames;
+    BlockSlot& slot = stream.slots[block % SeekableStream::SLOTS];
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    return slot.block == block;
+}
+
+// ⏩ "+10" / "-10" skip seconds, "90" or "1:30" jumps there
+bool parse_seek_command(const std::string& text, const AudioData& audio, int64_t& target) {
+    double seconds;
+    bool relative = text[0] == '+' || text[0] == '-';
+    if (!parse_time_arg(relative ? text.substr(1) : text, seconds)) return false;
+    
+    double base = relative ? (double)current_sample / audio.sample_rate : 0.0;
+    double when = relative && text[0] == '-' ? base - seconds : base + seconds;
+    target = std::clamp<int64_t>((int64_t)(when * audio.sample_rate), 0, audio.total_samples);
+    return true;
 }
 
 // 🎮 PLAY AUDIO (THE MAIN EVENT!!)
-void play_audio(AudioData& audio) {
+void play_audio(AudioData& audio, const PlayerSettings& settings) {
     PaError err;
     PaStream* stream;
     
@@ -221,7 +2781,7 @@ void play_audio(AudioData& audio) {
                               paFloat32,           // 32-bit float
                               audio.sample_rate,   // sample rate
                               256,                 // frames per buffer
-                              audio_callback,      // callback
+                              audio.stream ? seekable_callback : audio_callback,
                               &audio);             // user data
     
     if (err != paNoError) {
@@ -235,15 +2795,36 @@ void play_audio(AudioData& audio) {
     std::cout << "⏱️  Duration: " << (float)audio.total_samples / audio.sample_rate << " seconds\n";
     std::cout << "🎧 Channels: " << audio.channels << (audio.channels == 2 ? " (Stereo)" : " (Mono)") << "\n";
     std::cout << "🎵 Sample rate: " << audio.sample_rate << " Hz\n";
-    std::cout << "\n💡 Press ENTER to stop playback...\n\n";
+    std::cout << "\n💡 ENTER = stop | 90 or 1:30 + ENTER = jump there | +10 / -10 + ENTER = skip seconds\n\n";
     
     // Start playback
-    current_sample = 0;
+    current_sample = std::clamp<int64_t>((int64_t)(settings.start_seconds * audio.sample_rate), 0, audio.total_samples);
+    seek_request = -1;
     should_stop = false;
     
+    // 🧭 Seekable: decode the block under the play head before the first callback wants it
+    std::thread block_decoder;
+    if (audio.stream) {
+        auto ready_start = std::chrono::steady_clock::now();
+        audio.stream->running = true;
+        block_decoder = std::thread(run_block_decoder, std::ref(audio));
+        
+        while (!block_ready(*audio.stream, current_sample) && !should_stop &&
+               std::chrono::steady_clock::now() - ready_start < std::chrono::seconds(2)) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        
+        auto ready_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - ready_start);
+        std::cout << "⚡ First block ready in " << ready_us.count() / 1000.0 << " ms\n";
+    }
+    
     err = Pa_StartStream(stream);
     if (err != paNoError) {
         std::cerr << "❌ Failed to start stream: " << Pa_GetErrorText(err) << "\n";
+        if (block_decoder.joinable()) {
+            audio.stream->running = false;
+            block_decoder.join();
+        }
         Pa_CloseStream(stream);
         Pa_Terminate();
         return;
@@ -266,9 +2847,68 @@ void play_audio(AudioData& audio) {
         }
     });
     
-    // Wait for stop
+    // 📡 Readahead thread: keep the next few seconds of a mapped file in the page cache so the
+    // callback never takes a major page fault on a cold file
+    std::thread prefetch_thread;
+    if (audio.mapping.base && audio.samples && settings.readahead_seconds > 0.0) {
+        prefetch_thread = std::thread([&audio, &settings]() {
+            const size_t page = sysconf(_SC_PAGESIZE);
+            const size_t frame_bytes = audio.channels * sample_bytes(audio.sample_format);
+            // Planar: the whole block under the play head is needed, so read ahead from its start
+            const size_t window = (size_t)(settings.readahead_seconds * audio.sample_rate) * frame_bytes +
+                                  (audio.planar ? audio.block_frames * frame_bytes : 0);
+            const size_t offset = reinterpret_cast<const char*>(audio.samples) - audio.mapping.base;
+            size_t advised_until = 0;
+            
+            while (is_playing && !should_stop && current_sample < audio.total_samples) {
+                int64_t head_frame = stored_frame(audio, current_sample);
+                if (audio.planar) head_frame = head_frame / audio.block_frames * audio.block_frames;
+                size_t play_head = offset + head_frame * frame_bytes;
+                size_t target = std::min(audio.mapping.length, play_head + window);
+                
+                // Top up once half the window has been played
+                if (target >= advised_until + window / 2 || advised_until == 0) {
+                    size_t from = std::max(advised_until, play_head) & ~(page - 1);
+                    if (target > from) {
+                        madvise(audio.mapping.base + from, target - from, MADV_WILLNEED);
+                    }
+                    advised_until = target;
+                }
+                
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+        });
+    }
+    
+    // 🔒 Verifier: checks the HMICAP's blocks at memory speed from the play head on while it plays,
+    // so the first sample never waits on it; a bad block is muted as soon as it's found
+    std::thread verifier;
+    if (audio.verify_while_playing) {
+        verifier = std::thread([&audio, &settings]() {
+            auto start = std::chrono::steady_clock::now();
+            int64_t bad = verify_blocks(audio, stored_frame(audio, current_sample) / audio.block_frames, settings.threads, &should_stop);
+            if (should_stop) return;
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << "\n";
+            print_verify_result(audio.checksums.size() - 1, bad,
+                                payload_samples(audio.stored_frames, audio.channels, audio.block_frames,
+                                                audio.planar ? HMICAP_FLAG_PLANAR : 0) *
+                                    sample_bytes(audio.sample_format),
+                                seconds);
+        });
+    }
+    
+    // Wait for stop, handling seeks on the way
     std::string input;
-    std::getline(std::cin, input);
+    while (std::getline(std::cin, input) && !input.empty()) {
+        int64_t target;
+        if (!parse_seek_command(input, audio, target)) {
+            std::cout << "\n⚠️  Didn't get that - try 90, 1:30, +10 or -10\n";
+            continue;
+        }
+        seek_request = target;
+        std::cout << "\n⏩ Jumping to " << (double)target / audio.sample_rate << "s\n";
+    }
     should_stop = true;
     
     // Stop stream
@@ -279,22 +2919,97 @@ void play_audio(AudioData& audio) {
     
     is_playing = false;
     progress_thread.join();
+    if (prefetch_thread.joinable()) {
+        prefetch_thread.join();
+    }
+    if (verifier.joinable()) {
+        verifier.join();
+    }
+    if (block_decoder.joinable()) {
+        audio.stream->running = false;
+        block_decoder.join();
+    }
     
     Pa_CloseStream(stream);
     Pa_Terminate();
     
     std::cout << "\n\n✅ Playback stopped! 🎵\n";
+    if (underrun_buffers > 0) {
+        std::cout << "⚠️  " << underrun_buffers << " buffers played silence waiting for a block\n";
+    }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    PlayerSettings settings;
+    std::string file_path;
+    
+    // 🎛️ COMMAND LINE
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        
+        if (arg == "--help" || arg == "-h") {
+            std::cout << "Usage: " << argv[0] << " [--start TIME] [--preload] [--threads N] [--bench-load] [--bench-io] [--overview] [--no-mmap] [--direct] [--no-verify] [--readahead SECONDS] [file.hmicap|file.hmicap7|pack.hmipack[:TRACK]]\n";
+            std::cout << "  pack.hmipack:TRACK plays one track of a pack (just the pack lists its tracks and asks)\n";
+            std::cout << "  --start TIME       Start playback at TIME (seconds or m:ss)\n";
+            std::cout << "  --preload          Seekable HMICAP7: decompress everything up front (in parallel)\n";
+            std::cout << "  --threads N        Decompression threads for --preload/--bench-load (default: all cores)\n";
+            std::cout << "  --bench-load       Time a full seekable HMICAP7 decode at 1..N threads and exit\n";
+            std::cout << "  --bench-io         Time loading the file via iostream vs async reads (cold and warm cache) and exit\n";
+            std::cout << "  --overview         Print the file's waveform and loudest stretch from its overview (no samples read) and exit\n";
+            std::cout << "  --no-mmap          Read HMICAP into memory instead of playing it from a file mapping\n";
+            std::cout << "  --direct           Like --no-mmap, but with O_DIRECT reads that bypass the page cache (HMICAP, single-frame HMICAP7)\n";
+            std::cout << "  --no-verify        Skip the per-block checksum checks\n";
+            std::cout << "  --readahead SEC    Prefetch window ahead of the play head for mapped files (default 5, 0 = off)\n";
+            return 0;
+        } else if (arg == "--start") {
+            if (i + 1 >= argc || !parse_time_arg(argv[++i], settings.start_seconds)) {
+                std::cerr << "❌ --start needs a time like 42, 42.5 or 1:30\n";
+                return 1;
+            }
+        } else if (arg == "--preload") {
+            settings.preload = true;
+        } else if (arg == "--bench-load") {
+            settings.bench = true;
+        } else if (arg == "--bench-io") {
+            settings.bench_io = true;
+        } else if (arg == "--threads") {
+            int count = i + 1 < argc ? std::atoi(argv[++i]) : 0;
+            if (count <= 0) {
+                std::cerr << "❌ --threads needs a positive number\n";
+                return 1;
+            }
+            settings.threads = count;
+        } else if (arg == "--overview") {
+            settings.overview = true;
+        } else if (arg == "--no-mmap") {
+            settings.use_mmap = false;
+        } else if (arg == "--direct") {
+            settings.direct = true;
+        } else if (arg == "--no-verify") {
+            settings.verify = false;
+        } else if (arg == "--readahead") {
+            if (i + 1 >= argc) {
+                std::cerr << "❌ --readahead needs a number of seconds\n";
+                return 1;
+            }
+            settings.readahead_seconds = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "❌ Unknown option: " << arg << "\n";
+            return 1;
+        } else {
+            file_path = arg;
+        }
+    }
+    
     std::cout << "🔥🔥🔥 HMICAP PLAYER - INSTANT LOADING SUPREMACY 🔥🔥🔥\n";
     std::cout << "💎 SUPPORTS: HMICAP (binary) & HMICAP7 (compressed) 💎\n";
     std::cout << "⚡ ZERO PARSING OVERHEAD = MAXIMUM SPEED = UNDEFEATED ⚡\n\n";
     
     // Get file path
-    std::string file_path;
-    std::cout << "Enter HMICAP/HMICAP7 file path: ";
-    std::getline(std::cin, file_path);
+    if (file_path.empty()) {
+        std::cout << "Enter HMICAP/HMICAP7 file path: ";
+        std::getline(std::cin, file_path);
+    }
     
     // Detect format
     std::string ext;
@@ -304,38 +3019,93 @@ int main() {
         std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
     }
     
+    // 📦 A packed track: one binary search in the mapped index, then the loaders read its bytes in place
+    MappedFile pack_file;
+    PackIndex pack;
+    const PackEntry* packed = nullptr;
+    std::string pack_path, track;
+    if (split_pack_path(file_path, pack_path, track) || ext == "hmipack") {
+        if (pack_path.empty()) pack_path = file_path;
+        if (!open_pack(pack_path, pack_file, pack)) {
+            return 1;
+        }
+        if (track.empty()) {
+            std::cout << "📦 " << pack_path << ": " << pack.header->tracks << " tracks\n";
+            print_pack_index(pack);
+            std::cout << "Enter track name: ";
+            std::getline(std::cin, track);
+        }
+        packed = pack.find(track);
+        if (!packed) {
+            std::cerr << "❌ No track \"" << track << "\" in " << pack_path << "\n";
+            return 1;
+        }
+        std::cout << "📦 Track \"" << track << "\": " << packed->length / 1024.0 / 1024.0 << " MB at offset "
+                  << packed->offset << " of " << pack_path << "\n";
+        file_path = pack_path;
+        ext = packed->format == PACK_TRACK_HMICAP7 ? "hmicap7" : "hmicap";
+    }
+    
     AudioData audio;
     bool loaded = false;
     
     auto start_time = std::chrono::high_resolution_clock::now();
     
     if (ext == "hmicap") {
-        loaded = load_hmicap(file_path, audio);
+        loaded = load_hmicap(file_path, audio, settings, packed);
     } else if (ext == "hmicap7") {
-        loaded = load_hmicap7(file_path, audio);
+        loaded = load_hmicap7(file_path, audio, settings, packed);
     } else {
-        std::cerr << "❌ Unknown format! Use .hmicap or .hmicap7\n";
+        std::cerr << "❌ Unknown format! Use .hmicap, .hmicap7 or .hmipack\n";
         return 1;
     }
     
-    auto end_time = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
-    
     if (!loaded) {
         std::cerr << "❌ Failed to load audio file\n";
         return 1;
     }
     
+    if (settings.overview) {
+        auto load_time = std::chrono::high_resolution_clock::now() - start_time;
+        std::cout << "  ⏱️  Header + overview loaded in "
+                  << std::chrono::duration<double, std::micro>(load_time).count() << " µs\n";
+        print_overview(audio, 72, 10.0);
+        return 0;
+    }
+    
+    if (settings.bench) {
+        if (!audio.stream) {
+            std::cerr << "❌ --bench-load needs a seekable HMICAP7 (single-frame files can't be split across threads)\n";
+            return 1;
+        }
+        bench_load(audio, settings.threads);
+        return 0;
+    }
+    
+    if (settings.bench_io) {
+        if (audio.stream) {
+            std::cerr << "❌ --bench-io times whole-file loads - seekable HMICAP7 plays from a mapping (try --bench-load)\n";
+            return 1;
+        }
+        return bench_io(file_path, ext == "hmicap7", packed) ? 0 : 1;
+    }
+    
+    if (settings.preload && audio.stream && !preload_seekable(audio, settings.threads)) {
+        std::cerr << "❌ Failed to preload audio file\n";
+        return 1;
+    }
+    
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
     std::cout << "\n⚡ Loading time: " << duration.count() << " ms (INSTANT fr fr) 💯\n";
     
-    // Validate audio
+    // Validate audio (seekable files have nothing decoded yet)
     std::cout << "\n🔍 Validating audio data...\n";
-    bool has_audio = false;
-    for (size_t i = 0; i < std::min((size_t)1000, audio.interleaved_data.size()); i++) {
-        if (audio.interleaved_data[i] != 0.0f) {
-            has_audio = true;
-            break;
-        }
+    bool has_audio = audio.stream != nullptr;
+    if (audio.samples) {
+        std::vector<float> head(std::min<int64_t>(1000, audio.total_samples) * audio.channels);
+        render_frames(audio, 0, head.size() / audio.channels, head.data());
+        has_audio = std::any_of(head.begin(), head.end(), [](float sample) { return sample != 0.0f; });
     }
     
     if (!has_audio) {
@@ -345,7 +3115,7 @@ int main() {
     }
     
     // Play the audio
-    play_audio(audio);
+    play_audio(audio, settings);
     
     std::cout << "\n💥 HMICAP PLAYER SESSION COMPLETE 💥\n";
     std::cout << "🚀 PRE-RENDERED FORMAT = INSTANT LOADING = BLESSED 🚀\n";